@@ -47,6 +47,30 @@ extern "C"
 
 /*-------------------------- CLOCK CONFIG END --------------------------*/
 
+/*-------------------------- GPIO CONFIG BEGIN --------------------------*/
+
+/** Pin interrupts are dispatched from a single read of the EXTI pending register.
+ *
+ * STEP 1, define macro BSP_PIN_USING_IRQ_STAT to count the interrupts of every EXTI line, the msh
+ *         command pin_irq_stat shows them and "pin_irq_stat clear" resets them
+ *
+ * STEP 2, open cputime support in the RT-Thread Settings file to also record, for every line, the
+ *         longest time from the entry of the EXTI interrupt to the return of the line's handler
+ */
+
+/*#define BSP_PIN_USING_IRQ_STAT*/
+
+/** The buttons of drv_button are polled, drv_button_process() must be called every 20-50ms.
+ *
+ * STEP 1, define macro BSP_BUTTON_USING_IRQ_SCAN to scan them from a debounce timer instead, the
+ *         falling edge interrupt of a button starts it and it stops when all of them are idle,
+ *         drv_button_process() then returns at once
+ */
+
+/*#define BSP_BUTTON_USING_IRQ_SCAN*/
+
+/*-------------------------- GPIO CONFIG END --------------------------*/
+
 /*-------------------------- UART CONFIG BEGIN --------------------------*/
 
 /** After configuring corresponding UART or UART DMA, you can use it.
@@ -185,11 +209,21 @@ extern "C"
  * STEP 4, modify your stm32xxxx_hal_config.h file to support adc peripherals. define macro related to the peripherals
  *                 such as     #define HAL_ADC_MODULE_ENABLED
  *
+ * STEP 5, if you want the scan mode with DMA, open it in the RT-Thread Settings and define the adc DMA macro.
+ *         TIM6 triggers the scan sequences.
+ *                 RT-Thread Setting -> Components -> Device Drivers -> Using ADC device drivers -> Enable ADC scan mode
+ *                 such as     #define BSP_ADC1_USING_DMA
+ *
+ * STEP 6, if you want the scan frames decimated by a FIR filter, define the macro
+ *                 such as     #define BSP_ADC_USING_DECIMATION
+ *
  */
 
 /*#define BSP_USING_ADC1*/
 /*#define BSP_USING_ADC2*/
 /*#define BSP_USING_ADC3*/
+/*#define BSP_ADC1_USING_DMA*/
+/*#define BSP_ADC_USING_DECIMATION*/
 
 /*-------------------------- ADC CONFIG END --------------------------*/
 
@@ -233,6 +267,24 @@ extern "C"
 
 /*-------------------------- HAREWARE TIMER CONFIG END --------------------------*/
 
+/*-------------------------- KTIME CONFIG BEGIN --------------------------*/
+
+/** After configuring the ktime timer, rt_ktime_hrtimer_*, nanosleep and clock_gettime run on a hardware timer
+ *
+ * STEP 1, open ktime support in the RT-Thread Settings file, and posix clock/delay for clock_gettime and nanosleep
+ *
+ * STEP 2, define macro BSP_USING_KTIME_TIM2. TIM2 is the 32 bits timer of this chip and is then used by ktime
+ *         alone, do not define BSP_USING_TIM2 or BSP_USING_PWM2 with it
+ *
+ * STEP 3, define macro BSP_KTIME_TIMER_FREQ, the counting frequency in Hz. The timer clock must be a multiple of it,
+ *         msh command ktime_bench shows the timer jitter
+ */
+
+/*#define BSP_USING_KTIME_TIM2*/
+#define BSP_KTIME_TIMER_FREQ    1000000
+
+/*-------------------------- KTIME CONFIG END --------------------------*/
+
 /*-------------------------- RTC CONFIG BEGIN --------------------------*/
 
 /** if you want to use rtc(hardware) you can use the following instructions.
@@ -16,11 +16,34 @@
 
 #if defined(BSP_USING_ADC1) || defined(BSP_USING_ADC2) || defined(BSP_USING_ADC3)
 #include "drv_config.h"
+#ifdef RT_ADC_USING_SCAN
+#include "drv_dma.h"
+#endif
+#include "drv_adc.h"
+
+#if defined(BSP_ADC_USING_DECIMATION) && !defined(RT_ADC_USING_SCAN)
+#error "the ADC decimation runs on the scan mode, please enable RT_ADC_USING_SCAN"
+#endif
 
 //#define DRV_DEBUG
 #define LOG_TAG             "drv.adc"
 #include <drv_log.h>
 
+enum
+{
+#ifdef BSP_USING_ADC1
+    ADC1_INDEX,
+#endif
+
+#ifdef BSP_USING_ADC2
+    ADC2_INDEX,
+#endif
+
+#ifdef BSP_USING_ADC3
+    ADC3_INDEX,
+#endif
+};
+
 static ADC_HandleTypeDef adc_config[] =
 {
 #ifdef BSP_USING_ADC1
@@ -36,14 +59,64 @@ static ADC_HandleTypeDef adc_config[] =
 #endif
 };
 
+/* the channels which have an oversampling setting */
+#define ADC_CHANNEL_NUM             20
+
+#define ADC_OVERSAMPLING_MASK       (ADC_CFGR2_ROVSE | ADC_CFGR2_OVSR | ADC_CFGR2_OVSS | ADC_CFGR2_TROVS | ADC_CFGR2_ROVSM)
+
+#ifdef BSP_ADC_USING_DECIMATION
+struct stm32_adc_decimator
+{
+    rt_uint16_t length;                         /* sequences of an input frame */
+    rt_uint8_t factor;
+    rt_uint8_t channel_count;
+    rt_uint16_t num_taps;
+    const float *coeffs;                        /* in time reversed order */
+    float *state[RT_ADC_SCAN_CHANNEL_MAX];      /* the last num_taps - 1 inputs of a channel, then its frame */
+    float *output;                              /* the output frame, interleaved */
+    rt_hw_adc_decimated_cb_t callback;
+    void *user_data;
+};
+#endif /* BSP_ADC_USING_DECIMATION */
+
 struct stm32_adc
 {
     ADC_HandleTypeDef ADC_Handler;
     struct rt_adc_device stm32_adc_device;
+    /* the oversampling bits of CFGR2 for each channel */
+    rt_uint32_t oversampling[ADC_CHANNEL_NUM];
+#ifdef RT_ADC_USING_SCAN
+    struct dma_config *dma_cfg;
+    DMA_HandleTypeDef dma;
+    /* the single conversion setting, restored when the scan stops */
+    ADC_InitTypeDef single_init;
+#endif
+#ifdef BSP_ADC_USING_DECIMATION
+    /* the decimator of the last decimated scan, released by the decimation API */
+    struct stm32_adc_decimator *decimator;
+#endif
 };
 
 static struct stm32_adc stm32_adc_obj[sizeof(adc_config) / sizeof(adc_config[0])];
 
+#ifdef RT_ADC_USING_SCAN
+/* the timer triggering the scan sequences by its update event */
+#ifndef ADC_SCAN_TIM
+#define ADC_SCAN_TIM                TIM6
+#define ADC_SCAN_TIM_CLK_ENABLE()   __HAL_RCC_TIM6_CLK_ENABLE()
+#define ADC_SCAN_TRIGGER            ADC_EXTERNALTRIG_T6_TRGO
+#if defined(BSP_USING_TIM) && defined(BSP_USING_TIM6)
+#error "TIM6 triggers the ADC scan, it can not be a hwtimer"
+#endif
+#endif /* ADC_SCAN_TIM */
+
+#ifndef ADC_SCAN_SAMPLETIME
+#define ADC_SCAN_SAMPLETIME         ADC_SAMPLETIME_47CYCLES_5
+#endif
+
+static TIM_HandleTypeDef adc_scan_tim = {.Instance = ADC_SCAN_TIM};
+#endif /* RT_ADC_USING_SCAN */
+
 static rt_err_t stm32_adc_enabled(struct rt_adc_device *device, rt_uint32_t channel, rt_bool_t enabled)
 {
     ADC_HandleTypeDef *stm32_adc_handler;
@@ -157,6 +230,13 @@ static rt_err_t stm32_get_adc_value(struct rt_adc_device *device, rt_uint32_t ch
 
     stm32_adc_handler = device->parent.user_data;
 
+#ifdef RT_ADC_USING_SCAN
+    if (device->scan.running)
+    {
+        return -RT_EBUSY;
+    }
+#endif
+
     rt_memset(&ADC_ChanConf, 0, sizeof(ADC_ChanConf));
 
 #ifndef ADC_CHANNEL_16
@@ -211,6 +291,9 @@ static rt_err_t stm32_get_adc_value(struct rt_adc_device *device, rt_uint32_t ch
 #endif
     HAL_ADC_ConfigChannel(stm32_adc_handler, &ADC_ChanConf);
 
+    MODIFY_REG(stm32_adc_handler->Instance->CFGR2, ADC_OVERSAMPLING_MASK,
+               rt_container_of(device, struct stm32_adc, stm32_adc_device)->oversampling[channel]);
+
     /* start ADC */
     HAL_ADC_Start(stm32_adc_handler);
 
@@ -223,10 +306,430 @@ static rt_err_t stm32_get_adc_value(struct rt_adc_device *device, rt_uint32_t ch
     return RT_EOK;
 }
 
+/* the CFGR2 bits of an oversampling, all the conversions of a ratio are done on one trigger */
+static rt_err_t stm32_adc_oversampling_bits(rt_uint16_t ratio, rt_uint8_t shift, rt_uint32_t *bits)
+{
+    rt_uint32_t order = 0;
+
+    if (ratio <= 1)
+    {
+        *bits = 0;
+        return (shift == 0) ? RT_EOK : -RT_EINVAL;
+    }
+
+    while ((1U << order) < ratio)
+    {
+        order++;
+    }
+
+    /* the ratio is 2 to 256, and the sum of the 12 bits samples shifted must fit 16 bits */
+    if ((1U << order) != ratio || order > 8 || shift > 8 || order > shift + 4)
+    {
+        return -RT_EINVAL;
+    }
+
+    *bits = ADC_CFGR2_ROVSE | ((order - 1) << ADC_CFGR2_OVSR_Pos) | ((rt_uint32_t)shift << ADC_CFGR2_OVSS_Pos);
+
+    return RT_EOK;
+}
+
+static rt_err_t stm32_adc_control(struct rt_adc_device *device, int cmd, void *args)
+{
+    struct stm32_adc *adc = rt_container_of(device, struct stm32_adc, stm32_adc_device);
+    struct rt_adc_oversampling *ovs;
+    rt_uint32_t bits;
+
+    switch (cmd)
+    {
+    case RT_ADC_CMD_SET_OVERSAMPLING:
+        ovs = (struct rt_adc_oversampling *)args;
+        if (ovs->channel < 0 || ovs->channel >= ADC_CHANNEL_NUM ||
+            stm32_adc_oversampling_bits(ovs->ratio, ovs->shift, &bits) != RT_EOK)
+        {
+            return -RT_EINVAL;
+        }
+        /* it applies to the next conversion or scan of the channel */
+        adc->oversampling[ovs->channel] = bits;
+        return RT_EOK;
+
+    default:
+        return -RT_EINVAL;
+    }
+}
+
+#ifdef RT_ADC_USING_SCAN
+static const rt_uint32_t adc_scan_rank[] =
+{
+    ADC_REGULAR_RANK_1,  ADC_REGULAR_RANK_2,  ADC_REGULAR_RANK_3,  ADC_REGULAR_RANK_4,
+    ADC_REGULAR_RANK_5,  ADC_REGULAR_RANK_6,  ADC_REGULAR_RANK_7,  ADC_REGULAR_RANK_8,
+    ADC_REGULAR_RANK_9,  ADC_REGULAR_RANK_10, ADC_REGULAR_RANK_11, ADC_REGULAR_RANK_12,
+    ADC_REGULAR_RANK_13, ADC_REGULAR_RANK_14, ADC_REGULAR_RANK_15, ADC_REGULAR_RANK_16,
+};
+
+static rt_err_t stm32_adc_scan_start(struct rt_adc_device *device, const struct rt_adc_scan_config *cfg, rt_uint16_t *buffer)
+{
+    struct stm32_adc *adc = rt_container_of(device, struct stm32_adc, stm32_adc_device);
+    ADC_HandleTypeDef *hadc = &adc->ADC_Handler;
+    ADC_ChannelConfTypeDef chan_conf;
+    TIM_MasterConfigTypeDef master_conf;
+    rt_uint32_t size, clock, ticks, prescaler;
+    rt_uint32_t tmpreg = 0x00U;
+    int i;
+
+    if (adc->dma_cfg == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+
+    /* the DMA counts the two frames on 16 bits */
+    size = (rt_uint32_t)cfg->length * cfg->channel_count * 2;
+    if (size > 0xFFFF || cfg->channel_count > sizeof(adc_scan_rank) / sizeof(adc_scan_rank[0]))
+    {
+        return -RT_EINVAL;
+    }
+
+    clock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        clock *= 2;
+    }
+    ticks = clock / cfg->frequency;
+    if (ticks < 2)
+    {
+        return -RT_EINVAL;
+    }
+    prescaler = ticks / 0x10000 + 1;
+
+    /* the sequence is converted on the timer trigger, each sample is a DMA request */
+    adc->single_init = hadc->Init;
+    ADC_Disable(hadc);
+    hadc->Init.ScanConvMode          = ADC_SCAN_ENABLE;
+    hadc->Init.NbrOfConversion       = cfg->channel_count;
+    hadc->Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+    hadc->Init.ContinuousConvMode    = DISABLE;
+    hadc->Init.DiscontinuousConvMode = DISABLE;
+    hadc->Init.ExternalTrigConv      = ADC_SCAN_TRIGGER;
+    hadc->Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    hadc->Init.DMAContinuousRequests = ENABLE;
+    if (HAL_ADC_Init(hadc) != HAL_OK)
+    {
+        goto __error;
+    }
+
+    rt_memset(&chan_conf, 0, sizeof(chan_conf));
+    chan_conf.SamplingTime = ADC_SCAN_SAMPLETIME;
+    chan_conf.SingleDiff = LL_ADC_SINGLE_ENDED;
+    chan_conf.OffsetNumber = ADC_OFFSET_NONE;
+    for (i = 0; i < cfg->channel_count; i++)
+    {
+        if (cfg->channel[i] < 0 || cfg->channel[i] >= ADC_CHANNEL_NUM || stm32_adc_get_channel(cfg->channel[i]) == 0)
+        {
+            LOG_E("ADC channel %d can not be scanned.", cfg->channel[i]);
+            goto __error;
+        }
+        /* the oversampling is shared by all the channels of the ADC */
+        if (adc->oversampling[cfg->channel[i]] != adc->oversampling[cfg->channel[0]])
+        {
+            LOG_E("ADC channel %d oversampling differs from channel %d.", cfg->channel[i], cfg->channel[0]);
+            goto __error;
+        }
+        chan_conf.Channel = stm32_adc_get_channel(cfg->channel[i]);
+        chan_conf.Rank = adc_scan_rank[i];
+        if (HAL_ADC_ConfigChannel(hadc, &chan_conf) != HAL_OK)
+        {
+            goto __error;
+        }
+    }
+    MODIFY_REG(hadc->Instance->CFGR2, ADC_OVERSAMPLING_MASK, adc->oversampling[cfg->channel[0]]);
+
+    /* circular DMA over the two frames */
+    SET_BIT(RCC->AHB1ENR, adc->dma_cfg->dma_rcc);
+    tmpreg = READ_BIT(RCC->AHB1ENR, adc->dma_cfg->dma_rcc);
+    UNUSED(tmpreg);
+
+    adc->dma.Instance                 = adc->dma_cfg->Instance;
+    adc->dma.Init.Request             = adc->dma_cfg->request;
+    adc->dma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    adc->dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    adc->dma.Init.MemInc              = DMA_MINC_ENABLE;
+    adc->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    adc->dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    adc->dma.Init.Mode                = DMA_CIRCULAR;
+    adc->dma.Init.Priority            = DMA_PRIORITY_HIGH;
+    HAL_DMA_DeInit(&adc->dma);
+    if (HAL_DMA_Init(&adc->dma) != HAL_OK)
+    {
+        goto __error;
+    }
+    __HAL_LINKDMA(hadc, DMA_Handle, adc->dma);
+
+    HAL_NVIC_SetPriority(adc->dma_cfg->dma_irq, 0, 0);
+    HAL_NVIC_EnableIRQ(adc->dma_cfg->dma_irq);
+
+    if (HAL_ADC_Start_DMA(hadc, (uint32_t *)buffer, size) != HAL_OK)
+    {
+        goto __error;
+    }
+
+    /* the timer update event starts each sequence */
+    ADC_SCAN_TIM_CLK_ENABLE();
+    adc_scan_tim.Init.Prescaler         = prescaler - 1;
+    adc_scan_tim.Init.Period            = ticks / prescaler - 1;
+    adc_scan_tim.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    adc_scan_tim.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    adc_scan_tim.Init.RepetitionCounter = 0;
+    adc_scan_tim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    master_conf.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    master_conf.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIM_Base_Init(&adc_scan_tim) != HAL_OK ||
+        HAL_TIMEx_MasterConfigSynchronization(&adc_scan_tim, &master_conf) != HAL_OK ||
+        HAL_TIM_Base_Start(&adc_scan_tim) != HAL_OK)
+    {
+        HAL_ADC_Stop_DMA(hadc);
+        goto __error;
+    }
+
+    LOG_D("scan %d channels at %d Hz, %d sequences per frame", cfg->channel_count, cfg->frequency, cfg->length);
+    return RT_EOK;
+
+__error:
+    LOG_E("ADC scan start failed");
+    HAL_NVIC_DisableIRQ(adc->dma_cfg->dma_irq);
+    hadc->Init = adc->single_init;
+    HAL_ADC_Init(hadc);
+    return -RT_ERROR;
+}
+
+static rt_err_t stm32_adc_scan_stop(struct rt_adc_device *device)
+{
+    struct stm32_adc *adc = rt_container_of(device, struct stm32_adc, stm32_adc_device);
+    ADC_HandleTypeDef *hadc = &adc->ADC_Handler;
+
+    HAL_TIM_Base_Stop(&adc_scan_tim);
+    HAL_ADC_Stop_DMA(hadc);
+    HAL_NVIC_DisableIRQ(adc->dma_cfg->dma_irq);
+
+    /* back to the software started single conversions */
+    hadc->Init = adc->single_init;
+    if (HAL_ADC_Init(hadc) != HAL_OK)
+    {
+        return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    struct stm32_adc *adc = rt_container_of(hadc, struct stm32_adc, ADC_Handler);
+
+    rt_hw_adc_scan_isr(&adc->stm32_adc_device, 0);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    struct stm32_adc *adc = rt_container_of(hadc, struct stm32_adc, ADC_Handler);
+
+    rt_hw_adc_scan_isr(&adc->stm32_adc_device, 1);
+}
+
+#if defined(BSP_ADC1_USING_DMA)
+void ADC1_DMA_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+
+    HAL_DMA_IRQHandler(&stm32_adc_obj[ADC1_INDEX].dma);
+
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
+#endif
+
+#ifdef BSP_ADC_USING_DECIMATION
+static const struct rt_adc_ops stm_adc_ops;
+
+/*
+ * filter the frame channel by channel, in the DMA interrupt. Counting the inputs
+ * of a channel from the start of the scan, the output n is
+ * sum(coeffs[k] * x[n * factor - (num_taps - 1) + k]) for k in [0, num_taps),
+ * the inputs before the start are zero.
+ */
+static void stm32_adc_decimate(struct rt_adc_device *device, const struct rt_adc_frame *frame, void *user_data)
+{
+    struct stm32_adc_decimator *decimator = (struct stm32_adc_decimator *)user_data;
+    struct rt_hw_adc_decimated_frame decimated;
+    rt_uint16_t out_length = decimator->length / decimator->factor;
+    const float *window;
+    float *state, sum;
+    int c, i, k;
+
+    for (c = 0; c < decimator->channel_count; c++)
+    {
+        state = decimator->state[c];
+        for (i = 0; i < decimator->length; i++)
+        {
+            state[decimator->num_taps - 1 + i] = (float)frame->samples[i * decimator->channel_count + c];
+        }
+        for (i = 0; i < out_length; i++)
+        {
+            window = state + i * decimator->factor;
+            sum = 0.0f;
+            for (k = 0; k < decimator->num_taps; k++)
+            {
+                sum += decimator->coeffs[k] * window[k];
+            }
+            decimator->output[i * decimator->channel_count + c] = sum;
+        }
+        /* keep the history for the next frame, the copy goes forward */
+        for (k = 0; k < decimator->num_taps - 1; k++)
+        {
+            state[k] = state[decimator->length + k];
+        }
+    }
+
+    decimated.samples = decimator->output;
+    decimated.length = out_length;
+    decimated.channel_count = decimator->channel_count;
+    decimated.sequence = frame->sequence;
+    decimated.timestamp = frame->timestamp;
+    decimator->callback(device, &decimated, decimator->user_data);
+}
+
+/**
+ * Start a scan whose frames are low pass filtered and decimated per channel
+ * by a FIR decimator, in the DMA interrupt. The scan is stopped by
+ * rt_hw_adc_decimate_stop(), which releases the decimator. After a stop by
+ * rt_adc_scan_stop() it is released by the next call of either function.
+ *
+ * @param dev the ADC device
+ * @param cfg the scan configuration, cfg->length must be a multiple of the factor
+ * @param dcfg the decimation, its coefficients are used until the scan stops
+ * @param callback receives each decimated frame in the interrupt context, the
+ *        samples are valid until it returns
+ * @param user_data the parameter of the callback
+ *
+ * @return RT_EOK on success, -RT_EINVAL, -RT_ENOMEM or the error of rt_adc_scan_start().
+ */
+rt_err_t rt_hw_adc_decimate_start(rt_adc_device_t dev, const struct rt_adc_scan_config *cfg,
+                                  const struct rt_hw_adc_decimate_config *dcfg,
+                                  rt_hw_adc_decimated_cb_t callback, void *user_data)
+{
+    struct stm32_adc *adc;
+    struct stm32_adc_decimator *decimator;
+    float *state;
+    rt_size_t state_size;
+    rt_err_t result;
+    int c;
+
+    RT_ASSERT(dev != RT_NULL);
+    RT_ASSERT(cfg != RT_NULL);
+    RT_ASSERT(dcfg != RT_NULL);
+    RT_ASSERT(callback != RT_NULL);
+
+    if (dev->ops != &stm_adc_ops)
+    {
+        return -RT_ENOSYS;
+    }
+
+    if (cfg->channel_count == 0 || cfg->channel_count > RT_ADC_SCAN_CHANNEL_MAX ||
+        dcfg->factor == 0 || dcfg->num_taps == 0 || dcfg->coeffs == RT_NULL ||
+        cfg->length % dcfg->factor != 0)
+    {
+        return -RT_EINVAL;
+    }
+
+    /* the decimator, then the output frame and the filter states of the channels */
+    state_size = dcfg->num_taps + cfg->length - 1;
+    decimator = (struct stm32_adc_decimator *)rt_calloc(1, sizeof(struct stm32_adc_decimator) +
+                (cfg->length / dcfg->factor * cfg->channel_count + state_size * cfg->channel_count) * sizeof(float));
+    if (decimator == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    decimator->length = cfg->length;
+    decimator->factor = dcfg->factor;
+    decimator->channel_count = cfg->channel_count;
+    decimator->num_taps = dcfg->num_taps;
+    decimator->coeffs = dcfg->coeffs;
+    decimator->output = (float *)(decimator + 1);
+    decimator->callback = callback;
+    decimator->user_data = user_data;
+
+    state = decimator->output + cfg->length / dcfg->factor * cfg->channel_count;
+    for (c = 0; c < cfg->channel_count; c++, state += state_size)
+    {
+        decimator->state[c] = state;
+    }
+
+    result = rt_adc_scan_start(dev, cfg, stm32_adc_decimate, decimator);
+    if (result != RT_EOK)
+    {
+        rt_free(decimator);
+        return result;
+    }
+
+    /* the scan started, so the one of the previous decimator is stopped */
+    adc = rt_container_of(dev, struct stm32_adc, stm32_adc_device);
+    rt_free(adc->decimator);
+    adc->decimator = decimator;
+
+    return RT_EOK;
+}
+
+/**
+ * Stop a decimated scan.
+ *
+ * @param dev the ADC device
+ *
+ * @return RT_EOK on success, or the error of rt_adc_scan_stop().
+ */
+rt_err_t rt_hw_adc_decimate_stop(rt_adc_device_t dev)
+{
+    struct stm32_adc *adc;
+    rt_err_t result;
+
+    RT_ASSERT(dev != RT_NULL);
+
+    if (dev->ops != &stm_adc_ops)
+    {
+        return -RT_ENOSYS;
+    }
+
+    result = rt_adc_scan_stop(dev);
+    if (result != RT_EOK)
+    {
+        return result;
+    }
+
+    /* the DMA interrupt is off, nothing runs the decimator any more */
+    adc = rt_container_of(dev, struct stm32_adc, stm32_adc_device);
+    rt_free(adc->decimator);
+    adc->decimator = RT_NULL;
+
+    return RT_EOK;
+}
+#endif /* BSP_ADC_USING_DECIMATION */
+
+static void stm32_adc_get_dma_config(void)
+{
+#ifdef BSP_ADC1_USING_DMA
+    static struct dma_config adc1_dma = ADC1_DMA_CONFIG;
+    stm32_adc_obj[ADC1_INDEX].dma_cfg = &adc1_dma;
+#endif
+}
+#endif /* RT_ADC_USING_SCAN */
+
 static const struct rt_adc_ops stm_adc_ops =
 {
     .enabled = stm32_adc_enabled,
     .convert = stm32_get_adc_value,
+    .control = stm32_adc_control,
+#ifdef RT_ADC_USING_SCAN
+    .scan_start = stm32_adc_scan_start,
+    .scan_stop = stm32_adc_scan_stop,
+#endif
 };
 
 static int stm32_adc_init(void)
@@ -236,6 +739,10 @@ static int stm32_adc_init(void)
     char name_buf[5] = {'a', 'd', 'c', '0', 0};
     int i = 0;
 
+#ifdef RT_ADC_USING_SCAN
+    stm32_adc_get_dma_config();
+#endif
+
     for (i = 0; i < sizeof(adc_config) / sizeof(adc_config[0]); i++)
     {
         /* ADC init */
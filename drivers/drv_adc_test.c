@@ -0,0 +1,277 @@
+/**
+ * @file drv_adc_test.c
+ * @brief ADC扫描模式测试文件
+ * @details 用模拟的ADC设备测试扫描模式的双缓冲交接，不需要外部信号
+ * @author RT-Thread Team
+ * @date 2026-10-16
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2026 RT-Thread Development Team
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>日期       <th>版本  <th>作者     <th>说明
+ * <tr><td>2026-10-16 <td>1.0.0 <td>RT-Thread Team <td>首次创建
+ * </table>
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_ADC) && defined(RT_ADC_USING_SCAN)
+
+/**
+ * @defgroup ADC_Test_Functions ADC测试函数
+ * @{
+ */
+
+#define FAKE_ADC_LENGTH     4   /* 每帧的序列数 */
+#define FAKE_ADC_CHANNELS   2   /* 每个序列的通道数 */
+#define FAKE_ADC_FRAME      (FAKE_ADC_LENGTH * FAKE_ADC_CHANNELS)
+
+static struct rt_adc_device fake_adc;
+static rt_uint16_t *fake_adc_buffer;   /* 框架交给驱动的双缓冲 */
+static rt_uint32_t fake_adc_cb_count;
+static rt_uint32_t fake_adc_cb_sequence;
+
+static rt_err_t fake_adc_convert(struct rt_adc_device *device, rt_int8_t channel, rt_uint32_t *value)
+{
+    *value = 0;
+    return RT_EOK;
+}
+
+static rt_err_t fake_adc_scan_start(struct rt_adc_device *device, const struct rt_adc_scan_config *cfg,
+                                    rt_uint16_t *buffer)
+{
+    fake_adc_buffer = buffer;
+    return RT_EOK;
+}
+
+static rt_err_t fake_adc_scan_stop(struct rt_adc_device *device)
+{
+    fake_adc_buffer = RT_NULL;
+    return RT_EOK;
+}
+
+static const struct rt_adc_ops fake_adc_ops =
+{
+    .convert = fake_adc_convert,
+    .scan_start = fake_adc_scan_start,
+    .scan_stop = fake_adc_scan_stop,
+};
+
+/**
+ * @brief 模拟DMA填满半个缓冲区并产生中断
+ * @param half 缓冲区的半区
+ * @param value 填入的采样值
+ */
+static void fake_adc_fill(int half, rt_uint16_t value)
+{
+    for (int i = 0; i < FAKE_ADC_FRAME; i++)
+    {
+        fake_adc_buffer[half * FAKE_ADC_FRAME + i] = value;
+    }
+    rt_hw_adc_scan_isr(&fake_adc, half);
+}
+
+/**
+ * @brief 读取一帧并检查帧号和采样值
+ * @param sequence 期望的帧号
+ * @param value 期望的采样值
+ * @return rt_err_t 检查结果
+ */
+static rt_err_t fake_adc_expect(rt_uint32_t sequence, rt_uint16_t value)
+{
+    struct rt_adc_frame frame;
+    rt_uint16_t samples[FAKE_ADC_FRAME];
+    rt_err_t result;
+
+    result = rt_adc_scan_read(&fake_adc, &frame, samples, 0);
+    if (result != RT_EOK)
+    {
+        rt_kprintf("[TEST] Read frame %d failed: %d\n", sequence, result);
+        return -RT_ERROR;
+    }
+    if (frame.sequence != sequence || frame.samples != samples ||
+        frame.length != FAKE_ADC_LENGTH || frame.channel_count != FAKE_ADC_CHANNELS)
+    {
+        rt_kprintf("[TEST] Frame %d mismatch, got frame %d!\n", sequence, frame.sequence);
+        return -RT_ERROR;
+    }
+    for (int i = 0; i < FAKE_ADC_FRAME; i++)
+    {
+        if (samples[i] != value)
+        {
+            rt_kprintf("[TEST] Frame %d sample %d is 0x%04x, not 0x%04x!\n", sequence, i, samples[i], value);
+            return -RT_ERROR;
+        }
+    }
+
+    return RT_EOK;
+}
+
+static void fake_adc_callback(struct rt_adc_device *device, const struct rt_adc_frame *frame, void *user_data)
+{
+    fake_adc_cb_count++;
+    fake_adc_cb_sequence = frame->sequence;
+}
+
+static void fake_adc_reader(void *parameter)
+{
+    struct rt_adc_frame frame;
+    rt_uint16_t samples[FAKE_ADC_FRAME];
+
+    *(rt_err_t *)parameter = rt_adc_scan_read(&fake_adc, &frame, samples, RT_WAITING_FOREVER);
+}
+
+/**
+ * @brief 扫描模式双缓冲交接测试
+ * @return rt_err_t 测试结果
+ * @retval RT_EOK 测试通过
+ * @retval -RT_ERROR 测试失败
+ * @note 覆盖按时读取、读取过晚、丢失半区中断、超时、停止时阻塞的读者和回调模式
+ */
+static rt_err_t adc_scan_handoff_test(void)
+{
+    struct rt_adc_scan_config cfg = {{0, 1}, FAKE_ADC_CHANNELS, 1000, FAKE_ADC_LENGTH};
+    struct rt_adc_frame frame;
+    rt_uint16_t samples[FAKE_ADC_FRAME];
+    volatile rt_err_t reader_result = RT_EOK;
+    rt_thread_t reader;
+
+    rt_kprintf("[TEST] Starting ADC scan hand-off test...\n");
+
+    if (rt_adc_scan_start(&fake_adc, &cfg, RT_NULL, RT_NULL) != RT_EOK || fake_adc_buffer == RT_NULL)
+    {
+        rt_kprintf("[TEST] Scan start failed!\n");
+        return -RT_ERROR;
+    }
+    if (rt_adc_scan_start(&fake_adc, &cfg, RT_NULL, RT_NULL) != -RT_EBUSY)
+    {
+        rt_kprintf("[TEST] Second scan start is not busy!\n");
+        goto _fail;
+    }
+
+    /* 按时读取 */
+    fake_adc_fill(0, 0x100);
+    if (fake_adc_expect(0, 0x100) != RT_EOK)
+        goto _fail;
+
+    /* 没有新帧时超时 */
+    if (rt_adc_scan_read(&fake_adc, &frame, samples, 10) != -RT_ETIMEOUT)
+    {
+        rt_kprintf("[TEST] Read without a frame does not time out!\n");
+        goto _fail;
+    }
+
+    /* 读取过晚：只有最后一个完整帧有效，之前的帧计入丢失 */
+    fake_adc_fill(1, 0x101);
+    fake_adc_fill(0, 0x102);
+    if (fake_adc_expect(2, 0x102) != RT_EOK || fake_adc.scan.lost != 1)
+    {
+        rt_kprintf("[TEST] Late read lost %d frames, not 1!\n", fake_adc.scan.lost);
+        goto _fail;
+    }
+
+    /* 丢失一次半区中断，跳过的帧也计入丢失 */
+    fake_adc_fill(0, 0x104);
+    if (fake_adc_expect(4, 0x104) != RT_EOK || fake_adc.scan.lost != 2)
+    {
+        rt_kprintf("[TEST] Missed half lost %d frames, not 2!\n", fake_adc.scan.lost);
+        goto _fail;
+    }
+
+    /* 停止扫描时阻塞的读者返回-RT_EIO */
+    reader = rt_thread_create("adc_rd", fake_adc_reader, (void *)&reader_result, 1024,
+                              RT_THREAD_PRIORITY_MAX / 2, 10);
+    if (reader == RT_NULL)
+        goto _fail;
+    reader_result = RT_EOK;
+    rt_thread_startup(reader);
+    rt_thread_mdelay(20);
+    rt_adc_scan_stop(&fake_adc);
+    rt_thread_mdelay(20);
+    if (reader_result != -RT_EIO || fake_adc_buffer != RT_NULL)
+    {
+        rt_kprintf("[TEST] Blocked reader got %d after stop, not -RT_EIO!\n", reader_result);
+        return -RT_ERROR;
+    }
+    if (rt_adc_scan_read(&fake_adc, &frame, samples, 0) != -RT_EIO)
+    {
+        rt_kprintf("[TEST] Read after stop does not fail!\n");
+        return -RT_ERROR;
+    }
+
+    /* 回调模式 */
+    fake_adc_cb_count = 0;
+    if (rt_adc_scan_start(&fake_adc, &cfg, fake_adc_callback, RT_NULL) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Scan start with callback failed!\n");
+        return -RT_ERROR;
+    }
+    fake_adc_fill(0, 0x200);
+    fake_adc_fill(1, 0x201);
+    if (fake_adc_cb_count != 2 || fake_adc_cb_sequence != 1)
+    {
+        rt_kprintf("[TEST] Callback got %d frames, last %d!\n", fake_adc_cb_count, fake_adc_cb_sequence);
+        goto _fail;
+    }
+    rt_adc_scan_stop(&fake_adc);
+
+    rt_kprintf("[TEST] ADC scan hand-off test: PASS\n");
+
+    return RT_EOK;
+
+_fail:
+    rt_adc_scan_stop(&fake_adc);
+    return -RT_ERROR;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup ADC_MSH_Commands ADC MSH命令接口
+ * @{
+ */
+
+/**
+ * @brief ADC测试MSH命令
+ * @note 该函数提供ADC扫描模式测试的MSH命令接口
+ */
+static void adc_scan_test(void)
+{
+    rt_err_t result;
+
+    rt_kprintf("\n=== ADC Scan Test ===\n");
+
+    if (rt_hw_adc_register(&fake_adc, "fadc", &fake_adc_ops, RT_NULL) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Register fake ADC failed!\n");
+        return;
+    }
+
+    result = adc_scan_handoff_test();
+
+    /* 测试结束后注销模拟设备 */
+    rt_device_unregister(&fake_adc.parent);
+    rt_mutex_detach(&fake_adc.scan.lock);
+
+    if (result == RT_EOK)
+    {
+        rt_kprintf("=== All ADC Scan Tests PASSED ===\n");
+    }
+    else
+    {
+        rt_kprintf("=== ADC Scan Test FAILED ===\n");
+    }
+}
+
+MSH_CMD_EXPORT(adc_scan_test, ADC scan mode hand-off test);
+
+/**
+ * @}
+ */
+
+#endif /* RT_USING_ADC && RT_ADC_USING_SCAN */
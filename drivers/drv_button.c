@@ -44,6 +44,16 @@
 /** @brief 按键触发电平定义 */
 #define KEY_TRIGGER_LEVEL   PIN_LOW /**< 按键按下时的电平状态 */
 
+/** @brief 支持的端口数，GPIOA~GPIOH */
+#define KEY_PORT_MAX        8
+
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
+/** @brief 每次Button_Process()之间的去抖采样次数 */
+#define BUTTON_SCAN_DIVIDER ((BUTTON_PROCESS_PERIOD_MS + BUTTON_SCAN_PERIOD_MS - 1) / BUTTON_SCAN_PERIOD_MS)
+/** @brief 全部按键释放后继续处理的周期数，需覆盖双击等待和button软件包自身的消抖 */
+#define BUTTON_IDLE_CYCLES  (BUTTON_DOUBLE_TIME + BUTTON_DEBOUNCE_TIME + 1)
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
+
 /**
  * @}
  */
@@ -53,13 +63,30 @@
  * @{
  */
 
-/** @brief 按键实体结构体定义 */
-static Button_t key1_btn;  /**< 按键1实体 */
-static Button_t key2_btn;  /**< 按键2实体 */
-static Button_t key3_btn;  /**< 按键3实体 */
-static Button_t key4_btn;  /**< 按键4实体 */
-static Button_t key5_btn;  /**< 按键5实体 */
-static Button_t key6_btn;  /**< 按键6实体 */
+/** @brief 按键引脚表，下标为button_key_t */
+static const rt_base_t key_pins[BUTTON_KEY_MAX] =
+{
+    KEY1_PIN, KEY2_PIN, KEY3_PIN, KEY4_PIN, KEY5_PIN, KEY6_PIN,
+};
+
+/** @brief 按键实体表，下标为button_key_t */
+static Button_t key_btns[BUTTON_KEY_MAX];
+
+/** @brief 按键所在端口的位图，采样时每个端口只读一次IDR */
+static rt_uint8_t key_port_mask;
+
+/** @brief 按键状态位图，第n位对应button_key_t n，置1表示按下 */
+static volatile rt_uint32_t key_pressed;
+
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
+/** @brief 两位垂直计数器，每个按键一位，连续4次采样与去抖后状态不同才翻转 */
+static rt_uint32_t key_cnt0, key_cnt1;
+
+static struct rt_timer key_timer;           /**< 去抖扫描定时器 */
+static volatile rt_bool_t key_scanning;     /**< 扫描定时器是否运行 */
+static rt_uint8_t key_scan_count;           /**< 距下次Button_Process()的采样次数 */
+static rt_uint8_t key_idle_cycles;          /**< 全部按键释放后经过的处理周期数 */
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
 
 /**
  * @}
@@ -71,76 +98,166 @@ static Button_t key6_btn;  /**< 按键6实体 */
  */
 
 /**
- * @brief 读取按键1的GPIO电平状态
- * @return rt_uint8_t 返回按键1的电平状态
- * @retval PIN_HIGH 高电平
- * @retval PIN_LOW  低电平
- * @note 该函数被按键驱动框架调用，用于获取按键的实时状态
+ * @brief 一次读取全部按键端口的输入寄存器
+ * @return rt_uint32_t 原始按键位图，置1表示该按键当前处于触发电平
+ * @note 每个端口只读一次，代替逐个按键调用rt_pin_read
  */
-static rt_uint8_t key1_read_level(void)
+static rt_uint32_t button_sample(void)
 {
-    return rt_pin_read(KEY1_PIN);
+    rt_uint32_t idr[KEY_PORT_MAX];
+    rt_uint32_t pressed = 0;
+    rt_uint8_t i;
+
+    for (i = 0; i < KEY_PORT_MAX; i++)
+    {
+        if (key_port_mask & (1U << i))
+        {
+            idr[i] = rt_pin_port_read(i);
+        }
+    }
+
+    for (i = 0; i < BUTTON_KEY_MAX; i++)
+    {
+        rt_uint32_t level = (idr[PIN_PORT(key_pins[i])] & PIN_MASK(key_pins[i])) ? PIN_HIGH : PIN_LOW;
+
+        if (level == KEY_TRIGGER_LEVEL)
+        {
+            pressed |= 1U << i;
+        }
+    }
+
+    return pressed;
 }
 
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
 /**
- * @brief 读取按键2的GPIO电平状态
- * @return rt_uint8_t 返回按键2的电平状态
- * @retval PIN_HIGH 高电平
- * @retval PIN_LOW  低电平
- * @note 该函数被按键驱动框架调用，用于获取按键的实时状态
+ * @brief 垂直计数器去抖
+ * @param sample 本次采样的原始按键位图
+ * @return rt_uint32_t 去抖后的按键位图
+ * @note 所有按键并行处理：某位与去抖状态不同则其计数器递增，相同则清零，
+ *       连续4次不同后该位翻转。计数器全零说明没有按键处于抖动中
  */
-static rt_uint8_t key2_read_level(void)
+static rt_uint32_t button_debounce(rt_uint32_t sample)
 {
-    return rt_pin_read(KEY2_PIN);
+    rt_uint32_t delta = sample ^ key_pressed;
+
+    key_cnt1 = (key_cnt1 ^ key_cnt0) & delta;
+    key_cnt0 = ~key_cnt0 & delta;
+
+    return key_pressed ^ (delta & ~(key_cnt0 | key_cnt1));
 }
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
 
 /**
- * @brief 读取按键3的GPIO电平状态
- * @return rt_uint8_t 返回按键3的电平状态
- * @retval PIN_HIGH 高电平
- * @retval PIN_LOW  低电平
- * @note 该函数被按键驱动框架调用，用于获取按键的实时状态
+ * @brief 读取按键电平
+ * @param key 按键序号
+ * @return rt_uint8_t 按键电平，由最近一次采样(中断模式下为去抖后)的状态得出
  */
-static rt_uint8_t key3_read_level(void)
+rt_inline rt_uint8_t button_read_level(button_key_t key)
 {
-    return rt_pin_read(KEY3_PIN);
+    return (key_pressed & (1U << key)) ? KEY_TRIGGER_LEVEL : !KEY_TRIGGER_LEVEL;
 }
 
 /**
- * @brief 读取按键4的GPIO电平状态
- * @return rt_uint8_t 返回按键4的电平状态
- * @retval PIN_HIGH 高电平
- * @retval PIN_LOW  低电平
- * @note 该函数被按键驱动框架调用，用于获取按键的实时状态
+ * @brief 生成供button软件包调用的按键电平读取函数
+ * @note button软件包的读取回调不带参数，因此每个按键需要一个函数
  */
-static rt_uint8_t key4_read_level(void)
+#define BUTTON_READ_LEVEL_FUNC(n)                           \
+static rt_uint8_t key##n##_read_level(void)                 \
+{                                                           \
+    return button_read_level(BUTTON_KEY##n);                \
+}
+
+BUTTON_READ_LEVEL_FUNC(1)
+BUTTON_READ_LEVEL_FUNC(2)
+BUTTON_READ_LEVEL_FUNC(3)
+BUTTON_READ_LEVEL_FUNC(4)
+BUTTON_READ_LEVEL_FUNC(5)
+BUTTON_READ_LEVEL_FUNC(6)
+
+/** @brief 按键电平读取函数表，下标为button_key_t */
+static rt_uint8_t (*const key_read_levels[BUTTON_KEY_MAX])(void) =
 {
-    return rt_pin_read(KEY4_PIN);
+    key1_read_level, key2_read_level, key3_read_level,
+    key4_read_level, key5_read_level, key6_read_level,
+};
+
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
+/**
+ * @brief 启动去抖扫描
+ * @note 可在中断中调用，扫描已在运行时直接返回
+ */
+static void button_scan_start(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (key_scanning)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+    key_scanning = RT_TRUE;
+    rt_hw_interrupt_enable(level);
+
+    key_scan_count = 0;
+    key_idle_cycles = 0;
+    rt_timer_start(&key_timer);
 }
 
 /**
- * @brief 读取按键5的GPIO电平状态
- * @return rt_uint8_t 返回按键5的电平状态
- * @retval PIN_HIGH 高电平
- * @retval PIN_LOW  低电平
- * @note 该函数被按键驱动框架调用，用于获取按键的实时状态
+ * @brief 按键外部中断回调
+ * @param args 未使用
+ * @note 按键按下的下降沿启动扫描。扫描期间中断保持使能，抖动产生的中断只检查一次标志，
+ *       不关闭中断是因为关闭时引脚会被复位为模拟模式而无法读取
  */
-static rt_uint8_t key5_read_level(void)
+static void button_irq_handler(void *args)
 {
-    return rt_pin_read(KEY5_PIN);
+    button_scan_start();
 }
 
 /**
- * @brief 读取按键6的GPIO电平状态
- * @return rt_uint8_t 返回按键6的电平状态
- * @retval PIN_HIGH 高电平
- * @retval PIN_LOW  低电平
- * @note 该函数被按键驱动框架调用，用于获取按键的实时状态
+ * @brief 去抖扫描定时器回调
+ * @param parameter 未使用
+ * @note 每BUTTON_SCAN_PERIOD_MS采样去抖一次，每BUTTON_PROCESS_PERIOD_MS调用一次Button_Process()。
+ *       全部按键释放并稳定BUTTON_IDLE_CYCLES个处理周期后停止定时器，等待下一次按键中断
  */
-static rt_uint8_t key6_read_level(void)
+static void button_scan_timeout(void *parameter)
 {
-    return rt_pin_read(KEY6_PIN);
+    rt_base_t level;
+
+    key_pressed = button_debounce(button_sample());
+
+    if (++key_scan_count < BUTTON_SCAN_DIVIDER)
+    {
+        return;
+    }
+    key_scan_count = 0;
+
+    Button_Process();
+
+    if (key_pressed != 0 || (key_cnt0 | key_cnt1) != 0)
+    {
+        key_idle_cycles = 0;
+        return;
+    }
+    if (++key_idle_cycles < BUTTON_IDLE_CYCLES)
+    {
+        return;
+    }
+
+    rt_timer_stop(&key_timer);
+    level = rt_hw_interrupt_disable();
+    key_scanning = RT_FALSE;
+    rt_hw_interrupt_enable(level);
+
+    /* 清除标志前按下的按键，其中断已被忽略，这里补查一次 */
+    if (button_sample() != 0)
+    {
+        button_scan_start();
+    }
 }
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
 
 /**
  * @brief 按键事件回调函数
@@ -194,48 +311,92 @@ static void button_callback(void *btn)
  * @return rt_err_t 初始化结果
  * @retval RT_EOK 初始化成功
  * @retval -RT_ERROR 初始化失败
- * @note 该函数配置所有按键的GPIO模式并创建按键实体
+ * @note 该函数配置所有按键的GPIO模式并创建按键实体。定义BSP_BUTTON_USING_IRQ_SCAN时
+ *       同时使能按键的下降沿中断，由中断启动去抖扫描
  */
 rt_err_t drv_button_init(void)
 {
+    static const char *const key_names[BUTTON_KEY_MAX] =
+    {
+        BUTTON_KEY1_NAME, BUTTON_KEY2_NAME, BUTTON_KEY3_NAME,
+        BUTTON_KEY4_NAME, BUTTON_KEY5_NAME, BUTTON_KEY6_NAME,
+    };
+    rt_uint8_t i;
+
     LOG_D("Button driver initializing...");
-    
-    /* 配置按键GPIO为输入上拉模式 */
-    rt_pin_mode(KEY1_PIN, PIN_MODE_INPUT_PULLUP);
-    rt_pin_mode(KEY2_PIN, PIN_MODE_INPUT_PULLUP);
-    rt_pin_mode(KEY3_PIN, PIN_MODE_INPUT_PULLUP);
-    rt_pin_mode(KEY4_PIN, PIN_MODE_INPUT_PULLUP);
-    rt_pin_mode(KEY5_PIN, PIN_MODE_INPUT_PULLUP);
-    rt_pin_mode(KEY6_PIN, PIN_MODE_INPUT_PULLUP);
-    
-    /* 创建按键实体 */
-    Button_Create("key1", &key1_btn, key1_read_level, KEY_TRIGGER_LEVEL);
-    Button_Create("key2", &key2_btn, key2_read_level, KEY_TRIGGER_LEVEL);
-    Button_Create("key3", &key3_btn, key3_read_level, KEY_TRIGGER_LEVEL);
-    Button_Create("key4", &key4_btn, key4_read_level, KEY_TRIGGER_LEVEL);
-    Button_Create("key5", &key5_btn, key5_read_level, KEY_TRIGGER_LEVEL);
-    Button_Create("key6", &key6_btn, key6_read_level, KEY_TRIGGER_LEVEL);
-    
-    /* 绑定按键事件回调函数 */
-    Button_Attach(&key1_btn, BUTTON_ALL_RIGGER, button_callback);
-    Button_Attach(&key2_btn, BUTTON_ALL_RIGGER, button_callback);
-    Button_Attach(&key3_btn, BUTTON_ALL_RIGGER, button_callback);
-    Button_Attach(&key4_btn, BUTTON_ALL_RIGGER, button_callback);
-    Button_Attach(&key5_btn, BUTTON_ALL_RIGGER, button_callback);
-    Button_Attach(&key6_btn, BUTTON_ALL_RIGGER, button_callback);
-    
+
+    key_port_mask = 0;
+    for (i = 0; i < BUTTON_KEY_MAX; i++)
+    {
+        /* 配置按键GPIO为输入上拉模式 */
+        rt_pin_mode(key_pins[i], PIN_MODE_INPUT_PULLUP);
+        key_port_mask |= 1U << PIN_PORT(key_pins[i]);
+    }
+    key_pressed = button_sample();
+
+    for (i = 0; i < BUTTON_KEY_MAX; i++)
+    {
+        /* 创建按键实体并绑定按键事件回调函数 */
+        Button_Create(key_names[i], &key_btns[i], key_read_levels[i], KEY_TRIGGER_LEVEL);
+        Button_Attach(&key_btns[i], BUTTON_ALL_RIGGER, button_callback);
+    }
+
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
+    key_cnt0 = 0;
+    key_cnt1 = 0;
+    key_scanning = RT_FALSE;
+    rt_timer_init(&key_timer, "btn", button_scan_timeout, RT_NULL,
+                  rt_tick_from_millisecond(BUTTON_SCAN_PERIOD_MS),
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_SOFT_TIMER);
+
+    for (i = 0; i < BUTTON_KEY_MAX; i++)
+    {
+        /* 下降沿中断的引脚配置同样为上拉输入 */
+        if (rt_pin_attach_irq(key_pins[i], PIN_IRQ_MODE_FALLING, button_irq_handler, RT_NULL) != RT_EOK ||
+            rt_pin_irq_enable(key_pins[i], PIN_IRQ_ENABLE) != RT_EOK)
+        {
+            LOG_E("Button [%s] irq attach failed", key_names[i]);
+            return -RT_ERROR;
+        }
+    }
+
+    /* 初始化时已按下的按键没有下降沿，直接开始扫描 */
+    if (key_pressed != 0)
+    {
+        key_pressed = 0;
+        button_scan_start();
+    }
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
+
     LOG_I("Button driver initialized successfully");
-    
+
     return RT_EOK;
 }
 
+/**
+ * @brief 根据按键序号获取按键实体指针
+ * @param key 按键序号
+ * @return Button_t* 按键实体指针
+ * @retval 非NULL 成功获取按键实体指针
+ * @retval NULL 按键序号无效
+ */
+Button_t* drv_button_get_handle_by_index(button_key_t key)
+{
+    if ((rt_uint32_t)key >= BUTTON_KEY_MAX)
+    {
+        return RT_NULL;
+    }
+
+    return &key_btns[key];
+}
+
 /**
  * @brief 获取指定按键的实体指针
  * @param key_name 按键名称字符串
  * @return Button_t* 按键实体指针
  * @retval 非NULL 成功获取按键实体指针
  * @retval NULL 未找到对应的按键实体
- * @note 该函数用于根据按键名称获取对应的按键实体指针
+ * @note 按键名称为"key1"~"key6"，直接由末位数字得到按键序号
  */
 Button_t* drv_button_get_handle(const char *key_name)
 {
@@ -244,32 +405,13 @@ Button_t* drv_button_get_handle(const char *key_name)
         return RT_NULL;
     }
 
-    if (rt_strcmp(key_name, "key1") == 0)
-    {
-        return &key1_btn;
-    }
-    else if (rt_strcmp(key_name, "key2") == 0)
-    {
-        return &key2_btn;
-    }
-    else if (rt_strcmp(key_name, "key3") == 0)
-    {
-        return &key3_btn;
-    }
-    else if (rt_strcmp(key_name, "key4") == 0)
+    if (rt_strncmp(key_name, "key", 3) != 0 ||
+        key_name[3] < '1' || key_name[3] >= '1' + BUTTON_KEY_MAX || key_name[4] != '\0')
     {
-        return &key4_btn;
-    }
-    else if (rt_strcmp(key_name, "key5") == 0)
-    {
-        return &key5_btn;
-    }
-    else if (rt_strcmp(key_name, "key6") == 0)
-    {
-        return &key6_btn;
+        return RT_NULL;
     }
 
-    return RT_NULL;
+    return drv_button_get_handle_by_index((button_key_t)(key_name[3] - '1'));
 }
 
 /**
@@ -280,15 +422,24 @@ Button_t* drv_button_get_handle(const char *key_name)
  */
 rt_err_t drv_button_deinit(void)
 {
+    rt_uint8_t i;
+
     LOG_D("Button driver deinitializing...");
 
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
+    for (i = 0; i < BUTTON_KEY_MAX; i++)
+    {
+        rt_pin_detach_irq(key_pins[i]);
+    }
+    rt_timer_detach(&key_timer);
+    key_scanning = RT_FALSE;
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
+
     /* 删除按键实体 */
-    Button_Delete(&key1_btn);
-    Button_Delete(&key2_btn);
-    Button_Delete(&key3_btn);
-    Button_Delete(&key4_btn);
-    Button_Delete(&key5_btn);
-    Button_Delete(&key6_btn);
+    for (i = 0; i < BUTTON_KEY_MAX; i++)
+    {
+        Button_Delete(&key_btns[i]);
+    }
 
     LOG_I("Button driver deinitialized successfully");
 
@@ -297,12 +448,16 @@ rt_err_t drv_button_deinit(void)
 
 /**
  * @brief 按键状态处理函数
- * @note 该函数需要在定时器或线程中周期性调用，建议调用周期为20-50ms
- * @warning 必须周期性调用此函数，否则按键事件无法正常检测
+ * @note 轮询模式下该函数需要在定时器或线程中周期性调用，建议调用周期为20-50ms。
+ *       定义BSP_BUTTON_USING_IRQ_SCAN时扫描由按键中断驱动，该函数直接返回
+ * @warning 轮询模式下必须周期性调用此函数，否则按键事件无法正常检测
  */
 void drv_button_process(void)
 {
+#ifndef BSP_BUTTON_USING_IRQ_SCAN
+    key_pressed = button_sample();
     Button_Process();
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
 }
 
 /**
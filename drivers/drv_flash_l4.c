@@ -86,7 +86,7 @@ static uint32_t GetBank(uint32_t Addr)
 
 /**
  * Read data from flash.
- * @note This operation's units is word.
+ * @note The flash is memory mapped, it is copied by words.
  *
  * @param addr flash address
  * @param buf buffer to store read data
@@ -96,25 +96,24 @@ static uint32_t GetBank(uint32_t Addr)
  */
 int stm32_flash_read(rt_uint32_t addr, rt_uint8_t *buf, size_t size)
 {
-    size_t i;
-
     if ((addr + size) > STM32_FLASH_END_ADDRESS)
     {
         LOG_E("read outrange flash size! addr is (0x%p)", (void*)(addr + size));
         return -RT_EINVAL;
     }
 
-    for (i = 0; i < size; i++, buf++, addr++)
-    {
-        *buf = *(rt_uint8_t *) addr;
-    }
+    rt_memcpy(buf, (const void *)addr, size);
 
     return size;
 }
 
 /**
  * Write data to flash.
- * @note This operation's units is word.
+ * @note The data is programmed by doublewords. The bytes sharing an unaligned
+ *       head or tail doubleword keep their value, such a doubleword must be erased.
+ * @note The fast row programming is not used, it needs the whole bank mass
+ *       erased. On the single bank parts, such as the L431 of this board, the
+ *       bank holds the running code, so that never holds at run time.
  * @note This operation must after erase. @see flash_erase.
  *
  * @param addr flash address
@@ -123,12 +122,12 @@ int stm32_flash_read(rt_uint32_t addr, rt_uint8_t *buf, size_t size)
  *
  * @return result
  */
-
 int stm32_flash_write(rt_uint32_t addr, const uint8_t *buf, size_t size)
 {
-    size_t i, j;
-    rt_err_t result = 0;
-    rt_uint64_t write_data = 0, temp_data = 0;
+    rt_err_t result = RT_EOK;
+    rt_uint32_t end = addr + size;
+    rt_uint32_t offset, len;
+    rt_uint64_t write_data;
 
     if ((addr + size) > STM32_FLASH_END_ADDRESS)
     {
@@ -136,63 +135,43 @@ int stm32_flash_write(rt_uint32_t addr, const uint8_t *buf, size_t size)
         return -RT_EINVAL;
     }
 
-    if(addr % 8 != 0)
+    if (size < 1)
     {
-        LOG_E("write addr must be 8-byte alignment");
-        return -RT_EINVAL;
+        return -RT_ERROR;
     }
 
     HAL_FLASH_Unlock();
 
     __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGSERR);
 
-    if (size < 1)
+    while (addr < end)
     {
-        return -RT_ERROR;
-    }
-
-    for (i = 0; i < size;)
-    {
-        if ((size - i) < 8)
-        {
-            for (j = 0; (size - i) > 0; i++, j++)
-            {
-                temp_data = *buf;
-                write_data = (write_data) | (temp_data << 8 * j);
-                buf ++;
-            }
-        }
-        else
+        /* merge the data into the doubleword */
+        offset = addr % 8;
+        len = 8 - offset;
+        if (len > end - addr)
         {
-            for (j = 0; j < 8; j++, i++)
-            {
-                temp_data = *buf;
-                write_data = (write_data) | (temp_data << 8 * j);
-                buf ++;
-            }
+            len = end - addr;
         }
+        rt_memcpy(&write_data, (const void *)(addr - offset), 8);
+        rt_memcpy((rt_uint8_t *)&write_data + offset, buf, len);
 
-        /* write data */
-        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr, write_data) == HAL_OK)
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, addr - offset, write_data) != HAL_OK)
         {
-            /* Check the written value */
-            if (*(uint64_t*)addr != write_data)
-            {
-                LOG_E("ERROR: write data != read data\n");
-                result = -RT_ERROR;
-                goto __exit;
-            }
+            result = -RT_ERROR;
+            goto __exit;
         }
-        else
+
+        /* Check the written value */
+        if (*(rt_uint64_t *)(addr - offset) != write_data)
         {
+            LOG_E("ERROR: write data != read data\n");
             result = -RT_ERROR;
             goto __exit;
         }
 
-        temp_data = 0;
-        write_data = 0;
-
-        addr += 8;
+        addr += len;
+        buf += len;
     }
 
 __exit:
@@ -0,0 +1,199 @@
+/**
+ * @file drv_flash_test.c
+ * @brief 片上Flash驱动测试文件
+ * @details 在一个空闲页上测试非对齐写入、读取和擦除
+ * @author RT-Thread Team
+ * @date 2026-10-16
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2026 RT-Thread Development Team
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>日期       <th>版本  <th>作者     <th>说明
+ * <tr><td>2026-10-16 <td>1.0.0 <td>RT-Thread Team <td>首次创建
+ * </table>
+ */
+
+#include <rtthread.h>
+#include <board.h>
+#include <stdlib.h>
+
+#ifdef BSP_USING_ON_CHIP_FLASH
+#include "drv_flash.h"
+
+/**
+ * @defgroup Flash_Test_Functions Flash测试函数
+ * @{
+ */
+
+/* 每组写入的偏移和长度，覆盖非对齐的头尾和跨多个双字的写入 */
+static const struct
+{
+    rt_uint16_t offset;
+    rt_uint16_t length;
+} flash_test_writes[] =
+{
+    {0, 8}, {17, 1}, {33, 3}, {50, 13}, {97, 100}, {256, 256}, {1029, 511},
+};
+
+static rt_uint8_t flash_test_buf[512];
+
+/**
+ * @brief 检查一段Flash是否为擦除状态
+ * @param addr 起始地址
+ * @param size 长度
+ * @return rt_bool_t 是否全部为0xFF
+ */
+static rt_bool_t flash_test_erased(rt_uint32_t addr, rt_size_t size)
+{
+    for (rt_size_t i = 0; i < size; i++)
+    {
+        if (((const rt_uint8_t *)addr)[i] != 0xFF)
+        {
+            rt_kprintf("[TEST] 0x%08x is 0x%02x, not erased!\n", addr + i, ((const rt_uint8_t *)addr)[i]);
+            return RT_FALSE;
+        }
+    }
+
+    return RT_TRUE;
+}
+
+/**
+ * @brief 片上Flash读写测试
+ * @param addr 空闲页的起始地址，测试会擦除该页
+ * @return rt_err_t 测试结果
+ * @retval RT_EOK 测试通过
+ * @retval -RT_ERROR 测试失败
+ * @note 覆盖非对齐写入时双字内其余字节保持不变、读回数据、重复写入已编程的双字失败和越界检查
+ */
+static rt_err_t flash_rw_test(rt_uint32_t addr)
+{
+    rt_uint32_t target, next;
+    rt_size_t i, length;
+    int w;
+
+    rt_kprintf("[TEST] Starting flash test on the page at 0x%08x...\n", addr);
+
+    if (stm32_flash_erase(addr, FLASH_PAGE_SIZE) != FLASH_PAGE_SIZE || !flash_test_erased(addr, FLASH_PAGE_SIZE))
+    {
+        rt_kprintf("[TEST] Erase failed!\n");
+        return -RT_ERROR;
+    }
+
+    for (w = 0; w < sizeof(flash_test_writes) / sizeof(flash_test_writes[0]); w++)
+    {
+        target = addr + flash_test_writes[w].offset;
+        length = flash_test_writes[w].length;
+        for (i = 0; i < length; i++)
+        {
+            flash_test_buf[i] = (rt_uint8_t)(w * 31 + i);
+        }
+
+        if (stm32_flash_write(target, flash_test_buf, length) != length)
+        {
+            rt_kprintf("[TEST] Write of %d bytes at 0x%08x failed!\n", (int)length, target);
+            return -RT_ERROR;
+        }
+        if (rt_memcmp((const void *)target, flash_test_buf, length) != 0)
+        {
+            rt_kprintf("[TEST] Data at 0x%08x mismatch!\n", target);
+            return -RT_ERROR;
+        }
+
+        /* 同一双字中写入范围之前和之后的字节保持擦除状态 */
+        next = RT_ALIGN(target + length, 8);
+        if (!flash_test_erased(RT_ALIGN_DOWN(target, 8), target - RT_ALIGN_DOWN(target, 8)) ||
+            !flash_test_erased(target + length, next - (target + length)))
+            return -RT_ERROR;
+    }
+    rt_kprintf("[TEST] Unaligned write: PASS\n");
+
+    /* 读取任意偏移和长度 */
+    target = addr + flash_test_writes[6].offset + 3;
+    if (stm32_flash_read(target, flash_test_buf, 300) != 300 ||
+        rt_memcmp(flash_test_buf, (const void *)target, 300) != 0)
+    {
+        rt_kprintf("[TEST] Read failed!\n");
+        return -RT_ERROR;
+    }
+    rt_kprintf("[TEST] Read: PASS\n");
+
+    /* 已编程的双字不能再写 */
+    flash_test_buf[0] = 0;
+    if (stm32_flash_write(addr, flash_test_buf, 1) >= 0)
+    {
+        rt_kprintf("[TEST] Write over programmed data did not fail!\n");
+        return -RT_ERROR;
+    }
+    rt_kprintf("[TEST] Write over programmed data: PASS\n");
+
+    /* 越界 */
+    if (stm32_flash_write(STM32_FLASH_END_ADDRESS - 4, flash_test_buf, 8) != -RT_EINVAL ||
+        stm32_flash_read(STM32_FLASH_END_ADDRESS - 4, flash_test_buf, 8) != -RT_EINVAL)
+    {
+        rt_kprintf("[TEST] Out of range access did not fail!\n");
+        return -RT_ERROR;
+    }
+    rt_kprintf("[TEST] Out of range: PASS\n");
+
+    if (stm32_flash_erase(addr, FLASH_PAGE_SIZE) != FLASH_PAGE_SIZE || !flash_test_erased(addr, FLASH_PAGE_SIZE))
+    {
+        rt_kprintf("[TEST] Erase after the test failed!\n");
+        return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup Flash_MSH_Commands Flash MSH命令接口
+ * @{
+ */
+
+/**
+ * @brief Flash测试MSH命令
+ * @param argc 参数个数
+ * @param argv 参数列表，argv[1]为空闲页的地址，该页的内容会被擦除
+ */
+static void flash_test(int argc, char **argv)
+{
+    rt_uint32_t addr;
+
+    if (argc != 2)
+    {
+        rt_kprintf("Please input: flash_test <address of a spare page, it is erased>\n");
+        return;
+    }
+
+    addr = strtoul(argv[1], RT_NULL, 0);
+    if (addr % FLASH_PAGE_SIZE != 0 || addr < STM32_FLASH_START_ADRESS ||
+        addr + FLASH_PAGE_SIZE > STM32_FLASH_END_ADDRESS)
+    {
+        rt_kprintf("0x%08x is not a flash page!\n", addr);
+        return;
+    }
+
+    rt_kprintf("\n=== Flash Driver Test ===\n");
+
+    if (flash_rw_test(addr) == RT_EOK)
+    {
+        rt_kprintf("=== All Flash Tests PASSED ===\n");
+    }
+    else
+    {
+        rt_kprintf("=== Flash Test FAILED ===\n");
+    }
+}
+
+MSH_CMD_EXPORT(flash_test, on-chip flash write and read test on a spare page);
+
+/**
+ * @}
+ */
+
+#endif /* BSP_USING_ON_CHIP_FLASH */
@@ -282,6 +282,8 @@ static const struct pin_irq_map pin_irq_map[] =
 #endif
 };
 
+#define ITEM_NUM(items) sizeof(items) / sizeof(items[0])
+
 static struct rt_pin_irq_hdr pin_irq_hdr_tab[] =
 {
     {-1, 0, RT_NULL, RT_NULL},
@@ -303,7 +305,29 @@ static struct rt_pin_irq_hdr pin_irq_hdr_tab[] =
 };
 static uint32_t pin_irq_enable_mask=0;
 
-#define ITEM_NUM(items) sizeof(items) / sizeof(items[0])
+/* the EXTI pending register, write 1 to clear */
+#if defined(EXTI_PR1_PIF0)
+#define PIN_EXTI_PENDING        (EXTI->PR1)
+#elif defined(EXTI_PR_PR0)
+#define PIN_EXTI_PENDING        (EXTI->PR)
+#endif
+
+#ifdef BSP_PIN_USING_IRQ_STAT
+struct pin_irq_stat
+{
+    rt_uint32_t count;
+#ifdef RT_USING_CPUTIME
+    rt_uint32_t max_latency;            /* cputime ticks from the EXTI entry to the return of the handler */
+#endif
+};
+
+static struct pin_irq_stat pin_irq_stat_tab[ITEM_NUM(pin_irq_hdr_tab)];
+#ifdef RT_USING_CPUTIME
+/* the EXTI interrupts share one priority and never nest */
+static rt_uint32_t pin_irq_entry;
+#endif
+#endif /* BSP_PIN_USING_IRQ_STAT */
+
 static const struct pin_index *get_pin(uint8_t pin)
 {
     const struct pin_index *index;
@@ -353,6 +377,54 @@ static int stm32_pin_read(rt_device_t dev, rt_base_t pin)
     return value;
 }
 
+static GPIO_TypeDef *get_port(rt_base_t port)
+{
+    const struct pin_index *index;
+
+    if (port < 0 || (rt_size_t)port * 16 >= ITEM_NUM(pins))
+    {
+        return RT_NULL;
+    }
+
+    /* the first pin of a port carries its GPIO instance */
+    index = get_pin(port * 16);
+    if (index == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    return index->gpio;
+}
+
+static rt_ssize_t stm32_port_read(rt_device_t dev, rt_base_t port)
+{
+    GPIO_TypeDef *gpio;
+
+    gpio = get_port(port);
+    if (gpio == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    return gpio->IDR & 0xFFFF;
+}
+
+static rt_err_t stm32_port_write(rt_device_t dev, rt_base_t port, rt_uint32_t set_mask, rt_uint32_t clear_mask)
+{
+    GPIO_TypeDef *gpio;
+
+    gpio = get_port(port);
+    if (gpio == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    /* the set half of BSRR wins when a pin is in both masks */
+    gpio->BSRR = ((clear_mask & 0xFFFF) << 16) | (set_mask & 0xFFFF);
+
+    return RT_EOK;
+}
+
 static void stm32_pin_mode(rt_device_t dev, rt_base_t pin, rt_base_t mode)
 {
     const struct pin_index *index;
@@ -630,12 +702,15 @@ static rt_err_t stm32_pin_irq_enable(struct rt_device *device, rt_base_t pin,
 }
 const static struct rt_pin_ops _stm32_pin_ops =
 {
-    stm32_pin_mode,
-    stm32_pin_write,
-    stm32_pin_read,
-    stm32_pin_attach_irq,
-    stm32_pin_dettach_irq,
-    stm32_pin_irq_enable,
+    .pin_mode = stm32_pin_mode,
+    .pin_write = stm32_pin_write,
+    .pin_read = stm32_pin_read,
+    .pin_attach_irq = stm32_pin_attach_irq,
+    .pin_detach_irq = stm32_pin_dettach_irq,
+    .pin_irq_enable = stm32_pin_irq_enable,
+    .pin_get = RT_NULL,
+    .port_read = stm32_port_read,
+    .port_write = stm32_port_write,
 };
 
 rt_inline void pin_irq_hdr(int irqno)
@@ -644,6 +719,51 @@ rt_inline void pin_irq_hdr(int irqno)
     {
         pin_irq_hdr_tab[irqno].hdr(pin_irq_hdr_tab[irqno].args);
     }
+
+#ifdef BSP_PIN_USING_IRQ_STAT
+    pin_irq_stat_tab[irqno].count++;
+#ifdef RT_USING_CPUTIME
+    {
+        rt_uint32_t latency = (rt_uint32_t)clock_cpu_gettime() - pin_irq_entry;
+
+        if (latency > pin_irq_stat_tab[irqno].max_latency)
+        {
+            pin_irq_stat_tab[irqno].max_latency = latency;
+        }
+    }
+#endif
+#endif /* BSP_PIN_USING_IRQ_STAT */
+}
+
+/* serve the pending lines of an EXTI interrupt, lines is the mask of the lines it covers */
+static void pin_irq_dispatch(rt_uint32_t lines)
+{
+    rt_uint32_t pending;
+    int line;
+
+#if defined(BSP_PIN_USING_IRQ_STAT) && defined(RT_USING_CPUTIME)
+    pin_irq_entry = (rt_uint32_t)clock_cpu_gettime();
+#endif
+
+#ifdef PIN_EXTI_PENDING
+    /* one read for all the lines, cleared before the handlers so that a new edge is kept */
+    pending = PIN_EXTI_PENDING & lines;
+    PIN_EXTI_PENDING = pending;
+#else
+    pending = lines;
+#endif
+
+    while (pending != 0)
+    {
+        line = 31 - __CLZ(pending);
+        pending &= ~(1UL << line);
+#ifdef PIN_EXTI_PENDING
+        pin_irq_hdr(line);
+#else
+        /* split rising/falling pending registers, the HAL checks and calls back */
+        HAL_GPIO_EXTI_IRQHandler(1UL << line);
+#endif
+    }
 }
 
 #if defined(SOC_SERIES_STM32G0)
@@ -667,32 +787,19 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 void EXTI0_1_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_1);
+    pin_irq_dispatch(GPIO_PIN_0 | GPIO_PIN_1);
     rt_interrupt_leave();
 }
 
 void EXTI2_3_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_2);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_3);
+    pin_irq_dispatch(GPIO_PIN_2 | GPIO_PIN_3);
     rt_interrupt_leave();
 }
 void EXTI4_15_IRQHandler(void)
 {
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_4);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_5);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_6);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_7);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_8);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_9);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_10);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_11);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_12);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_14);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_15);
+    pin_irq_dispatch(0xFFF0);           /* lines 4~15 */
 }
 
 #else
@@ -700,62 +807,105 @@ void EXTI4_15_IRQHandler(void)
 void EXTI0_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_0);
+    pin_irq_dispatch(GPIO_PIN_0);
     rt_interrupt_leave();
 }
 
 void EXTI1_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_1);
+    pin_irq_dispatch(GPIO_PIN_1);
     rt_interrupt_leave();
 }
 
 void EXTI2_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_2);
+    pin_irq_dispatch(GPIO_PIN_2);
     rt_interrupt_leave();
 }
 
 void EXTI3_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_3);
+    pin_irq_dispatch(GPIO_PIN_3);
     rt_interrupt_leave();
 }
 
 void EXTI4_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_4);
+    pin_irq_dispatch(GPIO_PIN_4);
     rt_interrupt_leave();
 }
 
 void EXTI9_5_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_5);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_6);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_7);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_8);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_9);
+    pin_irq_dispatch(GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9);
     rt_interrupt_leave();
 }
 
 void EXTI15_10_IRQHandler(void)
 {
     rt_interrupt_enter();
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_10);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_11);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_12);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_13);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_14);
-    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_15);
+    pin_irq_dispatch(GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12 | GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15);
     rt_interrupt_leave();
 }
 #endif
 
+#if defined(BSP_PIN_USING_IRQ_STAT) && defined(RT_USING_FINSH)
+static void pin_irq_stat(int argc, char **argv)
+{
+    struct pin_irq_stat stat;
+    rt_base_t level;
+    rt_base_t pin;
+    int line;
+
+    if (argc > 1 && rt_strcmp(argv[1], "clear") == 0)
+    {
+        level = rt_hw_interrupt_disable();
+        rt_memset(pin_irq_stat_tab, 0, sizeof(pin_irq_stat_tab));
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+
+#ifdef RT_USING_CPUTIME
+    rt_kprintf("line pin   count      max(us)\n");
+    rt_kprintf("---- ----- ---------- -------\n");
+#else
+    rt_kprintf("line pin   count\n");
+    rt_kprintf("---- ----- ----------\n");
+#endif
+    for (line = 0; line < ITEM_NUM(pin_irq_stat_tab); line++)
+    {
+        level = rt_hw_interrupt_disable();
+        stat = pin_irq_stat_tab[line];
+        pin = pin_irq_hdr_tab[line].pin;
+        rt_hw_interrupt_enable(level);
+
+        if (stat.count == 0)
+        {
+            continue;
+        }
+
+        if (pin >= 0)
+        {
+            rt_kprintf("%4d P%c.%-2d %10u", line, 'A' + (int)(pin / 16), (int)(pin % 16), stat.count);
+        }
+        else
+        {
+            rt_kprintf("%4d -     %10u", line, stat.count);
+        }
+#ifdef RT_USING_CPUTIME
+        rt_kprintf(" %7u", (rt_uint32_t)clock_cpu_microsecond(stat.max_latency));
+#endif
+        rt_kprintf("\n");
+    }
+}
+MSH_CMD_EXPORT(pin_irq_stat, show EXTI line statistics: pin_irq_stat [clear]);
+#endif /* defined(BSP_PIN_USING_IRQ_STAT) && defined(RT_USING_FINSH) */
+
 int rt_hw_pin_init(void)
 {
 #if defined(__HAL_RCC_GPIOA_CLK_ENABLE)
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    first version
+ */
+
+#include <board.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(BSP_USING_KTIME_TIM2) && defined(RT_USING_KTIME)
+#include <ktime.h>
+
+//#define DRV_DEBUG
+#define LOG_TAG             "drv.ktime"
+#include <drv_log.h>
+
+/*
+ * ktime cputimer and hrtimer on the free running 32 bits TIM2.
+ *
+ * The counter is read for the cputimer, channel 1 compares for the hrtimer
+ * timeout and the update interrupt extends the counter to 64 bits for the
+ * boottime, so clock_gettime() does not wrap every 2^32 counts.
+ */
+
+#if defined(BSP_USING_TIM2) || defined(BSP_USING_PWM2)
+#error "TIM2 is used by ktime, undefine BSP_USING_TIM2 and BSP_USING_PWM2"
+#endif
+
+#ifndef BSP_KTIME_TIMER_FREQ
+#define BSP_KTIME_TIMER_FREQ        1000000
+#endif
+
+#define KTIME_TIM                   TIM2
+#define KTIME_TIM_IRQn              TIM2_IRQn
+#define KTIME_NS_PER_SEC            (1000UL * 1000 * 1000)
+
+static rt_bool_t ktime_inited;
+static volatile rt_uint32_t ktime_overflow;
+static void (*ktime_timeout)(void *param);
+static void *ktime_timeout_param;
+
+static rt_uint32_t stm32_ktime_clock(void)
+{
+    /* the timers run at twice PCLK1 when APB1 is divided */
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) == RCC_HCLK_DIV1)
+    {
+        return HAL_RCC_GetPCLK1Freq();
+    }
+    return HAL_RCC_GetPCLK1Freq() * 2;
+}
+
+/* the 64 bits count since the timer started */
+static rt_uint64_t stm32_ktime_count(void)
+{
+    rt_uint32_t high, low;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    high = ktime_overflow;
+    low = KTIME_TIM->CNT;
+    /* wrapped but not serviced yet, the low half read may be either side of the wrap */
+    if (KTIME_TIM->SR & TIM_SR_UIF)
+    {
+        low = KTIME_TIM->CNT;
+        high++;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return ((rt_uint64_t)high << 32) | low;
+}
+
+static void stm32_ktime_to_timespec(rt_uint64_t count, struct timespec *ts)
+{
+    ts->tv_sec = count / BSP_KTIME_TIMER_FREQ;
+    ts->tv_nsec = (count % BSP_KTIME_TIMER_FREQ) * KTIME_NS_PER_SEC / BSP_KTIME_TIMER_FREQ;
+}
+
+unsigned long rt_ktime_cputimer_getres(void)
+{
+    return (unsigned long)(((rt_uint64_t)KTIME_NS_PER_SEC * RT_KTIME_RESMUL) / BSP_KTIME_TIMER_FREQ);
+}
+
+unsigned long rt_ktime_cputimer_getfrq(void)
+{
+    return BSP_KTIME_TIMER_FREQ;
+}
+
+unsigned long rt_ktime_cputimer_getcnt(void)
+{
+    return KTIME_TIM->CNT;
+}
+
+unsigned long rt_ktime_cputimer_getstep(void)
+{
+    return BSP_KTIME_TIMER_FREQ / RT_TICK_PER_SECOND;
+}
+
+void rt_ktime_cputimer_init(void)
+{
+    rt_uint32_t clock;
+
+    if (ktime_inited)
+    {
+        return;
+    }
+
+    clock = stm32_ktime_clock();
+    if (clock % BSP_KTIME_TIMER_FREQ != 0)
+    {
+        LOG_W("timer clock %d Hz is not a multiple of %d Hz", clock, BSP_KTIME_TIMER_FREQ);
+    }
+
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    KTIME_TIM->CR1 = 0;
+    KTIME_TIM->PSC = clock / BSP_KTIME_TIMER_FREQ - 1;
+    KTIME_TIM->ARR = 0xFFFFFFFF;
+    /* channel 1 is a frozen output compare, only its match flag is used */
+    KTIME_TIM->CCMR1 = 0;
+    KTIME_TIM->CCER = 0;
+    /* load the prescaler, the update flag it raises is not an overflow */
+    KTIME_TIM->EGR = TIM_EGR_UG;
+    KTIME_TIM->SR = 0;
+    KTIME_TIM->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(KTIME_TIM_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(KTIME_TIM_IRQn);
+
+    KTIME_TIM->CR1 = TIM_CR1_CEN;
+    ktime_inited = RT_TRUE;
+
+    LOG_D("ktime on TIM2, %d Hz", BSP_KTIME_TIMER_FREQ);
+}
+
+unsigned long rt_ktime_hrtimer_getres(void)
+{
+    return rt_ktime_cputimer_getres();
+}
+
+unsigned long rt_ktime_hrtimer_getfrq(void)
+{
+    return BSP_KTIME_TIMER_FREQ;
+}
+
+unsigned long rt_ktime_hrtimer_getcnt(void)
+{
+    return KTIME_TIM->CNT;
+}
+
+rt_err_t rt_ktime_hrtimer_settimeout(unsigned long cnt, void (*timeout)(void *param), void *param)
+{
+    rt_uint32_t now;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    KTIME_TIM->DIER &= ~TIM_DIER_CC1IE;
+    KTIME_TIM->SR = ~TIM_SR_CC1IF;
+
+    if (cnt == 0)
+    {
+        rt_hw_interrupt_enable(level);
+        /* already expired, or no timer left when timeout is RT_NULL */
+        if (timeout)
+        {
+            timeout(param);
+        }
+        return RT_EOK;
+    }
+
+    ktime_timeout = timeout;
+    ktime_timeout_param = param;
+
+    now = KTIME_TIM->CNT;
+    KTIME_TIM->CCR1 = now + cnt;
+    KTIME_TIM->DIER |= TIM_DIER_CC1IE;
+    /* the counter may have passed the compare value already, that match would come a wrap later */
+    if (KTIME_TIM->CNT - now >= cnt)
+    {
+        KTIME_TIM->EGR = TIM_EGR_CC1G;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_ktime_boottime_get_us(struct timeval *tv)
+{
+    struct timespec ts;
+
+    RT_ASSERT(tv != RT_NULL);
+
+    stm32_ktime_to_timespec(stm32_ktime_count(), &ts);
+    tv->tv_sec = ts.tv_sec;
+    tv->tv_usec = ts.tv_nsec / 1000;
+
+    return RT_EOK;
+}
+
+rt_err_t rt_ktime_boottime_get_s(time_t *t)
+{
+    RT_ASSERT(t != RT_NULL);
+
+    *t = stm32_ktime_count() / BSP_KTIME_TIMER_FREQ;
+
+    return RT_EOK;
+}
+
+rt_err_t rt_ktime_boottime_get_ns(struct timespec *ts)
+{
+    RT_ASSERT(ts != RT_NULL);
+
+    stm32_ktime_to_timespec(stm32_ktime_count(), ts);
+
+    return RT_EOK;
+}
+
+void TIM2_IRQHandler(void)
+{
+    rt_uint32_t status;
+    void (*timeout)(void *param);
+
+    rt_interrupt_enter();
+
+    status = KTIME_TIM->SR & KTIME_TIM->DIER;
+    if (status & TIM_SR_UIF)
+    {
+        KTIME_TIM->SR = ~TIM_SR_UIF;
+        ktime_overflow++;
+    }
+    if (status & TIM_SR_CC1IF)
+    {
+        /* one shot, the callback sets the next timeout */
+        KTIME_TIM->DIER &= ~TIM_DIER_CC1IE;
+        KTIME_TIM->SR = ~TIM_SR_CC1IF;
+        timeout = ktime_timeout;
+        if (timeout)
+        {
+            timeout(ktime_timeout_param);
+        }
+    }
+
+    rt_interrupt_leave();
+}
+
+static int stm32_ktime_init(void)
+{
+    rt_ktime_cputimer_init();
+    return 0;
+}
+INIT_BOARD_EXPORT(stm32_ktime_init);
+
+#ifdef RT_USING_FINSH
+#include <stdlib.h>
+
+struct ktime_bench
+{
+    struct rt_ktime_hrtimer timer;
+    struct rt_semaphore done;
+    rt_int32_t late;
+};
+
+struct ktime_bench_stat
+{
+    rt_int32_t min;
+    rt_int32_t max;
+    rt_int64_t sum;
+};
+
+static void ktime_bench_timeout(void *parameter)
+{
+    struct ktime_bench *bench = (struct ktime_bench *)parameter;
+
+    bench->late = (rt_int32_t)(rt_ktime_cputimer_getcnt() - bench->timer.timeout_cnt);
+    rt_sem_release(&bench->done);
+}
+
+static void ktime_bench_add(struct ktime_bench_stat *stat, rt_int32_t late)
+{
+    if (late < stat->min)
+    {
+        stat->min = late;
+    }
+    if (late > stat->max)
+    {
+        stat->max = late;
+    }
+    stat->sum += late;
+}
+
+static rt_int32_t ktime_bench_ns(rt_int64_t count)
+{
+    return (rt_int32_t)(count * (rt_int64_t)KTIME_NS_PER_SEC / BSP_KTIME_TIMER_FREQ);
+}
+
+static void ktime_bench_print(const char *name, const struct ktime_bench_stat *stat, int count)
+{
+    rt_kprintf("%-8s min %8d ns  avg %8d ns  max %8d ns\n", name,
+               ktime_bench_ns(stat->min), ktime_bench_ns(stat->sum / count), ktime_bench_ns(stat->max));
+}
+
+static void ktime_bench(int argc, char **argv)
+{
+    struct ktime_bench_stat irq = {INT32_MAX, INT32_MIN, 0};
+    struct ktime_bench_stat wake = {INT32_MAX, INT32_MIN, 0};
+    struct ktime_bench bench;
+    unsigned long period_us = 100;
+    unsigned long cnt, start;
+    int count = 100;
+    int i;
+
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        period_us = atoi(argv[2]);
+    }
+    if (count <= 0 || period_us == 0)
+    {
+        rt_kprintf("usage: ktime_bench [count] [period_us]\n");
+        return;
+    }
+    cnt = (unsigned long)((rt_uint64_t)period_us * BSP_KTIME_TIMER_FREQ / 1000000);
+
+    rt_memset(&bench, 0, sizeof(bench));
+    rt_sem_init(&bench.done, "kbench", 0, RT_IPC_FLAG_PRIO);
+
+    /* lateness of the hrtimer callback against its compare value */
+    for (i = 0; i < count; i++)
+    {
+        rt_ktime_hrtimer_init(&bench.timer, "kbench", cnt, RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER,
+                              ktime_bench_timeout, &bench);
+        rt_ktime_hrtimer_start(&bench.timer);
+        rt_sem_take(&bench.done, RT_WAITING_FOREVER);
+        rt_ktime_hrtimer_detach(&bench.timer);
+        ktime_bench_add(&irq, bench.late);
+    }
+
+    /* lateness of a thread woken from rt_ktime_hrtimer_udelay() */
+    for (i = 0; i < count; i++)
+    {
+        start = rt_ktime_cputimer_getcnt();
+        rt_ktime_hrtimer_udelay(period_us);
+        ktime_bench_add(&wake, (rt_int32_t)(rt_ktime_cputimer_getcnt() - start - cnt));
+    }
+
+    rt_sem_detach(&bench.done);
+
+    rt_kprintf("%d runs of %d us, timer %d Hz\n", count, period_us, BSP_KTIME_TIMER_FREQ);
+    ktime_bench_print("hrtimer", &irq, count);
+    ktime_bench_print("udelay", &wake, count);
+}
+MSH_CMD_EXPORT(ktime_bench, measure hrtimer jitter: ktime_bench [count] [period_us]);
+#endif /* RT_USING_FINSH */
+
+#endif /* defined(BSP_USING_KTIME_TIM2) && defined(RT_USING_KTIME) */
@@ -105,6 +105,39 @@ static void led_set_hardware_state(led_channel_t channel, led_state_t state)
     led_states[channel] = state;
 }
 
+/**
+ * @brief 一次写入全部LED的硬件状态
+ * @param states 各通道的LED状态
+ * @note 同一端口的LED合并为一次BSRR写入，RGB各通道同时变化，避免逐个引脚切换产生的色彩过渡
+ */
+static void led_write_hardware(const led_state_t states[LED_CHANNEL_MAX])
+{
+    rt_base_t port = PIN_PORT(led_pins[0]);
+    rt_uint32_t set_mask = 0, clear_mask = 0;
+
+    for (int i = 0; i < LED_CHANNEL_MAX; i++)
+    {
+        if (PIN_PORT(led_pins[i]) != port)
+        {
+            rt_pin_port_write(port, set_mask, clear_mask);
+            port = PIN_PORT(led_pins[i]);
+            set_mask = 0;
+            clear_mask = 0;
+        }
+
+        if (((states[i] == LED_ON) ? LED_ON_LEVEL : LED_OFF_LEVEL) == PIN_HIGH)
+        {
+            set_mask |= PIN_MASK(led_pins[i]);
+        }
+        else
+        {
+            clear_mask |= PIN_MASK(led_pins[i]);
+        }
+        led_states[i] = states[i];
+    }
+    rt_pin_port_write(port, set_mask, clear_mask);
+}
+
 /**
  * @}
  */
@@ -125,14 +158,15 @@ rt_err_t drv_led_init(void)
 {
     LOG_D("LED driver initializing...");
     
+    const led_state_t off_states[LED_CHANNEL_MAX] = {LED_OFF, LED_OFF, LED_OFF};
+
     /* 配置LED GPIO为开漏输出模式 */
     for (int i = 0; i < LED_CHANNEL_MAX; i++)
     {
         rt_pin_mode(led_pins[i], PIN_MODE_OUTPUT_OD);
-        /* 默认设置为高电平（LED熄灭） */
-        rt_pin_write(led_pins[i], LED_OFF_LEVEL);
-        led_states[i] = LED_OFF;
     }
+    /* 默认设置为高电平（LED熄灭） */
+    led_write_hardware(off_states);
     
     /* 初始化RGB颜色值 */
     current_rgb_color.red = 0;
@@ -232,16 +266,19 @@ led_state_t drv_led_get_state(led_channel_t channel)
  */
 rt_err_t drv_led_set_rgb_color(const rgb_color_t *color)
 {
+    led_state_t states[LED_CHANNEL_MAX];
+
     if (color == RT_NULL)
     {
         LOG_E("RGB color pointer is NULL");
         return -RT_EINVAL;
     }
     
-    /* 根据颜色值控制LED状态（简化实现：>0为开启，=0为关闭） */
-    led_set_hardware_state(LED_RED, (color->red > 0) ? LED_ON : LED_OFF);
-    led_set_hardware_state(LED_GREEN, (color->green > 0) ? LED_ON : LED_OFF);
-    led_set_hardware_state(LED_BLUE, (color->blue > 0) ? LED_ON : LED_OFF);
+    /* 根据颜色值控制LED状态（简化实现：>0为开启，=0为关闭），三个通道一次写入 */
+    states[LED_RED] = (color->red > 0) ? LED_ON : LED_OFF;
+    states[LED_GREEN] = (color->green > 0) ? LED_ON : LED_OFF;
+    states[LED_BLUE] = (color->blue > 0) ? LED_ON : LED_OFF;
+    led_write_hardware(states);
     
     /* 保存当前RGB颜色值 */
     current_rgb_color = *color;
@@ -18,6 +18,8 @@
 #include "drv_led.h"
 #include <rtthread.h>
 #include <rtdevice.h>
+#include <board.h>
+#include <drv_common.h>
 
 /**
  * @defgroup LED_Test_Functions LED测试函数
@@ -163,6 +165,54 @@ static rt_err_t led_color_preset_test(void)
     return RT_EOK;
 }
 
+/**
+ * @brief LED端口批量读写测试
+ * @return rt_err_t 测试结果
+ * @retval RT_EOK 测试通过
+ * @retval -RT_ERROR 测试失败
+ * @note 该函数设置颜色后整端口读回引脚电平，检查点亮的通道均已拉低
+ */
+static rt_err_t led_port_test(void)
+{
+    static const struct
+    {
+        rgb_color_t color;
+        rt_uint32_t low_mask;   /* 点亮的LED为低电平 */
+    } cases[] =
+    {
+        {RGB_COLOR_RED,     PIN_MASK(GET_PIN(A, 6))},
+        {RGB_COLOR_CYAN,    PIN_MASK(GET_PIN(A, 7)) | PIN_MASK(GET_PIN(A, 5))},
+        {RGB_COLOR_WHITE,   PIN_MASK(GET_PIN(A, 6)) | PIN_MASK(GET_PIN(A, 7)) | PIN_MASK(GET_PIN(A, 5))},
+        {RGB_COLOR_BLACK,   0},
+    };
+    rt_ssize_t value;
+
+    rt_kprintf("[TEST] Starting LED port test...\n");
+
+    for (rt_size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        drv_led_set_rgb_color(&cases[i].color);
+
+        value = rt_pin_port_read(PIN_PORT(GET_PIN(A, 6)));
+        if (value < 0)
+        {
+            rt_kprintf("[TEST] Port read not supported!\n");
+            return -RT_ERROR;
+        }
+        /* 开漏输出熄灭时引脚悬空，只检查点亮的LED被拉低 */
+        if ((value & cases[i].low_mask) != 0)
+        {
+            rt_kprintf("[TEST] Port level 0x%04x mismatch in case %d!\n", (rt_uint32_t)value & 0xFFFF, (int)i);
+            return -RT_ERROR;
+        }
+        rt_thread_mdelay(300);
+    }
+
+    rt_kprintf("[TEST] LED port test: PASS\n");
+
+    return RT_EOK;
+}
+
 /**
  * @brief LED驱动完整测试函数
  * @return rt_err_t 测试结果
@@ -192,6 +242,14 @@ rt_err_t drv_led_full_test(void)
         return -RT_ERROR;
     }
     
+    /* 执行端口批量读写测试 */
+    result = led_port_test();
+    if (result != RT_EOK)
+    {
+        rt_kprintf("[TEST] Port test failed!\n");
+        return -RT_ERROR;
+    }
+    
     rt_kprintf("[TEST] LED GPIO pins:\n");
     rt_kprintf("  Red LED:   PA6\n");
     rt_kprintf("  Green LED: PA7\n");
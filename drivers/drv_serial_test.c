@@ -0,0 +1,230 @@
+/**
+ * @file drv_serial_test.c
+ * @brief 串口中断接收吞吐量测试文件
+ * @details 用模拟的串口设备测量中断模式接收FIFO的吞吐量，并检查数据顺序，不需要外部信号
+ * @author RT-Thread Team
+ * @date 2026-10-16
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2026 RT-Thread Development Team
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>日期       <th>版本  <th>作者     <th>说明
+ * <tr><td>2026-10-16 <td>1.0.0 <td>RT-Thread Team <td>首次创建
+ * </table>
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#if defined(RT_USING_SERIAL) && defined(RT_USING_SERIAL_V1)
+
+#if defined(RT_USING_POSIX_STDIO) && defined(RT_USING_POSIX_TERMIOS) && !defined(RT_USING_TTY)
+#include <termios.h>
+#include <sys/ioctl.h>
+#define FAKE_UART_USING_FLUSH
+#endif
+
+/**
+ * @defgroup Serial_Test_Functions 串口测试函数
+ * @{
+ */
+
+#define FAKE_UART_BUFSZ     256     /* 接收FIFO大小 */
+#define FAKE_UART_TOTAL     (256 * 1024)    /* 每种突发长度接收的总字节数 */
+
+static struct rt_serial_device fake_uart;
+static rt_size_t fake_uart_pending;     /* 本次中断还能读出的字节数 */
+static rt_uint8_t fake_uart_next;       /* 下一个接收的字节 */
+
+static rt_err_t fake_uart_configure(struct rt_serial_device *serial, struct serial_configure *cfg)
+{
+    return RT_EOK;
+}
+
+static rt_err_t fake_uart_control(struct rt_serial_device *serial, int cmd, void *arg)
+{
+    return RT_EOK;
+}
+
+static int fake_uart_putc(struct rt_serial_device *serial, char c)
+{
+    return 1;
+}
+
+static int fake_uart_getc(struct rt_serial_device *serial)
+{
+    if (fake_uart_pending == 0)
+        return -1;
+
+    fake_uart_pending--;
+    return fake_uart_next++;
+}
+
+static const struct rt_uart_ops fake_uart_ops =
+{
+    .configure = fake_uart_configure,
+    .control = fake_uart_control,
+    .putc = fake_uart_putc,
+    .getc = fake_uart_getc,
+};
+
+/**
+ * @brief 按固定突发长度接收并读出数据
+ * @param device 串口设备
+ * @param burst 每次中断接收的字节数
+ * @return rt_err_t 测试结果
+ * @note 吞吐量包含模拟getc的开销，只用于比较不同版本的FIFO
+ */
+static rt_err_t serial_rx_bench(rt_device_t device, rt_size_t burst)
+{
+    rt_uint8_t buf[FAKE_UART_BUFSZ];
+    rt_uint8_t expect = 0;
+    rt_size_t total, len;
+    rt_tick_t tick;
+
+    fake_uart_next = 0;
+    tick = rt_tick_get();
+    for (total = 0; total < FAKE_UART_TOTAL; total += burst)
+    {
+        fake_uart_pending = burst;
+        rt_hw_serial_isr(&fake_uart, RT_SERIAL_EVENT_RX_IND);
+
+        len = rt_device_read(device, 0, buf, burst);
+        if (len != burst)
+        {
+            rt_kprintf("[TEST] Read %d bytes, not %d!\n", (int)len, (int)burst);
+            return -RT_ERROR;
+        }
+        for (len = 0; len < burst; len++)
+        {
+            if (buf[len] != expect++)
+            {
+                rt_kprintf("[TEST] Byte %d is 0x%02x, out of order!\n", (int)(total + len), buf[len]);
+                return -RT_ERROR;
+            }
+        }
+    }
+    tick = rt_tick_get() - tick;
+    if (tick == 0)
+        tick = 1;
+
+    rt_kprintf("[TEST] Burst %3d: %d KB/s\n", (int)burst,
+               (int)(FAKE_UART_TOTAL / 1024 * RT_TICK_PER_SECOND / tick));
+
+    return RT_EOK;
+}
+
+/**
+ * @brief 中断模式接收吞吐量测试
+ * @return rt_err_t 测试结果
+ * @retval RT_EOK 测试通过
+ * @retval -RT_ERROR 测试失败
+ * @note 覆盖不同突发长度、FIFO满时丢弃，以及支持TCFLSH时清空接收FIFO
+ */
+static rt_err_t serial_rx_throughput_test(void)
+{
+    static const rt_size_t bursts[] = {1, 16, 64, FAKE_UART_BUFSZ - 1};
+    struct serial_configure config = RT_SERIAL_CONFIG_DEFAULT;
+    rt_uint8_t buf[FAKE_UART_BUFSZ];
+    rt_device_t device;
+    rt_err_t result = RT_EOK;
+
+    rt_kprintf("[TEST] Starting serial RX throughput test...\n");
+
+    device = rt_device_find("fuart");
+    if (device == RT_NULL)
+    {
+        config.bufsz = FAKE_UART_BUFSZ;
+        fake_uart.ops = &fake_uart_ops;
+        fake_uart.config = config;
+        if (rt_hw_serial_register(&fake_uart, "fuart", RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX,
+                                  RT_NULL) != RT_EOK)
+        {
+            rt_kprintf("[TEST] Register fake serial failed!\n");
+            return -RT_ERROR;
+        }
+        device = &fake_uart.parent;
+    }
+
+    if (rt_device_open(device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Open fake serial failed!\n");
+        return -RT_ERROR;
+    }
+
+    for (int i = 0; i < sizeof(bursts) / sizeof(bursts[0]); i++)
+    {
+        if (serial_rx_bench(device, bursts[i]) != RT_EOK)
+        {
+            result = -RT_ERROR;
+            goto _exit;
+        }
+    }
+
+    /* FIFO满时保留一个空位，多出的字节被丢弃 */
+    fake_uart_next = 0;
+    fake_uart_pending = FAKE_UART_BUFSZ + 8;
+    rt_hw_serial_isr(&fake_uart, RT_SERIAL_EVENT_RX_IND);
+    if (rt_device_read(device, 0, buf, sizeof(buf)) != FAKE_UART_BUFSZ - 1)
+    {
+        rt_kprintf("[TEST] Full fifo does not keep %d bytes!\n", FAKE_UART_BUFSZ - 1);
+        result = -RT_ERROR;
+        goto _exit;
+    }
+    rt_kprintf("[TEST] Full fifo: PASS\n");
+
+#ifdef FAKE_UART_USING_FLUSH
+    /* 清空接收FIFO */
+    fake_uart_pending = 32;
+    rt_hw_serial_isr(&fake_uart, RT_SERIAL_EVENT_RX_IND);
+    rt_device_control(device, TCFLSH, (void *)TCIFLUSH);
+    if (rt_device_read(device, 0, buf, sizeof(buf)) != 0)
+    {
+        rt_kprintf("[TEST] Flushed fifo is not empty!\n");
+        result = -RT_ERROR;
+        goto _exit;
+    }
+    rt_kprintf("[TEST] Input flush: PASS\n");
+#endif /* FAKE_UART_USING_FLUSH */
+
+_exit:
+    rt_device_close(device);
+    return result;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup Serial_MSH_Commands 串口MSH命令接口
+ * @{
+ */
+
+/**
+ * @brief 串口测试MSH命令
+ * @note 该函数提供串口中断接收吞吐量测试的MSH命令接口
+ */
+static void serial_rx_test(void)
+{
+    rt_kprintf("\n=== Serial RX Test ===\n");
+
+    if (serial_rx_throughput_test() == RT_EOK)
+    {
+        rt_kprintf("=== All Serial RX Tests PASSED ===\n");
+    }
+    else
+    {
+        rt_kprintf("=== Serial RX Test FAILED ===\n");
+    }
+}
+
+MSH_CMD_EXPORT(serial_rx_test, serial interrupt RX fifo throughput test);
+
+/**
+ * @}
+ */
+
+#endif /* RT_USING_SERIAL && RT_USING_SERIAL_V1 */
@@ -27,6 +27,14 @@
 #define LOG_TAG              "drv.spi"
 #include <drv_log.h>
 
+/* only the transfers of at least SPI_DMA_TRANS_MIN_LEN bytes use DMA, the shorter ones are polled */
+#ifndef SPI_DMA_TRANS_MIN_LEN
+#define SPI_DMA_TRANS_MIN_LEN   16
+#endif
+
+/* the time to wait for a DMA transfer to complete */
+#define SPI_DMA_TIMEOUT         1000
+
 enum
 {
 #ifdef BSP_USING_SPI1
@@ -264,13 +272,14 @@ static rt_err_t stm32_spi_init(struct stm32_spi *spi_drv, struct rt_spi_configur
     return RT_EOK;
 }
 
-static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *message)
+static rt_ssize_t spixfer(struct rt_spi_device *device, struct rt_spi_message *message)
 {
     HAL_StatusTypeDef state;
     rt_size_t message_length, already_send_length;
     rt_uint16_t send_length;
     rt_uint8_t *recv_buf;
     const rt_uint8_t *send_buf;
+    rt_bool_t use_dma;
 
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(device->bus != RT_NULL);
@@ -313,11 +322,16 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         already_send_length = message->length - send_length - message_length;
         send_buf = (rt_uint8_t *)message->send_buf + already_send_length;
         recv_buf = (rt_uint8_t *)message->recv_buf + already_send_length;
-        
-        /* start once data exchange in DMA mode */
+
+        /* a late callback of an aborted transfer must not complete this one */
+        rt_completion_init(&spi_drv->cpt);
+
+        /* start once data exchange in DMA mode, or in polling mode for the short ones */
         if (message->send_buf && message->recv_buf)
         {
-            if ((spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG))
+            use_dma = (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG)
+                      && (send_length >= SPI_DMA_TRANS_MIN_LEN);
+            if (use_dma)
             {
                 state = HAL_SPI_TransmitReceive_DMA(spi_handle, (uint8_t *)send_buf, (uint8_t *)recv_buf, send_length);
             }
@@ -328,7 +342,8 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         }
         else if (message->send_buf)
         {
-            if (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG)
+            use_dma = (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (send_length >= SPI_DMA_TRANS_MIN_LEN);
+            if (use_dma)
             {
                 state = HAL_SPI_Transmit_DMA(spi_handle, (uint8_t *)send_buf, send_length);
             }
@@ -340,7 +355,8 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         else
         {
             memset((uint8_t *)recv_buf, 0xff, send_length);
-            if (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG)
+            use_dma = (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG) && (send_length >= SPI_DMA_TRANS_MIN_LEN);
+            if (use_dma)
             {
                 state = HAL_SPI_Receive_DMA(spi_handle, (uint8_t *)recv_buf, send_length);
             }
@@ -355,16 +371,30 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
             LOG_I("spi transfer error : %d", state);
             message->length = 0;
             spi_handle->State = HAL_SPI_STATE_READY;
+            break;
         }
-        else
+
+        if (use_dma)
         {
-            LOG_D("%s transfer done", spi_drv->config->bus_name);
+            /* block the thread until the DMA transfer completes, the other threads can run meanwhile */
+            if (rt_completion_wait(&spi_drv->cpt, rt_tick_from_millisecond(SPI_DMA_TIMEOUT)) != RT_EOK)
+            {
+                LOG_E("%s wait for DMA transfer timeout", spi_drv->config->bus_name);
+                HAL_SPI_Abort(spi_handle);
+                rt_completion_init(&spi_drv->cpt);
+                message->length = 0;
+                break;
+            }
+
+            if (spi_handle->ErrorCode != HAL_SPI_ERROR_NONE)
+            {
+                LOG_I("spi transfer error : 0x%x", spi_handle->ErrorCode);
+                message->length = 0;
+                break;
+            }
         }
 
-        /* For simplicity reasons, this example is just waiting till the end of the
-           transfer, but application may perform other tasks while transfer operation
-           is ongoing. */
-        while (HAL_SPI_GetState(spi_handle) != HAL_SPI_STATE_READY);
+        LOG_D("%s transfer done", spi_drv->config->bus_name);
     }
 
     if (message->cs_release)
@@ -478,6 +508,8 @@ static int rt_hw_spi_bus_init(void)
             }
         }
 
+        rt_completion_init(&spi_bus_obj[i].cpt);
+
         result = rt_spi_bus_register(&spi_bus_obj[i].spi_bus, spi_config[i].bus_name, &stm_spi_ops);
         RT_ASSERT(result == RT_EOK);
 
@@ -529,6 +561,36 @@ rt_err_t rt_hw_spi_device_attach(const char *bus_name, const char *device_name,
     return result;
 }
 
+/* the HAL calls back from the DMA (and SPI error) interrupts at the end of a DMA transfer */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    struct stm32_spi *spi_drv =  rt_container_of(hspi, struct stm32_spi, handle);
+
+    rt_completion_done(&spi_drv->cpt);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    struct stm32_spi *spi_drv =  rt_container_of(hspi, struct stm32_spi, handle);
+
+    rt_completion_done(&spi_drv->cpt);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    struct stm32_spi *spi_drv =  rt_container_of(hspi, struct stm32_spi, handle);
+
+    rt_completion_done(&spi_drv->cpt);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    struct stm32_spi *spi_drv =  rt_container_of(hspi, struct stm32_spi, handle);
+
+    /* the waiter checks hspi->ErrorCode */
+    rt_completion_done(&spi_drv->cpt);
+}
+
 #if defined(BSP_SPI1_TX_USING_DMA) || defined(BSP_SPI1_RX_USING_DMA)
 void SPI1_IRQHandler(void)
 {
@@ -0,0 +1,179 @@
+/**
+ * @file drv_spi_test.c
+ * @brief SPI驱动测试文件
+ * @details 测试SPI传输的轮询/DMA选择和DMA完成量的等待路径
+ * @author RT-Thread Team
+ * @date 2026-10-16
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2026 RT-Thread Development Team
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>日期       <th>版本  <th>作者     <th>说明
+ * <tr><td>2026-10-16 <td>1.0.0 <td>RT-Thread Team <td>首次创建
+ * </table>
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <board.h>
+
+#if defined(RT_USING_SPI) && (defined(BSP_USING_SPI1) || defined(BSP_USING_SPI2) || defined(BSP_USING_SPI3))
+
+#include "drv_spi.h"
+
+/**
+ * @defgroup SPI_Test_Functions SPI测试函数
+ * @{
+ */
+
+#define SPI_TEST_SHORT_LEN  4       /* 小于DMA门限，使用轮询 */
+#define SPI_TEST_DMA_LEN    512     /* 使用DMA */
+
+static rt_uint8_t spi_test_tx[SPI_TEST_DMA_LEN];
+static rt_uint8_t spi_test_rx[SPI_TEST_DMA_LEN];
+
+/**
+ * @brief 传输一次并检查返回长度和HAL状态
+ * @param device SPI设备
+ * @param length 传输长度
+ * @return rt_err_t 检查结果
+ * @note 等待返回时DMA必须已经结束，HAL状态应为READY
+ */
+static rt_err_t spi_test_transfer(struct rt_spi_device *device, rt_size_t length)
+{
+    struct stm32_spi *spi_drv = rt_container_of(device->bus, struct stm32_spi, spi_bus);
+    rt_ssize_t result;
+
+    result = rt_spi_transfer(device, spi_test_tx, spi_test_rx, length);
+    if (result != length)
+    {
+        rt_kprintf("[TEST] Transfer of %d bytes returned %d!\n", (int)length, (int)result);
+        return -RT_ERROR;
+    }
+    if (HAL_SPI_GetState(&spi_drv->handle) != HAL_SPI_STATE_READY)
+    {
+        rt_kprintf("[TEST] Transfer of %d bytes returned before the end, state %d!\n",
+                   (int)length, HAL_SPI_GetState(&spi_drv->handle));
+        return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+
+/**
+ * @brief SPI DMA完成量测试
+ * @param name SPI设备名
+ * @return rt_err_t 测试结果
+ * @retval RT_EOK 测试通过
+ * @retval -RT_ERROR 测试失败
+ * @note 覆盖轮询传输、DMA传输、上一次传输遗留的完成信号，以及只发送和只接收的DMA传输
+ */
+static rt_err_t spi_dma_completion_test(const char *name)
+{
+    struct rt_spi_device *device;
+    struct stm32_spi *spi_drv;
+    rt_tick_t tick;
+
+    rt_kprintf("[TEST] Starting SPI DMA completion test on %s...\n", name);
+
+    device = (struct rt_spi_device *)rt_device_find(name);
+    if (device == RT_NULL || device->parent.type != RT_Device_Class_SPIDevice)
+    {
+        rt_kprintf("[TEST] SPI device %s not found!\n", name);
+        return -RT_ERROR;
+    }
+    spi_drv = rt_container_of(device->bus, struct stm32_spi, spi_bus);
+
+    for (int i = 0; i < SPI_TEST_DMA_LEN; i++)
+    {
+        spi_test_tx[i] = (rt_uint8_t)i;
+    }
+
+    /* 短传输使用轮询 */
+    if (spi_test_transfer(device, SPI_TEST_SHORT_LEN) != RT_EOK)
+        return -RT_ERROR;
+    rt_kprintf("[TEST] Polled transfer: PASS\n");
+
+    if ((spi_drv->spi_dma_flag & (SPI_USING_TX_DMA_FLAG | SPI_USING_RX_DMA_FLAG)) !=
+        (SPI_USING_TX_DMA_FLAG | SPI_USING_RX_DMA_FLAG))
+    {
+        rt_kprintf("[TEST] %s has no TX and RX DMA, DMA tests skipped\n", name);
+        return RT_EOK;
+    }
+
+    /* DMA传输 */
+    tick = rt_tick_get();
+    if (spi_test_transfer(device, SPI_TEST_DMA_LEN) != RT_EOK)
+        return -RT_ERROR;
+    rt_kprintf("[TEST] DMA transfer: PASS (%d ticks)\n", rt_tick_get() - tick);
+
+    /* 模拟被中止的传输迟到的回调，下一次DMA传输不能因此提前返回 */
+    HAL_SPI_TxRxCpltCallback(&spi_drv->handle);
+    if (spi_test_transfer(device, SPI_TEST_DMA_LEN) != RT_EOK)
+        return -RT_ERROR;
+    HAL_SPI_ErrorCallback(&spi_drv->handle);
+    if (spi_test_transfer(device, SPI_TEST_DMA_LEN) != RT_EOK)
+        return -RT_ERROR;
+    rt_kprintf("[TEST] Stale completion: PASS\n");
+
+    /* 只发送和只接收 */
+    if (rt_spi_send(device, spi_test_tx, SPI_TEST_DMA_LEN) != SPI_TEST_DMA_LEN ||
+        HAL_SPI_GetState(&spi_drv->handle) != HAL_SPI_STATE_READY)
+    {
+        rt_kprintf("[TEST] DMA send failed!\n");
+        return -RT_ERROR;
+    }
+    if (rt_spi_recv(device, spi_test_rx, SPI_TEST_DMA_LEN) != SPI_TEST_DMA_LEN ||
+        HAL_SPI_GetState(&spi_drv->handle) != HAL_SPI_STATE_READY)
+    {
+        rt_kprintf("[TEST] DMA receive failed!\n");
+        return -RT_ERROR;
+    }
+    rt_kprintf("[TEST] DMA send and receive: PASS\n");
+
+    return RT_EOK;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup SPI_MSH_Commands SPI MSH命令接口
+ * @{
+ */
+
+/**
+ * @brief SPI测试MSH命令
+ * @param argc 参数个数
+ * @param argv 参数列表，argv[1]为挂载在总线上的SPI设备名
+ */
+static void spi_test(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        rt_kprintf("Please input: spi_test <spi device name>\n");
+        return;
+    }
+
+    rt_kprintf("\n=== SPI Driver Test ===\n");
+
+    if (spi_dma_completion_test(argv[1]) == RT_EOK)
+    {
+        rt_kprintf("=== All SPI Tests PASSED ===\n");
+    }
+    else
+    {
+        rt_kprintf("=== SPI Test FAILED ===\n");
+    }
+}
+
+MSH_CMD_EXPORT(spi_test, SPI driver DMA completion test);
+
+/**
+ * @}
+ */
+
+#endif /* RT_USING_SPI && (BSP_USING_SPI1 || BSP_USING_SPI2 || BSP_USING_SPI3) */
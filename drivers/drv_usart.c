@@ -14,6 +14,7 @@
 #include "drv_common.h"
 #include "uart_config.h"
 #include "board.h"
+#include "drv_usart.h"
 
 #ifdef RT_USING_SERIAL
 
@@ -49,6 +50,23 @@
 #define UART_INSTANCE_CLEAR_FUNCTION    __HAL_UART_CLEAR_IT
 #endif
 
+#if defined(SOC_SERIES_STM32L4) || defined(SOC_SERIES_STM32F7) || defined(SOC_SERIES_STM32F0) \
+    || defined(SOC_SERIES_STM32L0) || defined(SOC_SERIES_STM32G0) || defined(SOC_SERIES_STM32H7) \
+    || defined(SOC_SERIES_STM32G4)
+#define UART_TX_DATA(uart)              ((uart)->handle.Instance->TDR)
+#else
+#define UART_TX_DATA(uart)              ((uart)->handle.Instance->DR)
+#endif
+
+/* software TX ring drained by the TXE interrupt, 0 to always transmit by polling */
+#ifndef UART_TX_RING_BUFSZ
+#define UART_TX_RING_BUFSZ              256
+#endif
+
+#if (UART_TX_RING_BUFSZ & (UART_TX_RING_BUFSZ - 1)) != 0
+#error "UART_TX_RING_BUFSZ must be a power of 2"
+#endif
+
 #ifdef RT_SERIAL_USING_DMA
 /* --------------------------  DMA   config  -------------------------- */
 #if defined(SOC_SERIES_STM32F0) || defined(SOC_SERIES_STM32F1) || defined(SOC_SERIES_STM32L0) \
@@ -100,11 +118,36 @@ struct stm32_uart
     {
         DMA_HandleTypeDef handle;
         rt_size_t last_index;
+
+        /* buffer lending, the received data stays in the DMA buffer until released */
+        rt_bool_t lend;
+        rt_size_t read_index;           /* first byte not released */
+        rt_size_t pending;              /* bytes received and not released */
+        rt_uint32_t epoch;              /* bumped when the DMA overwrote unreleased data */
+        rt_uint32_t lent_epoch;
+        rt_uint32_t overrun;
+        struct rt_completion cpt;
     } dma_rx;
     struct
     {
         DMA_HandleTypeDef handle;
+
+        /* the queue of transfers, the head is the one in progress when active */
+        struct rt_hw_uart_tx_desc *head, *tail;
+        rt_bool_t active;
+        /* the transfer of the serial core */
+        struct rt_hw_uart_tx_desc core_desc;
+        rt_bool_t core_starting;        /* in stm32_dma_transmit, a start error is returned */
+        rt_err_t core_result;
     } dma_tx;
+#endif
+#if UART_TX_RING_BUFSZ > 0
+    struct
+    {
+        rt_uint8_t buffer[UART_TX_RING_BUFSZ];
+        rt_uint16_t put_index, get_index;   /* free running, only used modulo UART_TX_RING_BUFSZ */
+        rt_bool_t waiting;                  /* a writer waits for RT_SERIAL_EVENT_TX_DONE */
+    } tx_ring;
 #endif
     rt_uint16_t uart_dma_flag;
     struct rt_serial_device serial;
@@ -400,6 +443,104 @@ static rt_err_t stm32_gpio_configure(struct stm32_uart_config *config)
 
 static struct stm32_uart uart_obj[sizeof(uart_config) / sizeof(uart_config[0])] = {0};
 
+#if UART_TX_RING_BUFSZ > 0
+/*
+ * The TX ring can only be used when the TXE interrupt is able to drain it
+ * later, the output is polled with the interrupts masked (early boot), in
+ * the fault handlers, which may never return, and in the ISRs which the UART
+ * IRQ can not preempt.
+ */
+static rt_bool_t stm32_tx_ring_usable(struct stm32_uart *uart)
+{
+    rt_uint32_t ipsr = __get_IPSR();
+    rt_uint32_t grouping, uart_preempt, active_preempt, sub;
+
+    if (__get_PRIMASK() != 0)
+    {
+        return RT_FALSE;
+    }
+    /* NMI, HardFault, MemManage, BusFault and UsageFault */
+    if (ipsr >= 2 && ipsr <= 6)
+    {
+        return RT_FALSE;
+    }
+
+    grouping = NVIC_GetPriorityGrouping();
+    NVIC_DecodePriority(NVIC_GetPriority(uart->config->irq_type), grouping, &uart_preempt, &sub);
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    if (__get_FAULTMASK() != 0)
+    {
+        return RT_FALSE;
+    }
+    if (__get_BASEPRI() != 0)
+    {
+        NVIC_DecodePriority(__get_BASEPRI() >> (8U - __NVIC_PRIO_BITS), grouping, &active_preempt, &sub);
+        if (active_preempt <= uart_preempt)
+        {
+            return RT_FALSE;
+        }
+    }
+#endif /* __ARM_ARCH_7M__ || __ARM_ARCH_7EM__ */
+    if (ipsr != 0)
+    {
+        /* only an exception with a lower preempt priority is preempted by the UART IRQ */
+        NVIC_DecodePriority(NVIC_GetPriority((IRQn_Type)((rt_int32_t)ipsr - 16)), grouping, &active_preempt, &sub);
+        if (active_preempt <= uart_preempt)
+        {
+            return RT_FALSE;
+        }
+    }
+
+    return RT_TRUE;
+}
+
+/* send up to count queued bytes by polling, must be called with the interrupts disabled */
+static void stm32_tx_ring_poll(struct stm32_uart *uart, rt_size_t count)
+{
+    if (uart->tx_ring.get_index == uart->tx_ring.put_index)
+    {
+        return;
+    }
+
+    while (count-- && uart->tx_ring.get_index != uart->tx_ring.put_index)
+    {
+        while (__HAL_UART_GET_FLAG(&(uart->handle), UART_FLAG_TXE) == RESET);
+        UART_TX_DATA(uart) = uart->tx_ring.buffer[uart->tx_ring.get_index & (UART_TX_RING_BUFSZ - 1)];
+        uart->tx_ring.get_index++;
+    }
+
+    if (uart->tx_ring.get_index == uart->tx_ring.put_index)
+    {
+        __HAL_UART_DISABLE_IT(&(uart->handle), UART_IT_TXE);
+    }
+}
+
+static void stm32_tx_ring_isr(struct stm32_uart *uart)
+{
+    rt_uint16_t used;
+
+    used = uart->tx_ring.put_index - uart->tx_ring.get_index;
+    if (used)
+    {
+        UART_TX_DATA(uart) = uart->tx_ring.buffer[uart->tx_ring.get_index & (UART_TX_RING_BUFSZ - 1)];
+        uart->tx_ring.get_index++;
+        used--;
+    }
+
+    if (used == 0)
+    {
+        __HAL_UART_DISABLE_IT(&(uart->handle), UART_IT_TXE);
+    }
+
+    /* wake the writer once half of the ring is free */
+    if (uart->tx_ring.waiting && used <= UART_TX_RING_BUFSZ / 2)
+    {
+        uart->tx_ring.waiting = RT_FALSE;
+        rt_hw_serial_isr(&uart->serial, RT_SERIAL_EVENT_TX_DONE);
+    }
+}
+#endif /* UART_TX_RING_BUFSZ > 0 */
+
 static rt_err_t stm32_configure(struct rt_serial_device *serial, struct serial_configure *cfg)
 {
     struct stm32_uart *uart;
@@ -408,6 +549,15 @@ static rt_err_t stm32_configure(struct rt_serial_device *serial, struct serial_c
 
     uart = rt_container_of(serial, struct stm32_uart, serial);
 
+#if UART_TX_RING_BUFSZ > 0
+    {
+        /* send what is still queued with the old configuration */
+        rt_base_t level = rt_hw_interrupt_disable();
+        stm32_tx_ring_poll(uart, UART_TX_RING_BUFSZ);
+        rt_hw_interrupt_enable(level);
+    }
+#endif
+
     /* uart clock enable */
     stm32_uart_clk_enable(uart->config);
     /* uart gpio clock enable and gpio pin init */
@@ -480,6 +630,15 @@ static rt_err_t stm32_control(struct rt_serial_device *serial, int cmd, void *ar
     {
     /* disable interrupt */
     case RT_DEVICE_CTRL_CLR_INT:
+#if UART_TX_RING_BUFSZ > 0
+        {
+            /* send what is still queued, nothing drains the TX ring after this */
+            rt_base_t level = rt_hw_interrupt_disable();
+            stm32_tx_ring_poll(uart, UART_TX_RING_BUFSZ);
+            __HAL_UART_DISABLE_IT(&(uart->handle), UART_IT_TXE);
+            rt_hw_interrupt_enable(level);
+        }
+#endif
         /* disable rx irq */
         NVIC_DisableIRQ(uart->config->irq_type);
         /* disable interrupt */
@@ -508,14 +667,50 @@ static int stm32_putc(struct rt_serial_device *serial, char c)
     RT_ASSERT(serial != RT_NULL);
 
     uart = rt_container_of(serial, struct stm32_uart, serial);
+
+#if UART_TX_RING_BUFSZ > 0
+    if (stm32_tx_ring_usable(uart))
+    {
+        rt_base_t level = rt_hw_interrupt_disable();
+
+        if ((rt_uint16_t)(uart->tx_ring.put_index - uart->tx_ring.get_index) == UART_TX_RING_BUFSZ)
+        {
+            if (serial->parent.open_flag & RT_DEVICE_FLAG_INT_TX)
+            {
+                /* the serial core waits for RT_SERIAL_EVENT_TX_DONE */
+                uart->tx_ring.waiting = RT_TRUE;
+                rt_hw_interrupt_enable(level);
+                return -1;
+            }
+
+            /* make room by sending the oldest byte right now */
+            stm32_tx_ring_poll(uart, 1);
+        }
+
+        uart->tx_ring.buffer[uart->tx_ring.put_index & (UART_TX_RING_BUFSZ - 1)] = c;
+        uart->tx_ring.put_index++;
+
+        if (__HAL_UART_GET_IT_SOURCE(&(uart->handle), UART_IT_TXE) == RESET)
+        {
+            __HAL_UART_ENABLE_IT(&(uart->handle), UART_IT_TXE);
+            NVIC_EnableIRQ(uart->config->irq_type);
+        }
+
+        rt_hw_interrupt_enable(level);
+        return 1;
+    }
+    else
+    {
+        /* polled output keeps the order with what is still queued */
+        rt_base_t level = rt_hw_interrupt_disable();
+        stm32_tx_ring_poll(uart, UART_TX_RING_BUFSZ);
+        rt_hw_interrupt_enable(level);
+    }
+#endif /* UART_TX_RING_BUFSZ > 0 */
+
+    while (__HAL_UART_GET_FLAG(&(uart->handle), UART_FLAG_TXE) == RESET);
     UART_INSTANCE_CLEAR_FUNCTION(&(uart->handle), UART_FLAG_TC);
-#if defined(SOC_SERIES_STM32L4) || defined(SOC_SERIES_STM32F7) || defined(SOC_SERIES_STM32F0) \
-    || defined(SOC_SERIES_STM32L0) || defined(SOC_SERIES_STM32G0) || defined(SOC_SERIES_STM32H7) \
-    || defined(SOC_SERIES_STM32G4)
-    uart->handle.Instance->TDR = c;
-#else
-    uart->handle.Instance->DR = c;
-#endif
+    UART_TX_DATA(uart) = c;
     while (__HAL_UART_GET_FLAG(&(uart->handle), UART_FLAG_TC) == RESET);
     return 1;
 }
@@ -541,7 +736,113 @@ static int stm32_getc(struct rt_serial_device *serial)
     return ch;
 }
 
-static rt_size_t stm32_dma_transmit(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction)
+#ifdef RT_SERIAL_USING_DMA
+/* start the transfer at the head of the queue if the DMA is idle */
+static void stm32_dma_tx_kick(struct stm32_uart *uart)
+{
+    struct rt_hw_uart_tx_desc *failed;
+    rt_base_t level;
+
+    do
+    {
+        failed = RT_NULL;
+
+        level = rt_hw_interrupt_disable();
+        if (uart->dma_tx.head != RT_NULL && !uart->dma_tx.active)
+        {
+            if (HAL_UART_Transmit_DMA(&uart->handle, (uint8_t *)uart->dma_tx.head->buffer,
+                                      uart->dma_tx.head->size) == HAL_OK)
+            {
+                uart->dma_tx.active = RT_TRUE;
+            }
+            else
+            {
+                failed = uart->dma_tx.head;
+                uart->dma_tx.head = failed->next;
+                if (uart->dma_tx.head == RT_NULL)
+                {
+                    uart->dma_tx.tail = RT_NULL;
+                }
+            }
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (failed != RT_NULL && failed->done != RT_NULL)
+        {
+            failed->done(failed, -RT_EIO);
+        }
+    } while (failed != RT_NULL);
+}
+
+static void stm32_dma_tx_enqueue(struct stm32_uart *uart, struct rt_hw_uart_tx_desc *desc)
+{
+    rt_base_t level;
+
+    desc->next = RT_NULL;
+
+    level = rt_hw_interrupt_disable();
+    if (uart->dma_tx.tail != RT_NULL)
+    {
+        uart->dma_tx.tail->next = desc;
+    }
+    else
+    {
+        uart->dma_tx.head = desc;
+    }
+    uart->dma_tx.tail = desc;
+    rt_hw_interrupt_enable(level);
+
+    stm32_dma_tx_kick(uart);
+}
+
+/* the transfer at the head is done, chain the next one before reporting it */
+static void stm32_dma_tx_done(struct stm32_uart *uart)
+{
+    struct rt_hw_uart_tx_desc *desc;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    desc = uart->dma_tx.head;
+    if (desc != RT_NULL)
+    {
+        uart->dma_tx.head = desc->next;
+        if (uart->dma_tx.head == RT_NULL)
+        {
+            uart->dma_tx.tail = RT_NULL;
+        }
+    }
+    uart->dma_tx.active = RT_FALSE;
+    rt_hw_interrupt_enable(level);
+
+    stm32_dma_tx_kick(uart);
+
+    if (desc != RT_NULL && desc->done != RT_NULL)
+    {
+        desc->done(desc, RT_EOK);
+    }
+}
+
+static void stm32_dma_tx_core_done(struct rt_hw_uart_tx_desc *desc, rt_err_t result)
+{
+    struct stm32_uart *uart = (struct stm32_uart *)desc->user_data;
+
+    if (result == RT_EOK)
+    {
+        rt_hw_serial_isr(&uart->serial, RT_SERIAL_EVENT_TX_DMADONE);
+    }
+    else if (uart->dma_tx.core_starting)
+    {
+        uart->dma_tx.core_result = result;
+    }
+    else
+    {
+        /* it failed to start after the submitted transfers queued before it */
+        rt_hw_serial_isr(&uart->serial, RT_SERIAL_EVENT_TX_DMAERR);
+    }
+}
+#endif /* RT_SERIAL_USING_DMA */
+
+static rt_ssize_t stm32_dma_transmit(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction)
 {
     struct stm32_uart *uart;
     RT_ASSERT(serial != RT_NULL);
@@ -552,17 +853,23 @@ static rt_size_t stm32_dma_transmit(struct rt_serial_device *serial, rt_uint8_t
         return 0;
     }
 
+#ifdef RT_SERIAL_USING_DMA
     if (RT_SERIAL_DMA_TX == direction)
     {
-        if (HAL_UART_Transmit_DMA(&uart->handle, buf, size) == HAL_OK)
-        {
-            return size;
-        }
-        else
-        {
-            return 0;
-        }
+        /* the serial core has one transfer in flight at most, it shares the queue with rt_hw_uart_tx_submit */
+        uart->dma_tx.core_desc.buffer = buf;
+        uart->dma_tx.core_desc.size = size;
+        uart->dma_tx.core_desc.done = stm32_dma_tx_core_done;
+        uart->dma_tx.core_desc.user_data = uart;
+        uart->dma_tx.core_result = RT_EOK;
+        uart->dma_tx.core_starting = RT_TRUE;
+        stm32_dma_tx_enqueue(uart, &uart->dma_tx.core_desc);
+        uart->dma_tx.core_starting = RT_FALSE;
+        return uart->dma_tx.core_result == RT_EOK ? (rt_ssize_t)size : uart->dma_tx.core_result;
     }
+#else
+    RT_UNUSED(uart);
+#endif
     return 0;
 }
 
@@ -575,6 +882,72 @@ static const struct rt_uart_ops stm32_uart_ops =
     .dma_transmit = stm32_dma_transmit
 };
 
+/**
+ * Get the bytes queued in the TX ring of an uart and not sent yet.
+ *
+ * @param dev the uart device
+ *
+ * @return the bytes queued, or -RT_ENOSYS if the device has no TX ring.
+ */
+rt_ssize_t rt_hw_uart_tx_pending(rt_device_t dev)
+{
+#if UART_TX_RING_BUFSZ > 0
+    struct rt_serial_device *serial = (struct rt_serial_device *)dev;
+    struct stm32_uart *uart;
+
+    RT_ASSERT(dev != RT_NULL);
+
+    if (serial->ops != &stm32_uart_ops)
+    {
+        return -RT_ENOSYS;
+    }
+
+    uart = rt_container_of(serial, struct stm32_uart, serial);
+    return (rt_uint16_t)(uart->tx_ring.put_index - uart->tx_ring.get_index);
+#else
+    RT_UNUSED(dev);
+    return -RT_ENOSYS;
+#endif /* UART_TX_RING_BUFSZ > 0 */
+}
+
+#ifdef RT_SERIAL_USING_DMA
+/* hand the received bytes to the serial core, or keep them for the borrower */
+static void stm32_dma_rx_done(struct stm32_uart *uart, rt_size_t recv_len)
+{
+    struct rt_serial_device *serial = &uart->serial;
+    rt_size_t pending;
+    rt_base_t level;
+
+    if (!uart->dma_rx.lend)
+    {
+        rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_DMADONE | (recv_len << 8));
+        return;
+    }
+
+    level = rt_hw_interrupt_disable();
+    uart->dma_rx.pending += recv_len;
+    if (uart->dma_rx.pending > serial->config.bufsz)
+    {
+        /* the DMA wrote over the data not released, drop all of it */
+        uart->dma_rx.overrun++;
+        uart->dma_rx.epoch++;
+        uart->dma_rx.read_index = uart->dma_rx.last_index % serial->config.bufsz;
+        uart->dma_rx.pending = 0;
+    }
+    pending = uart->dma_rx.pending;
+    rt_hw_interrupt_enable(level);
+
+    if (pending)
+    {
+        rt_completion_done(&uart->dma_rx.cpt);
+        if (serial->parent.rx_indicate != RT_NULL)
+        {
+            serial->parent.rx_indicate(&serial->parent, pending);
+        }
+    }
+}
+#endif /* RT_SERIAL_USING_DMA */
+
 /**
  * Uart common interrupt process. This need add to uart ISR.
  *
@@ -597,6 +970,14 @@ static void uart_isr(struct rt_serial_device *serial)
     {
         rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_IND);
     }
+#if UART_TX_RING_BUFSZ > 0
+    /* UART in mode Transmitter ----------------------------------------------*/
+    else if ((__HAL_UART_GET_FLAG(&(uart->handle), UART_FLAG_TXE) != RESET) &&
+            (__HAL_UART_GET_IT_SOURCE(&(uart->handle), UART_IT_TXE) != RESET))
+    {
+        stm32_tx_ring_isr(uart);
+    }
+#endif
 #ifdef RT_SERIAL_USING_DMA
     else if ((uart->uart_dma_flag) && (__HAL_UART_GET_FLAG(&(uart->handle), UART_FLAG_IDLE) != RESET)
              && (__HAL_UART_GET_IT_SOURCE(&(uart->handle), UART_IT_IDLE) != RESET))
@@ -609,7 +990,7 @@ static void uart_isr(struct rt_serial_device *serial)
 
         if (recv_len)
         {
-            rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_DMADONE | (recv_len << 8));
+            stm32_dma_rx_done(uart, recv_len);
         }
         __HAL_UART_CLEAR_IDLEFLAG(&uart->handle);
     }
@@ -698,7 +1079,7 @@ static void dma_isr(struct rt_serial_device *serial)
 
         if (recv_len)
         {
-            rt_hw_serial_isr(serial, RT_SERIAL_EVENT_RX_DMADONE | (recv_len << 8));
+            stm32_dma_rx_done(uart, recv_len);
         }
     }
 }
@@ -1193,7 +1574,231 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
     struct stm32_uart *uart;
     RT_ASSERT(huart != NULL);
     uart = (struct stm32_uart *)huart;
-    rt_hw_serial_isr(&uart->serial, RT_SERIAL_EVENT_TX_DMADONE);
+    stm32_dma_tx_done(uart);
+}
+
+/**
+ * Queue a buffer for the DMA transmitting of an uart, it returns at once. The
+ * transfers are chained from the transmit complete interrupt, so the buffers
+ * of several producers are sent back-to-back, in the order of submitting.
+ *
+ * @param dev the uart device, opened with RT_DEVICE_FLAG_DMA_TX
+ * @param desc the transfer, it and its buffer belong to the driver until
+ *        desc->done is called, from the interrupt context
+ *
+ * @return RT_EOK on success, -RT_EINVAL for an empty or too large (> 65535) buffer,
+ *         -RT_ENOSYS if the device does not transmit by DMA.
+ */
+rt_err_t rt_hw_uart_tx_submit(rt_device_t dev, struct rt_hw_uart_tx_desc *desc)
+{
+    struct rt_serial_device *serial = (struct rt_serial_device *)dev;
+
+    RT_ASSERT(dev != RT_NULL);
+    RT_ASSERT(desc != RT_NULL);
+
+    if (serial->ops != &stm32_uart_ops || !(dev->open_flag & RT_DEVICE_FLAG_DMA_TX))
+    {
+        return -RT_ENOSYS;
+    }
+
+    /* the HAL counts the transfer size on 16 bits */
+    if (desc->buffer == RT_NULL || desc->size == 0 || desc->size > 0xFFFF)
+    {
+        return -RT_EINVAL;
+    }
+
+    stm32_dma_tx_enqueue(rt_container_of(serial, struct stm32_uart, serial), desc);
+
+    return RT_EOK;
+}
+
+static struct stm32_uart *stm32_uart_dma_rx_get(rt_device_t dev)
+{
+    struct rt_serial_device *serial = (struct rt_serial_device *)dev;
+
+    RT_ASSERT(dev != RT_NULL);
+
+    if (serial->ops != &stm32_uart_ops || !(dev->open_flag & RT_DEVICE_FLAG_DMA_RX)
+        || serial->config.bufsz == 0)
+    {
+        return RT_NULL;
+    }
+
+    return rt_container_of(serial, struct stm32_uart, serial);
+}
+
+/**
+ * Switch the DMA receiving of an uart between the serial core FIFO and the
+ * buffer lending. The data not read yet is carried over in both directions.
+ *
+ * @param dev the uart device, opened with RT_DEVICE_FLAG_DMA_RX
+ * @param enable RT_TRUE to lend the DMA buffer, RT_FALSE to go back to rt_device_read
+ *
+ * @return RT_EOK on success, -RT_ENOSYS if the device does not receive by DMA into a FIFO.
+ */
+rt_err_t rt_hw_uart_rx_lend_mode(rt_device_t dev, rt_bool_t enable)
+{
+    struct stm32_uart *uart;
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t bufsz;
+    rt_base_t level;
+
+    uart = stm32_uart_dma_rx_get(dev);
+    if (uart == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+
+    rx_fifo = (struct rt_serial_rx_fifo *)uart->serial.serial_rx;
+    bufsz = uart->serial.config.bufsz;
+
+    level = rt_hw_interrupt_disable();
+    if (enable && !uart->dma_rx.lend)
+    {
+        uart->dma_rx.read_index = rx_fifo->get_index;
+        if (rx_fifo->put_index == rx_fifo->get_index)
+        {
+            uart->dma_rx.pending = rx_fifo->is_full ? bufsz : 0;
+        }
+        else
+        {
+            uart->dma_rx.pending = (rx_fifo->put_index + bufsz - rx_fifo->get_index) % bufsz;
+        }
+        uart->dma_rx.lent_epoch = uart->dma_rx.epoch;
+        rt_completion_init(&uart->dma_rx.cpt);
+        uart->dma_rx.lend = RT_TRUE;
+    }
+    else if (!enable && uart->dma_rx.lend)
+    {
+        rx_fifo->get_index = uart->dma_rx.read_index;
+        rx_fifo->put_index = uart->dma_rx.last_index % bufsz;
+        rx_fifo->is_full = (uart->dma_rx.pending == bufsz);
+        uart->dma_rx.lend = RT_FALSE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/**
+ * Borrow the received data in place, in the DMA buffer. The region starts at
+ * the first byte not released and is contiguous, so the data wrapping around
+ * the end of the buffer is lent by the next call, after a release.
+ *
+ * @param dev the uart device in lend mode
+ * @param buffer the start of the region lent
+ * @param timeout the time to wait for data
+ *
+ * @return the length of the region, or -RT_ETIMEOUT, -RT_ENOSYS.
+ */
+rt_ssize_t rt_hw_uart_rx_lend(rt_device_t dev, rt_uint8_t **buffer, rt_int32_t timeout)
+{
+    struct stm32_uart *uart;
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t bufsz, length;
+    rt_base_t level;
+    rt_err_t result;
+
+    RT_ASSERT(buffer != RT_NULL);
+
+    uart = stm32_uart_dma_rx_get(dev);
+    if (uart == RT_NULL || !uart->dma_rx.lend)
+    {
+        return -RT_ENOSYS;
+    }
+
+    rx_fifo = (struct rt_serial_rx_fifo *)uart->serial.serial_rx;
+    bufsz = uart->serial.config.bufsz;
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        length = uart->dma_rx.pending;
+        if (length)
+        {
+            if (length > bufsz - uart->dma_rx.read_index)
+            {
+                length = bufsz - uart->dma_rx.read_index;
+            }
+            *buffer = rx_fifo->buffer + uart->dma_rx.read_index;
+            uart->dma_rx.lent_epoch = uart->dma_rx.epoch;
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (length)
+        {
+            return length;
+        }
+
+        result = rt_completion_wait(&uart->dma_rx.cpt, timeout);
+        if (result != RT_EOK)
+        {
+            return result;
+        }
+    }
+}
+
+/**
+ * Give back the start of the region lent by rt_hw_uart_rx_lend, the DMA may
+ * then write over it.
+ *
+ * @param dev the uart device in lend mode
+ * @param size the bytes consumed, at most the length lent
+ *
+ * @return RT_EOK on success, -RT_EFULL if the DMA wrote over the region while
+ *         it was lent: the data parsed must be thrown away.
+ */
+rt_err_t rt_hw_uart_rx_release(rt_device_t dev, rt_size_t size)
+{
+    struct stm32_uart *uart;
+    rt_size_t bufsz, unreported;
+    rt_base_t level;
+    rt_err_t result = RT_EOK;
+
+    uart = stm32_uart_dma_rx_get(dev);
+    if (uart == RT_NULL || !uart->dma_rx.lend)
+    {
+        return -RT_ENOSYS;
+    }
+
+    bufsz = uart->serial.config.bufsz;
+
+    level = rt_hw_interrupt_disable();
+
+    /* the DMA may have passed the region before its interrupt reported it */
+    unreported = (bufsz - __HAL_DMA_GET_COUNTER(&(uart->dma_rx.handle)) + bufsz - uart->dma_rx.last_index) % bufsz;
+    if (uart->dma_rx.pending + unreported > bufsz)
+    {
+        uart->dma_rx.overrun++;
+        uart->dma_rx.epoch++;
+        uart->dma_rx.read_index = uart->dma_rx.last_index % bufsz;
+        uart->dma_rx.pending = 0;
+    }
+
+    if (uart->dma_rx.lent_epoch != uart->dma_rx.epoch)
+    {
+        result = -RT_EFULL;
+    }
+    else
+    {
+        RT_ASSERT(size <= uart->dma_rx.pending);
+        uart->dma_rx.read_index = (uart->dma_rx.read_index + size) % bufsz;
+        uart->dma_rx.pending -= size;
+    }
+
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+/**
+ * Get how many times the DMA wrote over the data not released.
+ */
+rt_uint32_t rt_hw_uart_rx_overrun(rt_device_t dev)
+{
+    struct stm32_uart *uart = stm32_uart_dma_rx_get(dev);
+
+    return uart ? uart->dma_rx.overrun : 0;
 }
 #endif  /* RT_SERIAL_USING_DMA */
 
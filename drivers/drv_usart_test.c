@@ -0,0 +1,468 @@
+/**
+ * @file drv_usart_test.c
+ * @brief 串口驱动发送环形缓冲、DMA接收借用和DMA发送队列测试文件
+ * @details 测试一个不是控制台的串口。环形缓冲和DMA发送部分只看发送，DMA接收借用部分需要把
+ *          该串口的TX和RX短接。没有对应功能时跳过该部分
+ * @author RT-Thread Team
+ * @date 2026-10-16
+ * @version 1.0.0
+ *
+ * @copyright Copyright (c) 2026 RT-Thread Development Team
+ *
+ * @par 修改日志:
+ * <table>
+ * <tr><th>日期       <th>版本  <th>作者     <th>说明
+ * <tr><td>2026-10-16 <td>1.0.0 <td>RT-Thread Team <td>首次创建
+ * </table>
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <board.h>
+
+#if defined(RT_USING_SERIAL) && defined(RT_USING_SERIAL_V1)
+
+#include "drv_usart.h"
+
+/**
+ * @defgroup USART_Test_Functions 串口驱动测试函数
+ * @{
+ */
+
+#define USART_TEST_TX_LEN       1024    /* 大于发送环形缓冲，多出的部分要轮询发送 */
+#define USART_TEST_DESC_NUM     4       /* 提交的DMA发送描述符个数 */
+
+static rt_uint8_t usart_test_text[USART_TEST_TX_LEN];
+
+/**
+ * @brief 填充发送的数据
+ * @note 可打印字符，每64字节一行，接到终端上也能看
+ */
+static void usart_test_fill(void)
+{
+    for (int i = 0; i < USART_TEST_TX_LEN; i++)
+    {
+        usart_test_text[i] = (i % 64 == 63) ? '\n' : '0' + i % 64 % 10;
+    }
+}
+
+/**
+ * @brief 计算发送若干字节需要的时间
+ * @param device 串口设备
+ * @param bytes 字节数
+ * @return rt_int32_t 毫秒数，留有余量
+ */
+static rt_int32_t usart_test_tx_ms(rt_device_t device, rt_size_t bytes)
+{
+    struct rt_serial_device *serial = (struct rt_serial_device *)device;
+
+    /* 每个字节10位 */
+    return bytes * 10 * 1000 / serial->config.baud_rate + 10;
+}
+
+/**
+ * @brief 发送环形缓冲测试
+ * @param device 串口设备
+ * @return rt_err_t 测试结果
+ * @note 覆盖环形缓冲满时轮询发送最早的字节，以及中断屏蔽时先发完排队的数据再轮询发送
+ */
+static rt_err_t usart_tx_ring_test(rt_device_t device)
+{
+    rt_ssize_t pending, queued;
+    rt_tick_t tick, least;
+    rt_base_t level;
+
+    rt_kprintf("[TEST] Starting TX ring test...\n");
+
+    if (rt_hw_uart_tx_pending(device) < 0)
+    {
+        rt_kprintf("[TEST] No TX ring: SKIP\n");
+        return RT_EOK;
+    }
+    if (rt_device_open(device, RT_DEVICE_OFLAG_RDWR) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Open %s failed!\n", device->parent.name);
+        return -RT_ERROR;
+    }
+
+    /* 环形缓冲满以后，每写一个字节先轮询发送最早的一个，不丢也不等中断 */
+    tick = rt_tick_get();
+    if (rt_device_write(device, 0, usart_test_text, USART_TEST_TX_LEN) != USART_TEST_TX_LEN)
+    {
+        rt_kprintf("[TEST] Write of %d bytes is short!\n", USART_TEST_TX_LEN);
+        goto _fail;
+    }
+    tick = rt_tick_get() - tick;
+    pending = rt_hw_uart_tx_pending(device);
+    if (pending <= 0 || pending >= USART_TEST_TX_LEN)
+    {
+        rt_kprintf("[TEST] %d bytes queued after the overflow!\n", (int)pending);
+        goto _fail;
+    }
+    least = rt_tick_from_millisecond(usart_test_tx_ms(device, USART_TEST_TX_LEN - pending) - 10);
+    if (tick + 1 < least)
+    {
+        rt_kprintf("[TEST] Overflow took %d ticks, the polled bytes need %d!\n", (int)tick, (int)least);
+        goto _fail;
+    }
+
+    /* TXE中断发完排队的数据 */
+    rt_thread_mdelay(usart_test_tx_ms(device, pending));
+    pending = rt_hw_uart_tx_pending(device);
+    if (pending != 0)
+    {
+        rt_kprintf("[TEST] %d bytes left in the ring!\n", (int)pending);
+        goto _fail;
+    }
+    rt_kprintf("[TEST] Ring overflow: PASS\n");
+
+    /* 中断屏蔽时TXE中断不能发送，排队的数据和新数据都轮询发送 */
+    rt_device_write(device, 0, usart_test_text, 16);
+    level = rt_hw_interrupt_disable();
+    queued = rt_hw_uart_tx_pending(device);
+    rt_device_write(device, 0, usart_test_text + 63, 1);
+    pending = rt_hw_uart_tx_pending(device);
+    rt_hw_interrupt_enable(level);
+    if (queued == 0 || pending != 0)
+    {
+        rt_kprintf("[TEST] Polled write with the interrupts masked: %d bytes queued before, %d after!\n",
+                   (int)queued, (int)pending);
+        goto _fail;
+    }
+    rt_kprintf("[TEST] Polled fallback: PASS\n");
+
+    rt_device_close(device);
+    return RT_EOK;
+
+_fail:
+    rt_device_close(device);
+    return -RT_ERROR;
+}
+
+#ifdef RT_SERIAL_USING_DMA
+/**
+ * @brief 借出接收到的数据并检查内容
+ * @param device 串口设备
+ * @param offset 期望的第一个字节在usart_test_text中的位置
+ * @param timeout 等待时间
+ * @return rt_ssize_t 借出的长度，出错时为负数
+ */
+static rt_ssize_t usart_test_lend(rt_device_t device, rt_size_t offset, rt_int32_t timeout)
+{
+    rt_uint8_t *buffer;
+    rt_ssize_t length;
+
+    length = rt_hw_uart_rx_lend(device, &buffer, timeout);
+    if (length < 0)
+    {
+        rt_kprintf("[TEST] Nothing received, is TX connected to RX?\n");
+        return length;
+    }
+    if (rt_memcmp(buffer, usart_test_text + offset, length) != 0)
+    {
+        rt_kprintf("[TEST] %d bytes lent, not the bytes sent!\n", (int)length);
+        return -RT_ERROR;
+    }
+
+    return length;
+}
+
+/**
+ * @brief 归还所有已经收到的数据
+ * @param device 串口设备
+ */
+static void usart_test_drain(rt_device_t device)
+{
+    rt_uint8_t *buffer;
+    rt_ssize_t length;
+
+    while ((length = rt_hw_uart_rx_lend(device, &buffer, 0)) > 0)
+    {
+        rt_hw_uart_rx_release(device, length);
+    }
+}
+
+/**
+ * @brief DMA接收借用测试
+ * @param device 串口设备，TX和RX短接
+ * @return rt_err_t 测试结果
+ * @note 覆盖借出和归还，以及借出期间DMA写过借出区域时归还返回-RT_EFULL
+ */
+static rt_err_t usart_rx_lend_test(rt_device_t device)
+{
+    struct rt_serial_device *serial = (struct rt_serial_device *)device;
+    rt_ssize_t length;
+    rt_uint32_t overrun;
+    rt_size_t bufsz;
+
+    rt_kprintf("[TEST] Starting DMA RX lend test...\n");
+
+    if (rt_device_open(device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_RX) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Open %s failed!\n", device->parent.name);
+        return -RT_ERROR;
+    }
+    if (rt_hw_uart_rx_lend_mode(device, RT_TRUE) != RT_EOK)
+    {
+        rt_kprintf("[TEST] No DMA RX: SKIP\n");
+        rt_device_close(device);
+        return RT_EOK;
+    }
+
+    bufsz = serial->config.bufsz;
+    if (2 * bufsz > USART_TEST_TX_LEN)
+    {
+        rt_kprintf("[TEST] RX buffer of %d bytes is too large: SKIP\n", (int)bufsz);
+        goto _pass;
+    }
+
+    /* 丢掉打开前收到的数据 */
+    usart_test_drain(device);
+
+    /* 借出和归还 */
+    rt_device_write(device, 0, usart_test_text, bufsz / 2);
+    rt_thread_mdelay(usart_test_tx_ms(device, bufsz / 2));
+    length = usart_test_lend(device, 0, RT_TICK_PER_SECOND / 10);
+    if (length <= 0)
+        goto _fail;
+    if (rt_hw_uart_rx_release(device, length) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Release of %d bytes failed!\n", (int)length);
+        goto _fail;
+    }
+    usart_test_drain(device);
+    rt_kprintf("[TEST] Lend and release: PASS\n");
+
+    /* 借出期间收到两倍缓冲的数据，DMA写过了借出的区域 */
+    rt_device_write(device, 0, usart_test_text, 4);
+    rt_thread_mdelay(usart_test_tx_ms(device, 4));
+    length = usart_test_lend(device, 0, RT_TICK_PER_SECOND / 10);
+    if (length <= 0)
+        goto _fail;
+    overrun = rt_hw_uart_rx_overrun(device);
+    rt_device_write(device, 0, usart_test_text, 2 * bufsz);
+    rt_thread_mdelay(usart_test_tx_ms(device, 2 * bufsz));
+    if (rt_hw_uart_rx_release(device, length) != -RT_EFULL)
+    {
+        rt_kprintf("[TEST] Release after the overrun does not return -RT_EFULL!\n");
+        goto _fail;
+    }
+    if (rt_hw_uart_rx_overrun(device) == overrun)
+    {
+        rt_kprintf("[TEST] Overrun is not counted!\n");
+        goto _fail;
+    }
+
+    /* 丢掉覆盖以后剩下的数据，之后收到的数据照常借出 */
+    usart_test_drain(device);
+    rt_device_write(device, 0, usart_test_text, 8);
+    rt_thread_mdelay(usart_test_tx_ms(device, 8));
+    length = usart_test_lend(device, 0, RT_TICK_PER_SECOND / 10);
+    if (length <= 0)
+        goto _fail;
+    if (rt_hw_uart_rx_release(device, length) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Release after the overrun failed!\n");
+        goto _fail;
+    }
+    rt_kprintf("[TEST] Release after overrun: PASS\n");
+
+_pass:
+    rt_hw_uart_rx_lend_mode(device, RT_FALSE);
+    rt_device_close(device);
+    return RT_EOK;
+
+_fail:
+    rt_hw_uart_rx_lend_mode(device, RT_FALSE);
+    rt_device_close(device);
+    return -RT_ERROR;
+}
+
+static struct rt_hw_uart_tx_desc usart_test_desc[USART_TEST_DESC_NUM];
+static int usart_test_done_index[USART_TEST_DESC_NUM];
+static rt_err_t usart_test_done_result[USART_TEST_DESC_NUM];
+static volatile int usart_test_done_count;
+static struct rt_semaphore usart_test_done_sem;
+
+static void usart_test_tx_done(struct rt_hw_uart_tx_desc *desc, rt_err_t result)
+{
+    int count = usart_test_done_count;
+
+    if (count < USART_TEST_DESC_NUM)
+    {
+        usart_test_done_index[count] = (int)(rt_ubase_t)desc->user_data;
+        usart_test_done_result[count] = result;
+    }
+    usart_test_done_count = count + 1;
+    if (count + 1 == USART_TEST_DESC_NUM)
+    {
+        rt_sem_release(&usart_test_done_sem);
+    }
+}
+
+/**
+ * @brief DMA发送队列测试
+ * @param device 串口设备
+ * @return rt_err_t 测试结果
+ * @note 连续提交几个描述符，中间夹一次串口框架的DMA写，检查完成回调的顺序和结果
+ */
+static rt_err_t usart_tx_submit_test(rt_device_t device)
+{
+    static const rt_size_t sizes[USART_TEST_DESC_NUM] = {1, 16, 100, 300};
+    rt_size_t offset = 0, total = 0;
+    rt_err_t result = RT_EOK;
+    int i;
+
+    rt_kprintf("[TEST] Starting DMA TX submit test...\n");
+
+    if (rt_device_open(device, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_TX) != RT_EOK)
+    {
+        rt_kprintf("[TEST] Open %s failed!\n", device->parent.name);
+        return -RT_ERROR;
+    }
+
+    usart_test_desc[0].buffer = usart_test_text;
+    usart_test_desc[0].size = 0;
+    result = rt_hw_uart_tx_submit(device, &usart_test_desc[0]);
+    if (result == -RT_ENOSYS)
+    {
+        rt_kprintf("[TEST] No DMA TX: SKIP\n");
+        rt_device_close(device);
+        return RT_EOK;
+    }
+    if (result != -RT_EINVAL)
+    {
+        rt_kprintf("[TEST] Empty descriptor is not refused!\n");
+        rt_device_close(device);
+        return -RT_ERROR;
+    }
+
+    rt_sem_init(&usart_test_done_sem, "ustest", 0, RT_IPC_FLAG_PRIO);
+    usart_test_done_count = 0;
+
+    for (i = 0; i < USART_TEST_DESC_NUM; i++)
+    {
+        usart_test_desc[i].buffer = usart_test_text + offset;
+        usart_test_desc[i].size = sizes[i];
+        usart_test_desc[i].done = usart_test_tx_done;
+        usart_test_desc[i].user_data = (void *)(rt_ubase_t)i;
+        offset += sizes[i];
+        total += sizes[i];
+
+        if (rt_hw_uart_tx_submit(device, &usart_test_desc[i]) != RT_EOK)
+        {
+            rt_kprintf("[TEST] Submit of descriptor %d failed!\n", i);
+            result = -RT_ERROR;
+            goto _exit;
+        }
+
+        /* 串口框架的DMA写和提交的描述符共用一个队列 */
+        if (i == 1)
+        {
+            if (rt_device_write(device, 0, usart_test_text + offset, 64) != 64)
+            {
+                rt_kprintf("[TEST] DMA write between the descriptors failed!\n");
+                result = -RT_ERROR;
+                goto _exit;
+            }
+            offset += 64;
+            total += 64;
+        }
+    }
+
+    if (rt_sem_take(&usart_test_done_sem, rt_tick_from_millisecond(usart_test_tx_ms(device, total))) != RT_EOK)
+    {
+        rt_kprintf("[TEST] %d of %d descriptors done!\n", usart_test_done_count, USART_TEST_DESC_NUM);
+        result = -RT_ERROR;
+        goto _exit;
+    }
+    for (i = 0; i < USART_TEST_DESC_NUM; i++)
+    {
+        if (usart_test_done_index[i] != i || usart_test_done_result[i] != RT_EOK)
+        {
+            rt_kprintf("[TEST] Done callback %d is for descriptor %d, result %d!\n",
+                       i, usart_test_done_index[i], (int)usart_test_done_result[i]);
+            result = -RT_ERROR;
+            goto _exit;
+        }
+    }
+    rt_kprintf("[TEST] Descriptor chain: PASS\n");
+
+_exit:
+    /* 出错时等还在队列里的描述符发完再关闭 */
+    if (result != RT_EOK)
+    {
+        rt_thread_mdelay(usart_test_tx_ms(device, total));
+    }
+    rt_sem_detach(&usart_test_done_sem);
+    rt_device_close(device);
+    return result;
+}
+#endif /* RT_SERIAL_USING_DMA */
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup USART_MSH_Commands 串口驱动MSH命令接口
+ * @{
+ */
+
+/**
+ * @brief 串口驱动测试MSH命令
+ * @param argc 参数个数
+ * @param argv 参数列表，argv[1]为要测试的串口名，不能是控制台
+ */
+static void usart_test(int argc, char **argv)
+{
+    rt_device_t device;
+    rt_err_t result = RT_EOK;
+
+    if (argc != 2)
+    {
+        rt_kprintf("Please input: usart_test <uart name>\n");
+        return;
+    }
+
+    device = rt_device_find(argv[1]);
+    if (device == RT_NULL || device->type != RT_Device_Class_Char)
+    {
+        rt_kprintf("%s is not a serial device\n", argv[1]);
+        return;
+    }
+    if (device->ref_count != 0)
+    {
+        rt_kprintf("%s is in use, choose a UART other than the console\n", argv[1]);
+        return;
+    }
+
+    rt_kprintf("\n=== USART Driver Test ===\n");
+
+    usart_test_fill();
+    if (usart_tx_ring_test(device) != RT_EOK)
+        result = -RT_ERROR;
+#ifdef RT_SERIAL_USING_DMA
+    if (usart_rx_lend_test(device) != RT_EOK)
+        result = -RT_ERROR;
+    if (usart_tx_submit_test(device) != RT_EOK)
+        result = -RT_ERROR;
+#endif
+
+    if (result == RT_EOK)
+    {
+        rt_kprintf("=== All USART Tests PASSED ===\n");
+    }
+    else
+    {
+        rt_kprintf("=== USART Test FAILED ===\n");
+    }
+}
+
+MSH_CMD_EXPORT(usart_test, USART driver TX ring and DMA test);
+
+/**
+ * @}
+ */
+
+#endif /* RT_USING_SERIAL && RT_USING_SERIAL_V1 */
@@ -37,6 +37,18 @@ extern "C" {
        .Init.Overrun               = ADC_OVR_DATA_OVERWRITTEN,      \
     }
 #endif /* ADC1_CONFIG */
+
+#if defined(BSP_ADC1_USING_DMA)
+#ifndef ADC1_DMA_CONFIG
+#define ADC1_DMA_CONFIG                                             \
+    {                                                               \
+        .Instance = ADC1_DMA_INSTANCE,                              \
+        .request  = ADC1_DMA_REQUEST,                               \
+        .dma_rcc  = ADC1_DMA_RCC,                                   \
+        .dma_irq  = ADC1_DMA_IRQ,                                   \
+    }
+#endif /* ADC1_DMA_CONFIG */
+#endif /* BSP_ADC1_USING_DMA */
 #endif /* BSP_USING_ADC1 */
 
 #ifdef BSP_USING_ADC2
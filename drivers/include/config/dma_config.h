@@ -20,6 +20,17 @@ extern "C" {
 #endif
 
 /* DMA1 channel1 */
+#if defined(BSP_ADC1_USING_DMA) && !defined(ADC1_DMA_INSTANCE)
+#define ADC1_DMA_IRQHandler             DMA1_Channel1_IRQHandler
+#define ADC1_DMA_RCC                    RCC_AHB1ENR_DMA1EN
+#define ADC1_DMA_INSTANCE               DMA1_Channel1
+#if defined(DMAMUX1) /* for L4+ */
+#define ADC1_DMA_REQUEST                DMA_REQUEST_ADC1
+#else /* for L4 */
+#define ADC1_DMA_REQUEST                DMA_REQUEST_0
+#endif /* DMAMUX1 */
+#define ADC1_DMA_IRQ                    DMA1_Channel1_IRQn
+#endif
 
 /* DMA1 channel2 */
 #if defined(BSP_SPI1_RX_USING_DMA) && !defined(SPI1_RX_DMA_INSTANCE)
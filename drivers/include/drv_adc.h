@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    first version
+ */
+
+#ifndef __DRV_ADC_H__
+#define __DRV_ADC_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#ifdef BSP_ADC_USING_DECIMATION
+struct rt_hw_adc_decimate_config
+{
+    rt_uint8_t factor;                  /* the output rate is the sequence rate / factor */
+    rt_uint16_t num_taps;
+    const float *coeffs;                /* FIR coefficients in time reversed order, as CMSIS-DSP arm_fir_decimate_f32() takes them */
+};
+
+/* a decimated frame, interleaved by sequence as struct rt_adc_frame */
+struct rt_hw_adc_decimated_frame
+{
+    const float *samples;
+    rt_uint16_t length;                 /* output sequences in the frame */
+    rt_uint8_t channel_count;
+    rt_uint32_t sequence;               /* the input frame number */
+    rt_uint64_t timestamp;
+};
+
+typedef void (*rt_hw_adc_decimated_cb_t)(rt_adc_device_t dev, const struct rt_hw_adc_decimated_frame *frame, void *user_data);
+
+rt_err_t rt_hw_adc_decimate_start(rt_adc_device_t dev, const struct rt_adc_scan_config *cfg,
+                                  const struct rt_hw_adc_decimate_config *dcfg,
+                                  rt_hw_adc_decimated_cb_t callback, void *user_data);
+rt_err_t rt_hw_adc_decimate_stop(rt_adc_device_t dev);
+#endif /* BSP_ADC_USING_DECIMATION */
+
+#endif /* __DRV_ADC_H__ */
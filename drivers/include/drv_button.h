@@ -20,6 +20,7 @@
 
 #include <rtthread.h>
 #include <rtdevice.h>
+#include <board.h>
 #include "button.h"
 
 #ifdef __cplusplus
@@ -66,6 +67,15 @@ typedef enum
 #define BUTTON_KEY5_NAME    "key5"  /**< 按键5名称 */
 #define BUTTON_KEY6_NAME    "key6"  /**< 按键6名称 */
 
+/*
+ * 默认为轮询模式。在board.h中定义BSP_BUTTON_USING_IRQ_SCAN后为中断扫描模式：
+ * 按键下降沿中断启动去抖定时器，全部按键释放并空闲后定时器停止，无需周期调用drv_button_process()
+ */
+#ifdef BSP_BUTTON_USING_IRQ_SCAN
+#define BUTTON_SCAN_PERIOD_MS       5   /**< 去抖采样周期(ms)，连续4次采样一致才确认状态 */
+#define BUTTON_PROCESS_PERIOD_MS    20  /**< Button_Process()调用周期(ms) */
+#endif /* BSP_BUTTON_USING_IRQ_SCAN */
+
 /**
  * @}
  */
@@ -112,8 +122,9 @@ rt_err_t drv_button_deinit(void);
 
 /**
  * @brief 按键状态处理函数
- * @note 该函数需要在定时器或线程中周期性调用，建议调用周期为20-50ms
- * @warning 必须周期性调用此函数，否则按键事件无法正常检测
+ * @note 轮询模式下该函数需要在定时器或线程中周期性调用，建议调用周期为20-50ms。
+ *       定义BSP_BUTTON_USING_IRQ_SCAN时扫描由按键中断驱动，该函数直接返回
+ * @warning 轮询模式下必须周期性调用此函数，否则按键事件无法正常检测
  * 
  * @par 示例:
  * @code
@@ -145,6 +156,25 @@ void drv_button_process(void);
  */
 Button_t* drv_button_get_handle(const char *key_name);
 
+/**
+ * @brief 根据按键序号获取按键实体指针
+ * @param key 按键序号
+ * @return Button_t* 按键实体指针
+ * @retval 非NULL 成功获取按键实体指针
+ * @retval NULL 按键序号无效
+ * @note 不做字符串比较，适合在回调等频繁调用的场合使用
+ *
+ * @par 示例:
+ * @code
+ * Button_t *btn = drv_button_get_handle_by_index(BUTTON_KEY1);
+ * if (Get_Button_State(btn) == BUTTON_DOWM)
+ * {
+ *     rt_kprintf("Key1 is pressed\n");
+ * }
+ * @endcode
+ */
+Button_t* drv_button_get_handle_by_index(button_key_t key);
+
 /**
  * @brief 获取按键当前状态
  * @param key_name 按键名称字符串
@@ -30,6 +30,9 @@ void _Error_Handler(char *s, int num);
 
 #define __STM32_PORT(port)  GPIO##port##_BASE
 #define GET_PIN(PORTx,PIN) (rt_base_t)((16 * ( ((rt_base_t)__STM32_PORT(PORTx) - (rt_base_t)GPIOA_BASE)/(0x0400UL) )) + PIN)
+/* port number and port bit of a pin, for rt_pin_port_read()/rt_pin_port_write() */
+#define PIN_PORT(pin)       ((rt_base_t)(pin) >> 4)
+#define PIN_MASK(pin)       (1UL << ((rt_base_t)(pin) & 0x0F))
 #define STM32_FLASH_START_ADRESS       ROM_START
 #define STM32_FLASH_SIZE               ROM_SIZE
 #define STM32_FLASH_END_ADDRESS        ROM_END
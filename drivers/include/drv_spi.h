@@ -57,6 +57,8 @@ struct stm32_spi
     
     rt_uint8_t spi_dma_flag;
     struct rt_spi_bus spi_bus;
+
+    struct rt_completion cpt;
 };
 
 #endif /*__DRV_SPI_H_ */
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    first version
+ */
+
+#ifndef __DRV_USART_H__
+#define __DRV_USART_H__
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+/* the bytes queued in the interrupt driven TX ring */
+rt_ssize_t rt_hw_uart_tx_pending(rt_device_t dev);
+
+#ifdef RT_SERIAL_USING_DMA
+/* a buffer queued for the DMA transmitting */
+struct rt_hw_uart_tx_desc
+{
+    const rt_uint8_t *buffer;
+    rt_size_t size;
+    void (*done)(struct rt_hw_uart_tx_desc *desc, rt_err_t result);
+    void *user_data;
+
+    struct rt_hw_uart_tx_desc *next;    /* used by the driver */
+};
+
+rt_err_t rt_hw_uart_tx_submit(rt_device_t dev, struct rt_hw_uart_tx_desc *desc);
+
+/* zero-copy receiving from the circular DMA buffer of an uart opened with RT_DEVICE_FLAG_DMA_RX */
+rt_err_t rt_hw_uart_rx_lend_mode(rt_device_t dev, rt_bool_t enable);
+rt_ssize_t rt_hw_uart_rx_lend(rt_device_t dev, rt_uint8_t **buffer, rt_int32_t timeout);
+rt_err_t rt_hw_uart_rx_release(rt_device_t dev, rt_size_t size);
+rt_uint32_t rt_hw_uart_rx_overrun(rt_device_t dev);
+#endif
+
+#endif /* __DRV_USART_H__ */
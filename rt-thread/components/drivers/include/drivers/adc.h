@@ -20,18 +20,73 @@
 #define RT_ADC_INTERN_CH_VBAT       (-3)
 
 struct rt_adc_device;
+
+#ifdef RT_ADC_USING_SCAN
+#ifndef RT_ADC_SCAN_CHANNEL_MAX
+#define RT_ADC_SCAN_CHANNEL_MAX     8
+#endif
+
+struct rt_adc_scan_config
+{
+    rt_int8_t channel[RT_ADC_SCAN_CHANNEL_MAX]; /* the conversion sequence */
+    rt_uint8_t channel_count;
+    rt_uint32_t frequency;                      /* sequences per second */
+    rt_uint16_t length;                         /* sequences per frame */
+};
+
+/* a frame of samples, interleaved by sequence: s0c0, s0c1, ..., s1c0, ... */
+struct rt_adc_frame
+{
+    const rt_uint16_t *samples;
+    rt_uint16_t length;                         /* sequences in the frame */
+    rt_uint8_t channel_count;
+    rt_uint32_t sequence;                       /* frame number since the scan started */
+    rt_uint64_t timestamp;                      /* at the end of the frame, cputime or OS tick */
+};
+
+typedef void (*rt_adc_frame_cb_t)(struct rt_adc_device *device, const struct rt_adc_frame *frame, void *user_data);
+
+struct rt_adc_scan
+{
+    rt_uint16_t *buffer;                        /* two frames, filled in turn by the driver */
+    rt_size_t frame_size;                       /* samples in a frame */
+    rt_uint16_t length;
+    rt_uint8_t channel_count;
+    rt_bool_t running;
+
+    volatile rt_uint32_t sequence;              /* frames completed, frame n is in buffer half n % 2 */
+    rt_uint64_t timestamp[2];
+    rt_uint32_t read_sequence;                  /* next frame of rt_adc_scan_read() */
+    rt_uint32_t lost;                           /* frames overwritten before they were read */
+
+    rt_adc_frame_cb_t callback;
+    void *user_data;
+    struct rt_completion cpt;
+    struct rt_mutex lock;                       /* serializes start, stop and the copy of the reader */
+};
+#endif /* RT_ADC_USING_SCAN */
+
 struct rt_adc_ops
 {
     rt_err_t (*enabled)(struct rt_adc_device *device, rt_int8_t channel, rt_bool_t enabled);
     rt_err_t (*convert)(struct rt_adc_device *device, rt_int8_t channel, rt_uint32_t *value);
     rt_uint8_t (*get_resolution)(struct rt_adc_device *device);
     rt_int16_t (*get_vref) (struct rt_adc_device *device);
+    rt_err_t (*control)(struct rt_adc_device *device, int cmd, void *args);
+#ifdef RT_ADC_USING_SCAN
+    /* fill the buffer of two frames circularly, calling rt_hw_adc_scan_isr() when a half is full */
+    rt_err_t (*scan_start)(struct rt_adc_device *device, const struct rt_adc_scan_config *cfg, rt_uint16_t *buffer);
+    rt_err_t (*scan_stop)(struct rt_adc_device *device);
+#endif
 };
 
 struct rt_adc_device
 {
     struct rt_device parent;
     const struct rt_adc_ops *ops;
+#ifdef RT_ADC_USING_SCAN
+    struct rt_adc_scan scan;
+#endif
 };
 typedef struct rt_adc_device *rt_adc_device_t;
 
@@ -41,12 +96,29 @@ typedef enum
     RT_ADC_CMD_DISABLE = RT_DEVICE_CTRL_BASE(ADC) + 2,
     RT_ADC_CMD_GET_RESOLUTION = RT_DEVICE_CTRL_BASE(ADC) + 3, /* get the resolution in bits */
     RT_ADC_CMD_GET_VREF = RT_DEVICE_CTRL_BASE(ADC) + 4, /* get reference voltage */
+    RT_ADC_CMD_SET_OVERSAMPLING = RT_DEVICE_CTRL_BASE(ADC) + 5, /* set the hardware oversampling of a channel */
 } rt_adc_cmd_t;
 
+/* argument of RT_ADC_CMD_SET_OVERSAMPLING, a value is the sum of ratio conversions shifted right by shift */
+struct rt_adc_oversampling
+{
+    rt_int8_t channel;
+    rt_uint16_t ratio;                          /* 1 to disable */
+    rt_uint8_t shift;
+};
+
 rt_err_t rt_hw_adc_register(rt_adc_device_t adc,const char *name, const struct rt_adc_ops *ops, const void *user_data);
 rt_uint32_t rt_adc_read(rt_adc_device_t dev, rt_int8_t channel);
 rt_err_t rt_adc_enable(rt_adc_device_t dev, rt_int8_t channel);
 rt_err_t rt_adc_disable(rt_adc_device_t dev, rt_int8_t channel);
 rt_int16_t rt_adc_voltage(rt_adc_device_t dev, rt_int8_t channel);
 
+#ifdef RT_ADC_USING_SCAN
+rt_err_t rt_adc_scan_start(rt_adc_device_t dev, const struct rt_adc_scan_config *cfg,
+                           rt_adc_frame_cb_t callback, void *user_data);
+rt_err_t rt_adc_scan_stop(rt_adc_device_t dev);
+rt_err_t rt_adc_scan_read(rt_adc_device_t dev, struct rt_adc_frame *frame, rt_uint16_t *samples, rt_int32_t timeout);
+void rt_hw_adc_scan_isr(rt_adc_device_t dev, int half);
+#endif
+
 #endif /* __ADC_H__ */
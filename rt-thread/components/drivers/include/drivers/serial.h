@@ -71,6 +71,7 @@
 #define RT_SERIAL_EVENT_RX_DMADONE      0x03    /* Rx DMA transfer done */
 #define RT_SERIAL_EVENT_TX_DMADONE      0x04    /* Tx DMA transfer done */
 #define RT_SERIAL_EVENT_RX_TIMEOUT      0x05    /* Rx timeout    */
+#define RT_SERIAL_EVENT_TX_DMAERR       0x06    /* Tx DMA transfer not started */
 
 #define RT_SERIAL_DMA_RX                0x01
 #define RT_SERIAL_DMA_TX                0x02
@@ -132,9 +133,13 @@ struct rt_serial_rx_fifo
     /* software fifo */
     rt_uint8_t *buffer;
 
+    /* in interrupt mode, put_index is only written by the ISR and get_index by the reader */
     rt_uint16_t put_index, get_index;
 
     rt_bool_t is_full;
+
+    /* serializes the readers of an interrupt mode fifo, never taken by the ISR */
+    struct rt_spinlock rx_lock;
 };
 
 struct rt_serial_tx_fifo
@@ -101,7 +101,8 @@ static unsigned long _cnt_convert(unsigned long cnt)
     if (count > (_HRTIMER_MAX_CNT / 2))
         return 0;
 
-    rtn = (count * rt_ktime_cputimer_getres()) / rt_ktime_hrtimer_getres();
+    /* 64 bits product, the resolutions are scaled by RT_KTIME_RESMUL */
+    rtn = (unsigned long)(((rt_uint64_t)count * rt_ktime_cputimer_getres()) / rt_ktime_hrtimer_getres());
     return rtn == 0 ? 1 : rtn; /* at least 1 */
 }
 
@@ -378,7 +379,7 @@ rt_err_t rt_ktime_hrtimer_sleep(unsigned long cnt)
 rt_err_t rt_ktime_hrtimer_ndelay(unsigned long ns)
 {
     unsigned long res = rt_ktime_cputimer_getres();
-    return rt_ktime_hrtimer_sleep((ns * RT_KTIME_RESMUL) / res);
+    return rt_ktime_hrtimer_sleep((unsigned long)(((rt_uint64_t)ns * RT_KTIME_RESMUL) / res));
 }
 
 rt_err_t rt_ktime_hrtimer_udelay(unsigned long us)
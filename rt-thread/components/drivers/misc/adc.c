@@ -16,6 +16,10 @@
 #include <string.h>
 #include <stdlib.h>
 
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
 #define DBG_TAG "adc"
 #define DBG_LVL DBG_INFO
 #include <rtdbg.h>
@@ -72,6 +76,10 @@ static rt_err_t _adc_control(rt_device_t dev, int cmd, void *args)
             result = RT_EOK;
         }
     }
+    else if (cmd == RT_ADC_CMD_SET_OVERSAMPLING && adc->ops->control && args)
+    {
+        result = adc->ops->control(adc, cmd, args);
+    }
 
     return result;
 }
@@ -109,6 +117,9 @@ rt_err_t rt_hw_adc_register(rt_adc_device_t device, const char *name, const stru
 #endif
     device->ops = ops;
     device->parent.user_data = (void *)user_data;
+#ifdef RT_ADC_USING_SCAN
+    rt_mutex_init(&device->scan.lock, "adcscan", RT_IPC_FLAG_PRIO);
+#endif
 
     result = rt_device_register(&device->parent, name, RT_DEVICE_FLAG_RDWR);
 
@@ -190,6 +201,252 @@ _voltage_exit:
     return voltage;
 }
 
+#ifdef RT_ADC_USING_SCAN
+static rt_uint64_t _adc_scan_timestamp(void)
+{
+#ifdef RT_USING_CPUTIME
+    /* fall back to OS tick when there is no cputime ops */
+    if (clock_cpu_getres() != 0)
+    {
+        return clock_cpu_gettime();
+    }
+#endif
+    return rt_tick_get();
+}
+
+/**
+ * @brief Start the scan mode. The ADC converts the channel sequence at the
+ *        given frequency and delivers the samples by frames of cfg->length
+ *        sequences, through the callback and rt_adc_scan_read().
+ *
+ * @param dev the ADC device
+ * @param cfg the scan configuration
+ * @param callback called from the interrupt context for each frame, or RT_NULL.
+ *        The samples are valid until the next frame is complete.
+ * @param user_data the parameter of the callback
+ *
+ * @return RT_EOK on success, -RT_ENOSYS if the driver can not scan,
+ *         -RT_EBUSY if the scan is running, -RT_EINVAL or -RT_ENOMEM.
+ */
+rt_err_t rt_adc_scan_start(rt_adc_device_t dev, const struct rt_adc_scan_config *cfg,
+                           rt_adc_frame_cb_t callback, void *user_data)
+{
+    struct rt_adc_scan *scan;
+    rt_err_t result;
+
+    RT_ASSERT(dev);
+    RT_ASSERT(cfg);
+
+    scan = &dev->scan;
+
+    if (dev->ops->scan_start == RT_NULL || dev->ops->scan_stop == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+
+    if (cfg->channel_count == 0 || cfg->channel_count > RT_ADC_SCAN_CHANNEL_MAX ||
+        cfg->frequency == 0 || cfg->length == 0)
+    {
+        return -RT_EINVAL;
+    }
+
+    rt_mutex_take(&scan->lock, RT_WAITING_FOREVER);
+    if (scan->running)
+    {
+        rt_mutex_release(&scan->lock);
+        return -RT_EBUSY;
+    }
+
+    scan->frame_size = (rt_size_t)cfg->length * cfg->channel_count;
+    scan->buffer = (rt_uint16_t *)rt_malloc(scan->frame_size * 2 * sizeof(rt_uint16_t));
+    if (scan->buffer == RT_NULL)
+    {
+        rt_mutex_release(&scan->lock);
+        return -RT_ENOMEM;
+    }
+
+    scan->length = cfg->length;
+    scan->channel_count = cfg->channel_count;
+    scan->sequence = 0;
+    scan->read_sequence = 0;
+    scan->lost = 0;
+    scan->callback = callback;
+    scan->user_data = user_data;
+    rt_completion_init(&scan->cpt);
+
+    /* the first half may complete before scan_start returns */
+    scan->running = RT_TRUE;
+    result = dev->ops->scan_start(dev, cfg, scan->buffer);
+    if (result != RT_EOK)
+    {
+        scan->running = RT_FALSE;
+        rt_free(scan->buffer);
+        scan->buffer = RT_NULL;
+    }
+    rt_mutex_release(&scan->lock);
+
+    return result;
+}
+
+/**
+ * @brief Stop the scan mode, a reader blocked in rt_adc_scan_read() returns -RT_EIO.
+ *
+ * @param dev the ADC device
+ *
+ * @return RT_EOK on success, or the error of the driver.
+ */
+rt_err_t rt_adc_scan_stop(rt_adc_device_t dev)
+{
+    struct rt_adc_scan *scan;
+    rt_err_t result;
+
+    RT_ASSERT(dev);
+
+    scan = &dev->scan;
+    /* a reader copying a frame holds the lock, the buffer is freed after it */
+    rt_mutex_take(&scan->lock, RT_WAITING_FOREVER);
+    if (!scan->running)
+    {
+        rt_mutex_release(&scan->lock);
+        return RT_EOK;
+    }
+
+    result = dev->ops->scan_stop(dev);
+    if (result != RT_EOK)
+    {
+        rt_mutex_release(&scan->lock);
+        return result;
+    }
+
+    scan->running = RT_FALSE;
+    rt_completion_done(&scan->cpt);
+
+    rt_free(scan->buffer);
+    scan->buffer = RT_NULL;
+    rt_mutex_release(&scan->lock);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief Wait for the next frame of the scan and copy it. The frames the
+ *        driver has overwritten before they could be read are skipped and
+ *        counted in dev->scan.lost. There is one reader at most.
+ *
+ * @param dev the ADC device
+ * @param frame the information of the frame, frame->samples is set to samples
+ * @param samples the buffer of the cfg->length * cfg->channel_count samples
+ * @param timeout the waiting time for a frame
+ *
+ * @return RT_EOK on success, -RT_ETIMEOUT, or -RT_EIO if the scan is stopped.
+ */
+rt_err_t rt_adc_scan_read(rt_adc_device_t dev, struct rt_adc_frame *frame, rt_uint16_t *samples, rt_int32_t timeout)
+{
+    struct rt_adc_scan *scan;
+    rt_uint32_t sequence, index;
+    rt_uint64_t timestamp;
+    rt_err_t result;
+
+    RT_ASSERT(dev);
+    RT_ASSERT(frame);
+    RT_ASSERT(samples);
+
+    scan = &dev->scan;
+
+    while (1)
+    {
+        rt_mutex_take(&scan->lock, RT_WAITING_FOREVER);
+        if (!scan->running)
+        {
+            rt_mutex_release(&scan->lock);
+            return -RT_EIO;
+        }
+
+        sequence = scan->sequence;
+        if (sequence == scan->read_sequence)
+        {
+            rt_mutex_release(&scan->lock);
+            result = rt_completion_wait(&scan->cpt, timeout);
+            if (result != RT_EOK)
+            {
+                return result;
+            }
+            continue;
+        }
+
+        /* only the last complete frame is intact, the driver fills the other half */
+        if (sequence - scan->read_sequence > 1)
+        {
+            scan->lost += sequence - scan->read_sequence - 1;
+            scan->read_sequence = sequence - 1;
+        }
+
+        index = scan->read_sequence;
+        timestamp = scan->timestamp[index & 1];
+        rt_memcpy(samples, scan->buffer + (index & 1) * scan->frame_size, scan->frame_size * sizeof(rt_uint16_t));
+        scan->read_sequence = index + 1;
+
+        /* the driver came back to this half while it was copied */
+        if (scan->sequence - index > 1)
+        {
+            scan->lost++;
+            rt_mutex_release(&scan->lock);
+            continue;
+        }
+
+        frame->samples = samples;
+        frame->length = scan->length;
+        frame->channel_count = scan->channel_count;
+        frame->sequence = index;
+        frame->timestamp = timestamp;
+        rt_mutex_release(&scan->lock);
+
+        return RT_EOK;
+    }
+}
+
+/**
+ * @brief Report a full half of the scan buffer, called by the driver from
+ *        the interrupt context.
+ *
+ * @param dev the ADC device
+ * @param half 0 for the first half of the buffer, 1 for the second one
+ */
+void rt_hw_adc_scan_isr(rt_adc_device_t dev, int half)
+{
+    struct rt_adc_scan *scan = &dev->scan;
+    struct rt_adc_frame frame;
+    rt_uint32_t sequence;
+
+    if (!scan->running)
+    {
+        return;
+    }
+
+    /* a missed half skips a frame, which the readers count as lost */
+    sequence = scan->sequence;
+    if ((int)(sequence & 1) != half)
+    {
+        sequence++;
+    }
+
+    scan->timestamp[half] = _adc_scan_timestamp();
+    scan->sequence = sequence + 1;
+
+    if (scan->callback != RT_NULL)
+    {
+        frame.samples = scan->buffer + half * scan->frame_size;
+        frame.length = scan->length;
+        frame.channel_count = scan->channel_count;
+        frame.sequence = sequence;
+        frame.timestamp = scan->timestamp[half];
+        scan->callback(dev, &frame, scan->user_data);
+    }
+
+    rt_completion_done(&scan->cpt);
+}
+#endif /* RT_ADC_USING_SCAN */
+
 #ifdef RT_USING_FINSH
 
 static int adc(int argc, char **argv)
@@ -151,6 +151,46 @@ rt_ssize_t rt_pin_read(rt_base_t pin)
     return _hw_pin.ops->pin_read(&_hw_pin.parent, pin);
 }
 
+/**
+ * @brief Read the input level of all the pins of a port at once.
+ *
+ * @param port is the port number, the driver defines how pins are grouped into ports.
+ *
+ * @return the input bits of the port, bit n for the n-th pin of the port,
+ *         or -RT_ENOSYS if the driver has no port access.
+ */
+rt_ssize_t rt_pin_port_read(rt_base_t port)
+{
+    RT_ASSERT(_hw_pin.ops != RT_NULL);
+
+    if (_hw_pin.ops->port_read == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    return _hw_pin.ops->port_read(&_hw_pin.parent, port);
+}
+
+/**
+ * @brief Set and clear several output pins of a port in one atomic write.
+ *
+ * @param port is the port number, the driver defines how pins are grouped into ports.
+ * @param set_mask is the pins to drive high, bit n for the n-th pin of the port.
+ * @param clear_mask is the pins to drive low. A pin in both masks is driven high.
+ *
+ * @return RT_EOK on success, -RT_EINVAL for an invalid port, or -RT_ENOSYS if the
+ *         driver has no port access.
+ */
+rt_err_t rt_pin_port_write(rt_base_t port, rt_uint32_t set_mask, rt_uint32_t clear_mask)
+{
+    RT_ASSERT(_hw_pin.ops != RT_NULL);
+
+    if (_hw_pin.ops->port_write == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    return _hw_pin.ops->port_write(&_hw_pin.parent, port, set_mask, clear_mask);
+}
+
 /* Get pin number by name, such as PA.0, P0.12 */
 rt_base_t rt_pin_get(const char *name)
 {
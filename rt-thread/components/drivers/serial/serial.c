@@ -37,6 +37,20 @@
 #define DBG_LVL    DBG_INFO
 #include <rtdbg.h>
 
+/*
+ * access to the indices of the lock-free interrupt mode rx fifo, see below.
+ * An index is stored with release and loaded with acquire ordering, so the
+ * buffer bytes are in place before the other side can see the index moved.
+ */
+#if defined(__GNUC__)
+#define _SERIAL_FIFO_LOAD(index)            __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define _SERIAL_FIFO_STORE(index, value)    __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#else
+/* rt_hw_dmb() must be a real barrier here, it is empty without RT_USING_CACHE */
+#define _SERIAL_FIFO_LOAD(index)            (*(volatile rt_uint16_t *)&(index))
+#define _SERIAL_FIFO_STORE(index, value)    do { rt_hw_dmb(); *(volatile rt_uint16_t *)&(index) = (value); } while (0)
+#endif
+
 #ifdef RT_USING_POSIX_STDIO
 #include <dfs_file.h>
 #include <fcntl.h>
@@ -213,10 +227,19 @@ static int serial_fops_poll(struct dfs_file *fd, struct rt_pollreq *req)
 
         rx_fifo = (struct rt_serial_rx_fifo*) serial->serial_rx;
 
-        level = rt_spin_lock_irqsave(&(serial->spinlock));
-        if ((rx_fifo->get_index != rx_fifo->put_index) || (rx_fifo->get_index == rx_fifo->put_index && rx_fifo->is_full == RT_TRUE))
-            mask |= POLLIN;
-        rt_spin_unlock_irqrestore(&(serial->spinlock), level);
+        if (device->open_flag & RT_DEVICE_FLAG_INT_RX)
+        {
+            /* is_full is never set in interrupt mode, the indices tell it all */
+            if (rx_fifo->get_index != _SERIAL_FIFO_LOAD(rx_fifo->put_index))
+                mask |= POLLIN;
+        }
+        else
+        {
+            level = rt_spin_lock_irqsave(&(serial->spinlock));
+            if ((rx_fifo->get_index != rx_fifo->put_index) || (rx_fifo->get_index == rx_fifo->put_index && rx_fifo->is_full == RT_TRUE))
+                mask |= POLLIN;
+            rt_spin_unlock_irqrestore(&(serial->spinlock), level);
+        }
     }
 
     return mask;
@@ -289,53 +312,56 @@ rt_inline int _serial_poll_tx(struct rt_serial_device *serial, const rt_uint8_t
 
 /*
  * Serial interrupt routines
+ *
+ * The interrupt mode rx fifo is a single-producer/single-consumer ring: the
+ * ISR only writes put_index and the reader only writes get_index, so neither
+ * side locks against the other. One slot is kept empty to tell a full ring
+ * from an empty one, is_full is never set in this mode. A flush consumes the
+ * received data the same way as a reader, by moving get_index up to put_index.
  */
 rt_inline int _serial_int_rx(struct rt_serial_device *serial, rt_uint8_t *data, int length)
 {
-    int size;
+    rt_size_t bufsz, recv_len, span;
+    rt_uint16_t put_index, get_index;
     struct rt_serial_rx_fifo* rx_fifo;
 
     RT_ASSERT(serial != RT_NULL);
-    size = length;
 
     rx_fifo = (struct rt_serial_rx_fifo*) serial->serial_rx;
     RT_ASSERT(rx_fifo != RT_NULL);
 
-    /* read from software FIFO */
-    while (length)
-    {
-        int ch;
-        rt_base_t level;
+    bufsz = serial->config.bufsz;
 
-        /* disable interrupt */
-        level = rt_spin_lock_irqsave(&(serial->spinlock));
+    /* the ISR never takes this lock, it only keeps the readers apart */
+    rt_spin_lock(&(rx_fifo->rx_lock));
 
-        /* there's no data: */
-        if ((rx_fifo->get_index == rx_fifo->put_index) && (rx_fifo->is_full == RT_FALSE))
+    put_index = _SERIAL_FIFO_LOAD(rx_fifo->put_index);
+    get_index = rx_fifo->get_index;
+    recv_len = (put_index >= get_index) ? (put_index - get_index) : (bufsz - get_index + put_index);
+    if (recv_len > (rt_size_t)length) recv_len = length;
+
+    /* read from software FIFO, the data wraps around the end of buffer at most once */
+    if (recv_len)
+    {
+        span = bufsz - get_index;
+        if (recv_len <= span)
         {
-            /* no data, enable interrupt and break out */
-            rt_spin_unlock_irqrestore(&(serial->spinlock), level);
-            break;
+            rt_memcpy(data, rx_fifo->buffer + get_index, recv_len);
         }
-
-        /* otherwise there's the data: */
-        ch = rx_fifo->buffer[rx_fifo->get_index];
-        rx_fifo->get_index += 1;
-        if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
-
-        if (rx_fifo->is_full == RT_TRUE)
+        else
         {
-            rx_fifo->is_full = RT_FALSE;
+            rt_memcpy(data, rx_fifo->buffer + get_index, span);
+            rt_memcpy(data + span, rx_fifo->buffer, recv_len - span);
         }
 
-        /* enable interrupt */
-        rt_spin_unlock_irqrestore(&(serial->spinlock), level);
-
-        *data = ch & 0xff;
-        data ++; length --;
+        get_index += recv_len;
+        if (get_index >= bufsz) get_index -= bufsz;
+        _SERIAL_FIFO_STORE(rx_fifo->get_index, get_index);
     }
 
-    return size - length;
+    rt_spin_unlock(&(rx_fifo->rx_lock));
+
+    return recv_len;
 }
 
 rt_inline int _serial_int_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
@@ -557,10 +583,36 @@ rt_inline int _serial_dma_rx(struct rt_serial_device *serial, rt_uint8_t *data,
     }
 }
 
+/*
+ * Start the DMA transmitting of the data at the head of the queue. The data
+ * which the driver fails to start is dropped, it is not sent.
+ */
+static void _serial_dma_tx_next(struct rt_serial_device *serial)
+{
+    const void *data_ptr;
+    rt_size_t data_size;
+    struct rt_serial_tx_dma *tx_dma;
+
+    tx_dma = (struct rt_serial_tx_dma*) serial->serial_tx;
+
+    while (rt_data_queue_peek(&(tx_dma->data_queue), &data_ptr, &data_size) == RT_EOK)
+    {
+        tx_dma->activated = RT_TRUE;
+        if (serial->ops->dma_transmit(serial, (rt_uint8_t *)data_ptr, data_size, RT_SERIAL_DMA_TX) > 0)
+            return;
+
+        LOG_E("%s: tx dma start failed, %d bytes dropped", serial->parent.parent.name, data_size);
+        rt_data_queue_pop(&(tx_dma->data_queue), &data_ptr, &data_size, 0);
+    }
+    tx_dma->activated = RT_FALSE;
+}
+
 rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
 {
     rt_base_t level;
     rt_err_t result;
+    const void *data_ptr;
+    rt_size_t data_size;
     struct rt_serial_tx_dma *tx_dma;
 
     tx_dma = (struct rt_serial_tx_dma*)(serial->serial_tx);
@@ -575,7 +627,15 @@ rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *
             rt_spin_unlock_irqrestore(&(serial->spinlock), level);
 
             /* make a DMA transfer */
-            serial->ops->dma_transmit(serial, (rt_uint8_t *)data, length, RT_SERIAL_DMA_TX);
+            if (serial->ops->dma_transmit(serial, (rt_uint8_t *)data, length, RT_SERIAL_DMA_TX) <= 0)
+            {
+                /* nothing is sent, take the data back and go on with what was queued meanwhile */
+                rt_data_queue_pop(&(tx_dma->data_queue), &data_ptr, &data_size, 0);
+                _serial_dma_tx_next(serial);
+
+                rt_set_errno(-RT_EIO);
+                return 0;
+            }
         }
         else
         {
@@ -664,6 +724,7 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
             rx_fifo->put_index = 0;
             rx_fifo->get_index = 0;
             rx_fifo->is_full = RT_FALSE;
+            rt_spin_lock_init(&(rx_fifo->rx_lock));
 
             serial->serial_rx = rx_fifo;
             dev->open_flag |= RT_DEVICE_FLAG_INT_RX;
@@ -994,9 +1055,15 @@ static void _tc_flush(struct rt_serial_device *serial, int queue)
 
             RT_ASSERT(rx_fifo != RT_NULL);
 
-            if((device->open_flag & RT_DEVICE_FLAG_INT_RX) || (device->open_flag & RT_DEVICE_FLAG_DMA_RX))
+            if (device->open_flag & RT_DEVICE_FLAG_INT_RX)
+            {
+                /* flushing consumes everything received, like a reader does */
+                rt_spin_lock(&(rx_fifo->rx_lock));
+                _SERIAL_FIFO_STORE(rx_fifo->get_index, _SERIAL_FIFO_LOAD(rx_fifo->put_index));
+                rt_spin_unlock(&(rx_fifo->rx_lock));
+            }
+            else if (device->open_flag & RT_DEVICE_FLAG_DMA_RX)
             {
-                RT_ASSERT(RT_NULL != rx_fifo);
                 level = rt_spin_lock_irqsave(&(serial->spinlock));
                 rx_fifo->get_index = rx_fifo->put_index;
                 rx_fifo->is_full = RT_FALSE;
@@ -1400,40 +1467,45 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
         case RT_SERIAL_EVENT_RX_IND:
         {
             int ch = -1;
-            rt_base_t level;
+            rt_size_t bufsz;
+            rt_uint16_t put_index, get_index, next_index;
             struct rt_serial_rx_fifo* rx_fifo;
 
             /* interrupt mode receive */
             rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
             RT_ASSERT(rx_fifo != RT_NULL);
 
+            bufsz = serial->config.bufsz;
+            put_index = rx_fifo->put_index;
+            get_index = _SERIAL_FIFO_LOAD(rx_fifo->get_index);
+
             while (1)
             {
                 ch = serial->ops->getc(serial);
                 if (ch == -1) break;
 
+                next_index = put_index + 1;
+                if (next_index >= bufsz) next_index = 0;
 
-                /* disable interrupt */
-                level = rt_spin_lock_irqsave(&(serial->spinlock));
-
-                rx_fifo->buffer[rx_fifo->put_index] = ch;
-                rx_fifo->put_index += 1;
-                if (rx_fifo->put_index >= serial->config.bufsz) rx_fifo->put_index = 0;
-
-                /* if the next position is read index, discard this 'read char' */
-                if (rx_fifo->put_index == rx_fifo->get_index)
+                if (next_index == get_index)
                 {
-                    rx_fifo->get_index += 1;
-                    rx_fifo->is_full = RT_TRUE;
-                    if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
-
-                    _serial_check_buffer_size();
+                    /* the reader may have made room since the last look */
+                    get_index = _SERIAL_FIFO_LOAD(rx_fifo->get_index);
+                    if (next_index == get_index)
+                    {
+                        /* the fifo is full, discard this 'read char' */
+                        _serial_check_buffer_size();
+                        continue;
+                    }
                 }
 
-                /* enable interrupt */
-                rt_spin_unlock_irqrestore(&(serial->spinlock), level);
+                ((volatile rt_uint8_t *)rx_fifo->buffer)[put_index] = ch;
+                put_index = next_index;
             }
 
+            /* publish the whole burst to the reader */
+            _SERIAL_FIFO_STORE(rx_fifo->put_index, put_index);
+
             /**
              * Invoke callback.
              * First try notify if any, and if notify is existed, rx_indicate()
@@ -1449,10 +1521,9 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
                 rt_size_t rx_length;
 
                 /* get rx length */
-                level = rt_spin_lock_irqsave(&(serial->spinlock));
-                rx_length = (rx_fifo->put_index >= rx_fifo->get_index)? (rx_fifo->put_index - rx_fifo->get_index):
-                    (serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index));
-                rt_spin_unlock_irqrestore(&(serial->spinlock), level);
+                get_index = _SERIAL_FIFO_LOAD(rx_fifo->get_index);
+                rx_length = (put_index >= get_index)? (put_index - get_index):
+                    (bufsz - (get_index - put_index));
 
                 if (rx_length)
                 {
@@ -1472,7 +1543,6 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 #ifdef RT_SERIAL_USING_DMA
         case RT_SERIAL_EVENT_TX_DMADONE:
         {
-            const void *data_ptr;
             rt_size_t data_size;
             const void *last_data_ptr;
             struct rt_serial_tx_dma *tx_dma;
@@ -1480,16 +1550,8 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
             tx_dma = (struct rt_serial_tx_dma*) serial->serial_tx;
 
             rt_data_queue_pop(&(tx_dma->data_queue), &last_data_ptr, &data_size, 0);
-            if (rt_data_queue_peek(&(tx_dma->data_queue), &data_ptr, &data_size) == RT_EOK)
-            {
-                /* transmit next data node */
-                tx_dma->activated = RT_TRUE;
-                serial->ops->dma_transmit(serial, (rt_uint8_t *)data_ptr, data_size, RT_SERIAL_DMA_TX);
-            }
-            else
-            {
-                tx_dma->activated = RT_FALSE;
-            }
+            /* transmit next data node */
+            _serial_dma_tx_next(serial);
 
             /* invoke callback */
             if (serial->parent.tx_complete != RT_NULL)
@@ -1498,6 +1560,20 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
             }
             break;
         }
+        case RT_SERIAL_EVENT_TX_DMAERR:
+        {
+            rt_size_t data_size;
+            const void *data_ptr;
+            struct rt_serial_tx_dma *tx_dma;
+
+            tx_dma = (struct rt_serial_tx_dma*) serial->serial_tx;
+
+            /* the driver could not start the transfer at the head after accepting it */
+            rt_data_queue_pop(&(tx_dma->data_queue), &data_ptr, &data_size, 0);
+            LOG_E("%s: tx dma failed, %d bytes dropped", serial->parent.parent.name, data_size);
+            _serial_dma_tx_next(serial);
+            break;
+        }
         case RT_SERIAL_EVENT_RX_DMADONE:
         {
             int length;
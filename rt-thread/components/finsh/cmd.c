@@ -41,6 +41,11 @@
 #ifdef RT_USING_FINSH
 #include <finsh.h>
 
+#if defined(RT_USING_CPU_USAGE) && defined(RT_USING_HEAP)
+#include <stdlib.h>
+#include <drivers/cputime.h>
+#endif /* RT_USING_CPU_USAGE && RT_USING_HEAP */
+
 #define LIST_DFS_OPT_ID 0x100
 #define LIST_FIND_OBJ_NR 8
 
@@ -156,38 +161,24 @@ static rt_list_t *list_get_next(rt_list_t *current, list_get_next_t *arg)
     return node;
 }
 
-long list_thread(void)
+typedef void (*list_thread_fn_t)(struct rt_thread *thread, struct rt_thread *copy, void *parameter);
+
+/*
+ * walk all threads. Every thread still in the list is copied under the object
+ * lock, with its longest time slice reset if reset_slice is set, then fn is
+ * called with the copy after the lock is released.
+ */
+static void list_thread_walk(list_thread_fn_t fn, void *parameter, rt_bool_t reset_slice)
 {
     rt_base_t level;
     list_get_next_t find_arg;
     struct rt_object_information *info;
     rt_list_t *obj_list[LIST_FIND_OBJ_NR];
     rt_list_t *next = (rt_list_t *)RT_NULL;
-    const char *item_title = "thread";
-    const size_t tcb_strlen = sizeof(void *) * 2 + 2;
-    int maxlen;
 
     list_find_init(&find_arg, RT_Object_Class_Thread, obj_list, sizeof(obj_list) / sizeof(obj_list[0]));
     info = rt_list_entry(find_arg.list, struct rt_object_information, object_list);
 
-    maxlen = RT_NAME_MAX;
-
-#ifdef RT_USING_SMP
-    rt_kprintf("%-*.*s cpu bind pri  status      sp     stack size max used left tick   error  tcb addr\n", maxlen, maxlen, item_title);
-    object_split(maxlen);
-    rt_kprintf(" --- ---- ---  ------- ---------- ----------  ------  ---------- -------");
-    rt_kprintf(" ");
-    object_split(tcb_strlen);
-    rt_kprintf("\n");
-#else
-    rt_kprintf("%-*.*s pri  status      sp     stack size max used left tick   error  tcb addr\n", maxlen, maxlen, item_title);
-    object_split(maxlen);
-    rt_kprintf(" ---  ------- ---------- ----------  ------  ---------- -------");
-    rt_kprintf(" ");
-    object_split(tcb_strlen);
-    rt_kprintf("\n");
-#endif /*RT_USING_SMP*/
-
     do
     {
         next = list_get_next(next, &find_arg);
@@ -196,7 +187,7 @@ long list_thread(void)
             for (i = 0; i < find_arg.nr_out; i++)
             {
                 struct rt_object *obj;
-                struct rt_thread thread_info, *thread;
+                struct rt_thread thread_info;
 
                 obj = rt_list_entry(obj_list[i], struct rt_object, list);
                 level = rt_spin_lock_irqsave(&info->spinlock);
@@ -208,68 +199,266 @@ long list_thread(void)
                 }
                 /* copy info */
                 rt_memcpy(&thread_info, obj, sizeof thread_info);
+#ifdef RT_USING_CPU_USAGE
+                if (reset_slice)
+                    ((struct rt_thread *)obj)->max_slice_tick = 0;
+#endif /* RT_USING_CPU_USAGE */
                 rt_spin_unlock_irqrestore(&info->spinlock, level);
 
-                thread = (struct rt_thread *)obj;
-                {
-                    rt_uint8_t stat;
-                    rt_uint8_t *ptr;
+                fn((struct rt_thread *)obj, &thread_info, parameter);
+            }
+        }
+    }
+    while (next != (rt_list_t *)RT_NULL);
+}
+
+static void list_thread_show(struct rt_thread *thread, struct rt_thread *copy, void *parameter)
+{
+    int maxlen = *(int *)parameter;
+    rt_uint8_t stat;
+    rt_uint8_t *ptr;
 
 #ifdef RT_USING_SMP
-                    /* no synchronization applied since it's only for debug */
-                    if (RT_SCHED_CTX(thread).oncpu != RT_CPU_DETACHED)
-                        rt_kprintf("%-*.*s %3d %3d %4d ", maxlen, RT_NAME_MAX,
-                                   thread->parent.name, RT_SCHED_CTX(thread).oncpu,
-                                   RT_SCHED_CTX(thread).bind_cpu,
-                                   RT_SCHED_PRIV(thread).current_priority);
-                    else
-                        rt_kprintf("%-*.*s N/A %3d %4d ", maxlen, RT_NAME_MAX,
-                                   thread->parent.name,
-                                   RT_SCHED_CTX(thread).bind_cpu,
-                                   RT_SCHED_PRIV(thread).current_priority);
+    /* no synchronization applied since it's only for debug */
+    if (RT_SCHED_CTX(thread).oncpu != RT_CPU_DETACHED)
+        rt_kprintf("%-*.*s %3d %3d %4d ", maxlen, RT_NAME_MAX,
+                   thread->parent.name, RT_SCHED_CTX(thread).oncpu,
+                   RT_SCHED_CTX(thread).bind_cpu,
+                   RT_SCHED_PRIV(thread).current_priority);
+    else
+        rt_kprintf("%-*.*s N/A %3d %4d ", maxlen, RT_NAME_MAX,
+                   thread->parent.name,
+                   RT_SCHED_CTX(thread).bind_cpu,
+                   RT_SCHED_PRIV(thread).current_priority);
 
 #else
-                    /* no synchronization applied since it's only for debug */
-                    rt_kprintf("%-*.*s %3d ", maxlen, RT_NAME_MAX, thread->parent.name, RT_SCHED_PRIV(thread).current_priority);
+    /* no synchronization applied since it's only for debug */
+    rt_kprintf("%-*.*s %3d ", maxlen, RT_NAME_MAX, thread->parent.name, RT_SCHED_PRIV(thread).current_priority);
 #endif /*RT_USING_SMP*/
-                    stat = (RT_SCHED_CTX(thread).stat & RT_THREAD_STAT_MASK);
-                    if (stat == RT_THREAD_READY)        rt_kprintf(" ready  ");
-                    else if ((stat & RT_THREAD_SUSPEND_MASK) == RT_THREAD_SUSPEND_MASK) rt_kprintf(" suspend");
-                    else if (stat == RT_THREAD_INIT)    rt_kprintf(" init   ");
-                    else if (stat == RT_THREAD_CLOSE)   rt_kprintf(" close  ");
-                    else if (stat == RT_THREAD_RUNNING) rt_kprintf(" running");
+    stat = (RT_SCHED_CTX(thread).stat & RT_THREAD_STAT_MASK);
+    if (stat == RT_THREAD_READY)        rt_kprintf(" ready  ");
+    else if ((stat & RT_THREAD_SUSPEND_MASK) == RT_THREAD_SUSPEND_MASK) rt_kprintf(" suspend");
+    else if (stat == RT_THREAD_INIT)    rt_kprintf(" init   ");
+    else if (stat == RT_THREAD_CLOSE)   rt_kprintf(" close  ");
+    else if (stat == RT_THREAD_RUNNING) rt_kprintf(" running");
 
 #if defined(ARCH_CPU_STACK_GROWS_UPWARD)
-                    ptr = (rt_uint8_t *)thread->stack_addr + thread->stack_size - 1;
-                    while (*ptr == '#')ptr --;
-
-                    rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %s %p\n",
-                               ((rt_ubase_t)thread->sp - (rt_ubase_t)thread->stack_addr),
-                               thread->stack_size,
-                               ((rt_ubase_t)ptr - (rt_ubase_t)thread->stack_addr) * 100 / thread->stack_size,
-                               thread->remaining_tick,
-                               rt_strerror(thread->error),
-                               thread);
+    ptr = (rt_uint8_t *)thread->stack_addr + thread->stack_size - 1;
+    while (*ptr == '#')ptr --;
+
+    rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %s %p\n",
+               ((rt_ubase_t)thread->sp - (rt_ubase_t)thread->stack_addr),
+               thread->stack_size,
+               ((rt_ubase_t)ptr - (rt_ubase_t)thread->stack_addr) * 100 / thread->stack_size,
+               thread->remaining_tick,
+               rt_strerror(thread->error),
+               thread);
 #else
-                    ptr = (rt_uint8_t *)thread->stack_addr;
-                    while (*ptr == '#') ptr ++;
-                    rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %s %p\n",
-                               thread->stack_size + ((rt_ubase_t)thread->stack_addr - (rt_ubase_t)thread->sp),
-                               thread->stack_size,
-                               (thread->stack_size - ((rt_ubase_t) ptr - (rt_ubase_t) thread->stack_addr)) * 100
-                               / thread->stack_size,
-                               RT_SCHED_PRIV(thread).remaining_tick,
-                               rt_strerror(thread->error),
-                               thread);
+    ptr = (rt_uint8_t *)thread->stack_addr;
+    while (*ptr == '#') ptr ++;
+    rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %s %p\n",
+               thread->stack_size + ((rt_ubase_t)thread->stack_addr - (rt_ubase_t)thread->sp),
+               thread->stack_size,
+               (thread->stack_size - ((rt_ubase_t) ptr - (rt_ubase_t) thread->stack_addr)) * 100
+               / thread->stack_size,
+               RT_SCHED_PRIV(thread).remaining_tick,
+               rt_strerror(thread->error),
+               thread);
 #endif
-                }
-            }
+}
+
+long list_thread(void)
+{
+    const char *item_title = "thread";
+    const size_t tcb_strlen = sizeof(void *) * 2 + 2;
+    int maxlen;
+
+    maxlen = RT_NAME_MAX;
+
+#ifdef RT_USING_SMP
+    rt_kprintf("%-*.*s cpu bind pri  status      sp     stack size max used left tick   error  tcb addr\n", maxlen, maxlen, item_title);
+    object_split(maxlen);
+    rt_kprintf(" --- ---- ---  ------- ---------- ----------  ------  ---------- -------");
+    rt_kprintf(" ");
+    object_split(tcb_strlen);
+    rt_kprintf("\n");
+#else
+    rt_kprintf("%-*.*s pri  status      sp     stack size max used left tick   error  tcb addr\n", maxlen, maxlen, item_title);
+    object_split(maxlen);
+    rt_kprintf(" ---  ------- ---------- ----------  ------  ---------- -------");
+    rt_kprintf(" ");
+    object_split(tcb_strlen);
+    rt_kprintf("\n");
+#endif /*RT_USING_SMP*/
+
+    list_thread_walk(list_thread_show, &maxlen, RT_FALSE);
+
+    return 0;
+}
+
+#if defined(RT_USING_CPU_USAGE) && defined(RT_USING_HEAP)
+struct top_item
+{
+    rt_thread_t thread;
+    rt_uint64_t tick;                   /* cumulative run time */
+    rt_uint64_t delta;                  /* run time in the window */
+    rt_uint32_t max_slice;
+    rt_uint8_t  priority;
+    char        name[RT_NAME_MAX];
+};
+
+struct top_sample_arg
+{
+    struct top_item *items;
+    int nr;
+    int count;
+};
+
+static void top_sample_thread(struct rt_thread *thread, struct rt_thread *copy, void *parameter)
+{
+    struct top_sample_arg *arg = (struct top_sample_arg *)parameter;
+    struct top_item *item;
+
+    if (arg->count >= arg->nr)
+        return;
+
+    item = &arg->items[arg->count++];
+    item->thread = thread;
+    item->tick = copy->duration_tick;
+    item->max_slice = copy->max_slice_tick;
+    item->priority = RT_SCHED_PRIV(copy).current_priority;
+    rt_memcpy(item->name, copy->parent.name, RT_NAME_MAX);
+}
+
+/* take a sample of all threads and reset their longest time slice */
+static int top_sample(struct top_item *items, int nr)
+{
+    struct top_sample_arg arg = {items, nr, 0};
+
+    list_thread_walk(top_sample_thread, &arg, RT_TRUE);
+
+    return arg.count;
+}
+
+/* the run time of a thread in the last sample, 0 if it is new */
+static rt_uint64_t top_last_tick(const struct top_item *item, const struct top_item *last, int last_nr)
+{
+    int i;
+
+    for (i = 0; i < last_nr; i++)
+    {
+        /* a control block reused by a new thread is a new thread too */
+        if (last[i].thread == item->thread && rt_strncmp(last[i].name, item->name, RT_NAME_MAX) == 0)
+            return last[i].tick;
+    }
+
+    return 0;
+}
+
+static rt_uint64_t top_irq_tick(void)
+{
+    rt_uint64_t tick = 0;
+    int cpu;
+
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+    {
+        tick += rt_sched_usage_irq_tick(cpu);
+    }
+
+    return tick;
+}
+
+rt_inline void top_percent(rt_uint64_t tick, rt_uint64_t total)
+{
+    rt_uint32_t permille = total ? (rt_uint32_t)(tick * 1000 / total) : 0;
+
+    rt_kprintf("%3d.%d%%", permille / 10, permille % 10);
+}
+
+static int top(int argc, char **argv)
+{
+    struct top_item *last, *items, item;
+    rt_uint64_t irq_tick, irq_delta, total;
+    int period = 1000, loop = 1;
+    int nr, last_nr, count, i, j;
+    const char *item_title = "thread";
+    int maxlen = RT_NAME_MAX;
+
+    if (argc > 1)
+        period = atoi(argv[1]);
+    if (argc > 2)
+        loop = atoi(argv[2]);
+    if (period <= 0 || loop <= 0)
+    {
+        rt_kprintf("Usage: top [period ms] [count]\n");
+        return -RT_EINVAL;
+    }
+
+    /* leave room for the threads created in the window */
+    nr = rt_object_get_length(RT_Object_Class_Thread) + LIST_FIND_OBJ_NR;
+    last = (struct top_item *)rt_malloc(2 * nr * sizeof(struct top_item));
+    if (last == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return -RT_ENOMEM;
+    }
+    items = last + nr;
+
+    last_nr = top_sample(last, nr);
+    irq_tick = top_irq_tick();
+
+    while (loop --)
+    {
+        rt_thread_mdelay(period);
+
+        count = top_sample(items, nr);
+        irq_delta = top_irq_tick() - irq_tick;
+        irq_tick += irq_delta;
+
+        /* run time in the window */
+        total = irq_delta;
+        for (i = 0; i < count; i++)
+        {
+            rt_uint64_t last_tick = top_last_tick(&items[i], last, last_nr);
+
+            /* a run time going backwards belongs to another thread */
+            items[i].delta = items[i].tick > last_tick ? items[i].tick - last_tick : 0;
+            total += items[i].delta;
         }
+
+        /* sort by the run time in the window */
+        for (i = 1; i < count; i++)
+        {
+            item = items[i];
+            for (j = i; j > 0 && items[j - 1].delta < item.delta; j--)
+                items[j] = items[j - 1];
+            items[j] = item;
+        }
+
+        rt_kprintf("CPU usage in the last %d ms, irq ", period);
+        top_percent(irq_delta, total);
+        rt_kprintf("\n");
+        rt_kprintf("%-*.*s pri     cpu  max slice(us)\n", maxlen, maxlen, item_title);
+        object_split(maxlen);
+        rt_kprintf(" ---  ------  -------------\n");
+        for (i = 0; i < count; i++)
+        {
+            rt_kprintf("%-*.*s %3d  ", maxlen, RT_NAME_MAX, items[i].name, items[i].priority);
+            top_percent(items[i].delta, total);
+            rt_kprintf("  %13d\n", (rt_uint32_t)clock_cpu_microsecond(items[i].max_slice));
+        }
+
+        /* the next window starts from this sample */
+        rt_memcpy(last, items, count * sizeof(struct top_item));
+        last_nr = count;
     }
-    while (next != (rt_list_t *)RT_NULL);
+
+    rt_free(last);
 
     return 0;
 }
+MSH_CMD_EXPORT(top, show CPU usage of threads: top [period ms] [count]);
+#endif /* RT_USING_CPU_USAGE && RT_USING_HEAP */
 
 #ifdef RT_USING_SEMAPHORE
 long list_sem(void)
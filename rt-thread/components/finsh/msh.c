@@ -9,8 +9,10 @@
  * 2014-01-03     Bernard      msh can execute module.
  * 2017-07-19     Aubr.Cool    limit argc to RT_FINSH_ARG_MAX
  */
+#include <rthw.h>
 #include <rtthread.h>
 #include <string.h>
+#include <stdlib.h>
 #include <errno.h>
 
 #ifdef RT_USING_FINSH
@@ -171,10 +173,9 @@ static int msh_split(char *cmd, rt_size_t length, char *argv[FINSH_ARG_MAX])
     return argc;
 }
 
-static cmd_function_t msh_get_cmd(char *cmd, int size)
+static struct finsh_syscall *msh_scan_cmd(const char *cmd, int size)
 {
     struct finsh_syscall *index;
-    cmd_function_t cmd_func = RT_NULL;
 
     for (index = _syscall_table_begin;
             index < _syscall_table_end;
@@ -183,14 +184,216 @@ static cmd_function_t msh_get_cmd(char *cmd, int size)
         if (strncmp(index->name, cmd, size) == 0 &&
                 index->name[size] == '\0')
         {
-            cmd_func = (cmd_function_t)index->func;
-            break;
+            return index;
+        }
+    }
+
+    return RT_NULL;
+}
+
+#ifdef FINSH_USING_CMD_INDEX
+/* the commands sorted by name, it is built at the first use */
+static struct finsh_syscall **msh_cmd_index = RT_NULL;
+static int msh_cmd_index_num = 0;
+
+/* compare the name with the first size characters of cmd, same as strcmp */
+static int msh_cmd_compare(const char *name, const char *cmd, int size)
+{
+    int result;
+
+    result = strncmp(name, cmd, size);
+    if (result == 0 && name[size] != '\0')
+    {
+        /* the name is longer than the command */
+        result = 1;
+    }
+
+    return result;
+}
+
+/**
+ * get the sorted command index
+ *
+ * @param num the number of commands in the index
+ *
+ * @return the index, RT_NULL if there is no memory for it
+ */
+static struct finsh_syscall **msh_cmd_index_get(int *num)
+{
+    struct finsh_syscall *index, **table;
+    rt_base_t level;
+    int count = 0, i;
+
+    if (msh_cmd_index == RT_NULL)
+    {
+        for (index = _syscall_table_begin;
+                index < _syscall_table_end;
+                FINSH_NEXT_SYSCALL(index))
+        {
+            count ++;
+        }
+
+        table = (struct finsh_syscall **)rt_malloc(count * sizeof(struct finsh_syscall *));
+        if (table == RT_NULL)
+        {
+            return RT_NULL;
+        }
+
+        /* insertion sort, it is stable so the first one of the same names is still found first */
+        count = 0;
+        for (index = _syscall_table_begin;
+                index < _syscall_table_end;
+                FINSH_NEXT_SYSCALL(index))
+        {
+            for (i = count; i > 0 && strcmp(table[i - 1]->name, index->name) > 0; i --)
+            {
+                table[i] = table[i - 1];
+            }
+            table[i] = index;
+            count ++;
+        }
+
+        /* the other thread may build it at the same time */
+        level = rt_hw_interrupt_disable();
+        if (msh_cmd_index == RT_NULL)
+        {
+            msh_cmd_index_num = count;
+            msh_cmd_index = table;
+            table = RT_NULL;
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (table != RT_NULL)
+        {
+            rt_free(table);
+        }
+    }
+
+    *num = msh_cmd_index_num;
+    return msh_cmd_index;
+}
+
+/* the position of the first command which name is not less than the first size characters of cmd */
+static int msh_cmd_index_lower(struct finsh_syscall **table, int num, const char *cmd, int size)
+{
+    int low = 0, high = num, mid;
+
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (msh_cmd_compare(table[mid]->name, cmd, size) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+#endif /* FINSH_USING_CMD_INDEX */
+
+static struct finsh_syscall *msh_find_cmd(const char *cmd, int size)
+{
+#ifdef FINSH_USING_CMD_INDEX
+    struct finsh_syscall **table;
+    int num, pos;
+
+    table = msh_cmd_index_get(&num);
+    if (table != RT_NULL)
+    {
+        pos = msh_cmd_index_lower(table, num, cmd, size);
+        if (pos < num && msh_cmd_compare(table[pos]->name, cmd, size) == 0)
+        {
+            return table[pos];
         }
+        return RT_NULL;
     }
+#endif /* FINSH_USING_CMD_INDEX */
 
-    return cmd_func;
+    return msh_scan_cmd(cmd, size);
 }
 
+static cmd_function_t msh_get_cmd(char *cmd, int size)
+{
+    struct finsh_syscall *call;
+
+    call = msh_find_cmd(cmd, size);
+    if (call == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    return (cmd_function_t)call->func;
+}
+
+#ifdef FINSH_USING_CMD_INDEX
+/* look up every command and an unknown one by the linear scan and by the index */
+static int msh_cmd_bench(int argc, char **argv)
+{
+    struct finsh_syscall **table;
+    rt_tick_t scan_tick, index_tick;
+    int rounds = 100, num, round, pos, found = 0;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (rounds <= 0)
+    {
+        rt_kprintf("Usage: msh_cmd_bench [rounds]\n");
+        return -RT_EINVAL;
+    }
+
+    table = msh_cmd_index_get(&num);
+    if (table == RT_NULL)
+    {
+        rt_kprintf("no memory\n");
+        return -RT_ENOMEM;
+    }
+
+    /* the index finds the same command as the scan */
+    for (pos = 0; pos < num; pos ++)
+    {
+        if (msh_find_cmd(table[pos]->name, strlen(table[pos]->name)) !=
+                msh_scan_cmd(table[pos]->name, strlen(table[pos]->name)))
+        {
+            rt_kprintf("%s: the index is different from the table\n", table[pos]->name);
+            return -RT_ERROR;
+        }
+    }
+
+    scan_tick = rt_tick_get();
+    for (round = 0; round < rounds; round ++)
+    {
+        for (pos = 0; pos < num; pos ++)
+        {
+            found += msh_scan_cmd(table[pos]->name, strlen(table[pos]->name)) != RT_NULL;
+        }
+        found += msh_scan_cmd("not_a_cmd", 9) != RT_NULL;
+    }
+    scan_tick = rt_tick_get() - scan_tick;
+
+    index_tick = rt_tick_get();
+    for (round = 0; round < rounds; round ++)
+    {
+        for (pos = 0; pos < num; pos ++)
+        {
+            found += msh_find_cmd(table[pos]->name, strlen(table[pos]->name)) != RT_NULL;
+        }
+        found += msh_find_cmd("not_a_cmd", 9) != RT_NULL;
+    }
+    index_tick = rt_tick_get() - index_tick;
+
+    rt_kprintf("%d commands, %d lookups, %d found\n", num, rounds * (num + 1), found / 2);
+    rt_kprintf("scan : %d ms\n", scan_tick * 1000 / RT_TICK_PER_SECOND);
+    rt_kprintf("index: %d ms\n", index_tick * 1000 / RT_TICK_PER_SECOND);
+
+    return 0;
+}
+MSH_CMD_EXPORT(msh_cmd_bench, benchmark the command lookup: msh_cmd_bench [rounds]);
+#endif /* FINSH_USING_CMD_INDEX */
+
 #if defined(RT_USING_MODULE) && defined(DFS_USING_POSIX)
 /* Return 0 on module executed. Other value indicate error.
  */
@@ -565,6 +768,26 @@ static int str_common(const char *str1, const char *str2)
     return (str - str1);
 }
 
+/* print the command which matches the prefix, and shorten the common part of the matched commands */
+static void msh_complete_cmd(const char *cmd_name, const char **name_ptr, int *min_length)
+{
+    int length;
+
+    if (*min_length == 0)
+    {
+        /* set name_ptr */
+        *name_ptr = cmd_name;
+        /* set initial length */
+        *min_length = strlen(cmd_name);
+    }
+
+    length = str_common(*name_ptr, cmd_name);
+    if (length < *min_length)
+        *min_length = length;
+
+    rt_kprintf("%s\n", cmd_name);
+}
+
 #ifdef DFS_USING_POSIX
 void msh_auto_complete_path(char *path)
 {
@@ -714,9 +937,13 @@ void msh_auto_complete_path(char *path)
 
 void msh_auto_complete(char *prefix)
 {
-    int length, min_length;
+    int min_length;
     const char *name_ptr, *cmd_name;
     struct finsh_syscall *index;
+#ifdef FINSH_USING_CMD_INDEX
+    struct finsh_syscall **table;
+    int num, pos, prefix_length;
+#endif /* FINSH_USING_CMD_INDEX */
 
     min_length = 0;
     name_ptr = RT_NULL;
@@ -756,6 +983,21 @@ void msh_auto_complete(char *prefix)
 #endif /* DFS_USING_POSIX */
 
     /* checks in internal command */
+#ifdef FINSH_USING_CMD_INDEX
+    table = msh_cmd_index_get(&num);
+    if (table != RT_NULL)
+    {
+        /* the matched commands are next to each other in the index */
+        prefix_length = strlen(prefix);
+        for (pos = msh_cmd_index_lower(table, num, prefix, prefix_length);
+                pos < num && strncmp(prefix, table[pos]->name, prefix_length) == 0;
+                pos ++)
+        {
+            msh_complete_cmd(table[pos]->name, &name_ptr, &min_length);
+        }
+    }
+    else
+#endif /* FINSH_USING_CMD_INDEX */
     {
         for (index = _syscall_table_begin; index < _syscall_table_end; FINSH_NEXT_SYSCALL(index))
         {
@@ -763,19 +1005,7 @@ void msh_auto_complete(char *prefix)
             cmd_name = (const char *) index->name;
             if (strncmp(prefix, cmd_name, strlen(prefix)) == 0)
             {
-                if (min_length == 0)
-                {
-                    /* set name_ptr */
-                    name_ptr = cmd_name;
-                    /* set initial length */
-                    min_length = strlen(name_ptr);
-                }
-
-                length = str_common(name_ptr, cmd_name);
-                if (length < min_length)
-                    min_length = length;
-
-                rt_kprintf("%s\n", cmd_name);
+                msh_complete_cmd(cmd_name, &name_ptr, &min_length);
             }
         }
     }
@@ -792,7 +1022,7 @@ void msh_auto_complete(char *prefix)
 #ifdef FINSH_USING_OPTION_COMPLETION
 static msh_cmd_opt_t *msh_get_cmd_opt(char *opt_str)
 {
-    struct finsh_syscall *index;
+    struct finsh_syscall *call;
     msh_cmd_opt_t *opt = RT_NULL;
     char *ptr;
     int len;
@@ -807,15 +1037,10 @@ static msh_cmd_opt_t *msh_get_cmd_opt(char *opt_str)
         len = strlen(opt_str);
     }
 
-    for (index = _syscall_table_begin;
-            index < _syscall_table_end;
-            FINSH_NEXT_SYSCALL(index))
+    call = msh_find_cmd(opt_str, len);
+    if (call != RT_NULL)
     {
-        if (strncmp(index->name, opt_str, len) == 0 && index->name[len] == '\0')
-        {
-            opt = index->opt;
-            break;
-        }
+        opt = call->opt;
     }
 
     return opt;
@@ -0,0 +1,585 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <ktrace.h>
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif
+
+#ifdef DFS_USING_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define DBG_TAG    "ktrace"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+#if !defined(RT_USING_HOOK) || !defined(RT_HOOK_USING_FUNC_PTR)
+#error "Please enable RT_USING_HOOK and RT_HOOK_USING_FUNC_PTR"
+#endif
+
+#define KTRACE_RECORDS_PER_SECTION ((0xFFFF - 2 * sizeof(rt_uint32_t)) / sizeof(struct rt_ktrace_record))
+
+/* flight recorder of one cpu, the oldest records are overwritten */
+struct ktrace_ring
+{
+    rt_uint32_t head;                   /* number of records ever written */
+    struct rt_ktrace_record records[RT_KTRACE_RECORDS];
+};
+
+static struct ktrace_ring _ktrace_ring[RT_CPUS_NR];
+static volatile rt_bool_t _ktrace_running = RT_FALSE;
+static rt_bool_t _ktrace_use_cputime = RT_FALSE;
+
+/* the hooks set before the tracer started, they are still called while tracing and restored on stop */
+static struct
+{
+    void (*scheduler)(struct rt_thread *from, struct rt_thread *to);
+    void (*thread_suspend)(rt_thread_t thread);
+    void (*thread_resume)(rt_thread_t thread);
+    void (*interrupt_enter)(void);
+    void (*interrupt_leave)(void);
+    void (*timer_enter)(struct rt_timer *timer);
+    void (*timer_exit)(struct rt_timer *timer);
+    void (*object_trytake)(struct rt_object *object);
+    void (*object_take)(struct rt_object *object);
+    void (*object_put)(struct rt_object *object);
+#ifdef RT_USING_MEMPOOL
+    void (*mp_alloc)(struct rt_mempool *mp, void *block);
+    void (*mp_free)(struct rt_mempool *mp, void *block);
+#endif
+} _ktrace_prev_hook;
+
+#define KTRACE_CALL_PREV(name, argv)                \
+    do                                              \
+    {                                               \
+        if (_ktrace_prev_hook.name != RT_NULL)      \
+            _ktrace_prev_hook.name argv;            \
+    } while (0)
+
+rt_inline rt_uint32_t _ktrace_timestamp(void)
+{
+#ifdef RT_USING_CPUTIME
+    if (_ktrace_use_cputime)
+        return (rt_uint32_t)clock_cpu_gettime();
+#endif
+    return (rt_uint32_t)rt_tick_get();
+}
+
+rt_inline rt_uint16_t _ktrace_irq_number(void)
+{
+#if defined(ARCH_ARM_CORTEX_M) && defined(__GNUC__)
+    rt_uint32_t ipsr;
+
+    /* the active exception number, IRQn is (ipsr - 16) */
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return (rt_uint16_t)(ipsr & 0x1FF);
+#else
+    return 0;
+#endif
+}
+
+static void _ktrace_put(rt_uint8_t event, rt_uint8_t param8, rt_uint16_t param16, void *object)
+{
+    rt_base_t level;
+    struct ktrace_ring *ring;
+    struct rt_ktrace_record *record;
+
+    level = rt_hw_local_irq_disable();
+#ifdef RT_USING_SMP
+    ring = &_ktrace_ring[rt_hw_cpu_id()];
+#else
+    ring = &_ktrace_ring[0];
+#endif
+    record = &ring->records[ring->head & (RT_KTRACE_RECORDS - 1)];
+    ring->head ++;
+
+    record->timestamp = _ktrace_timestamp();
+    record->event     = event;
+    record->param8    = param8;
+    record->param16   = param16;
+    record->object    = (rt_uint32_t)(rt_ubase_t)object;
+    rt_hw_local_irq_enable(level);
+}
+
+static void _ktrace_scheduler_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    _ktrace_put(RT_KTRACE_EVT_SWITCH, RT_SCHED_PRIV(to).current_priority,
+                RT_SCHED_PRIV(from).current_priority, to);
+    KTRACE_CALL_PREV(scheduler, (from, to));
+}
+
+static void _ktrace_suspend_hook(rt_thread_t thread)
+{
+    _ktrace_put(RT_KTRACE_EVT_SUSPEND, RT_SCHED_PRIV(thread).current_priority, 0, thread);
+    KTRACE_CALL_PREV(thread_suspend, (thread));
+}
+
+static void _ktrace_resume_hook(rt_thread_t thread)
+{
+    _ktrace_put(RT_KTRACE_EVT_RESUME, RT_SCHED_PRIV(thread).current_priority, 0, thread);
+    KTRACE_CALL_PREV(thread_resume, (thread));
+}
+
+static void _ktrace_irq_enter_hook(void)
+{
+    _ktrace_put(RT_KTRACE_EVT_IRQ_ENTER, rt_interrupt_get_nest(), _ktrace_irq_number(), RT_NULL);
+    KTRACE_CALL_PREV(interrupt_enter, ());
+}
+
+static void _ktrace_irq_leave_hook(void)
+{
+    _ktrace_put(RT_KTRACE_EVT_IRQ_LEAVE, rt_interrupt_get_nest(), _ktrace_irq_number(), RT_NULL);
+    KTRACE_CALL_PREV(interrupt_leave, ());
+}
+
+static void _ktrace_timer_enter_hook(struct rt_timer *timer)
+{
+    _ktrace_put(RT_KTRACE_EVT_TIMER_ENTER, 0, 0, timer);
+    KTRACE_CALL_PREV(timer_enter, (timer));
+}
+
+static void _ktrace_timer_exit_hook(struct rt_timer *timer)
+{
+    _ktrace_put(RT_KTRACE_EVT_TIMER_EXIT, 0, 0, timer);
+    KTRACE_CALL_PREV(timer_exit, (timer));
+}
+
+static void _ktrace_trytake_hook(struct rt_object *object)
+{
+    _ktrace_put(RT_KTRACE_EVT_OBJ_TRYTAKE, rt_object_get_type(object), 0, object);
+    KTRACE_CALL_PREV(object_trytake, (object));
+}
+
+static void _ktrace_take_hook(struct rt_object *object)
+{
+    _ktrace_put(RT_KTRACE_EVT_OBJ_TAKE, rt_object_get_type(object), 0, object);
+    KTRACE_CALL_PREV(object_take, (object));
+}
+
+static void _ktrace_put_hook(struct rt_object *object)
+{
+    _ktrace_put(RT_KTRACE_EVT_OBJ_PUT, rt_object_get_type(object), 0, object);
+    KTRACE_CALL_PREV(object_put, (object));
+}
+
+#ifdef RT_USING_MEMPOOL
+static void _ktrace_mp_alloc_hook(struct rt_mempool *mp, void *block)
+{
+    _ktrace_put(RT_KTRACE_EVT_MP_ALLOC, 0, 0, mp);
+    KTRACE_CALL_PREV(mp_alloc, (mp, block));
+}
+
+static void _ktrace_mp_free_hook(struct rt_mempool *mp, void *block)
+{
+    _ktrace_put(RT_KTRACE_EVT_MP_FREE, 0, 0, mp);
+    KTRACE_CALL_PREV(mp_free, (mp, block));
+}
+#endif /* RT_USING_MEMPOOL */
+
+/* take a hook over and keep the one which was set before */
+#define KTRACE_TAKE_HOOK(name, hook)                        \
+    do                                                      \
+    {                                                       \
+        _ktrace_prev_hook.name = rt_##name##_gethook();     \
+        rt_##name##_sethook(hook);                          \
+    } while (0)
+
+/* give a hook back unless someone else has set it since */
+#define KTRACE_RESTORE_HOOK(name, hook)                     \
+    do                                                      \
+    {                                                       \
+        if (rt_##name##_gethook() == hook)                  \
+            rt_##name##_sethook(_ktrace_prev_hook.name);    \
+    } while (0)
+
+static void _ktrace_sethook(rt_bool_t enable)
+{
+    if (enable)
+    {
+        KTRACE_TAKE_HOOK(scheduler, _ktrace_scheduler_hook);
+        KTRACE_TAKE_HOOK(thread_suspend, _ktrace_suspend_hook);
+        KTRACE_TAKE_HOOK(thread_resume, _ktrace_resume_hook);
+        KTRACE_TAKE_HOOK(interrupt_enter, _ktrace_irq_enter_hook);
+        KTRACE_TAKE_HOOK(interrupt_leave, _ktrace_irq_leave_hook);
+        KTRACE_TAKE_HOOK(timer_enter, _ktrace_timer_enter_hook);
+        KTRACE_TAKE_HOOK(timer_exit, _ktrace_timer_exit_hook);
+        KTRACE_TAKE_HOOK(object_trytake, _ktrace_trytake_hook);
+        KTRACE_TAKE_HOOK(object_take, _ktrace_take_hook);
+        KTRACE_TAKE_HOOK(object_put, _ktrace_put_hook);
+#ifdef RT_USING_MEMPOOL
+        KTRACE_TAKE_HOOK(mp_alloc, _ktrace_mp_alloc_hook);
+        KTRACE_TAKE_HOOK(mp_free, _ktrace_mp_free_hook);
+#endif
+    }
+    else
+    {
+        KTRACE_RESTORE_HOOK(scheduler, _ktrace_scheduler_hook);
+        KTRACE_RESTORE_HOOK(thread_suspend, _ktrace_suspend_hook);
+        KTRACE_RESTORE_HOOK(thread_resume, _ktrace_resume_hook);
+        KTRACE_RESTORE_HOOK(interrupt_enter, _ktrace_irq_enter_hook);
+        KTRACE_RESTORE_HOOK(interrupt_leave, _ktrace_irq_leave_hook);
+        KTRACE_RESTORE_HOOK(timer_enter, _ktrace_timer_enter_hook);
+        KTRACE_RESTORE_HOOK(timer_exit, _ktrace_timer_exit_hook);
+        KTRACE_RESTORE_HOOK(object_trytake, _ktrace_trytake_hook);
+        KTRACE_RESTORE_HOOK(object_take, _ktrace_take_hook);
+        KTRACE_RESTORE_HOOK(object_put, _ktrace_put_hook);
+#ifdef RT_USING_MEMPOOL
+        KTRACE_RESTORE_HOOK(mp_alloc, _ktrace_mp_alloc_hook);
+        KTRACE_RESTORE_HOOK(mp_free, _ktrace_mp_free_hook);
+#endif
+    }
+}
+
+/**
+ * @brief This function will start recording kernel events. The scheduler,
+ *        thread, interrupt, timer, object and memory pool hooks are taken
+ *        over by the tracer until rt_ktrace_stop() is called. The hooks set
+ *        before are still called after each record.
+ *
+ * @return RT_EOK on success, -RT_EBUSY if the tracer is already running.
+ */
+rt_err_t rt_ktrace_start(void)
+{
+    if (_ktrace_running)
+        return -RT_EBUSY;
+
+#ifdef RT_USING_CPUTIME
+    /* fall back to OS tick when there is no cputime ops */
+    _ktrace_use_cputime = (clock_cpu_getres() != 0);
+#endif
+    _ktrace_running = RT_TRUE;
+    _ktrace_sethook(RT_TRUE);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief This function will stop recording and give the hooks back to
+ *        their previous owners.
+ *
+ * @return RT_EOK on success, -RT_ERROR if the tracer is not running.
+ */
+rt_err_t rt_ktrace_stop(void)
+{
+    if (!_ktrace_running)
+        return -RT_ERROR;
+
+    _ktrace_sethook(RT_FALSE);
+    _ktrace_running = RT_FALSE;
+
+    return RT_EOK;
+}
+
+/**
+ * @brief This function will drop all the records.
+ */
+void rt_ktrace_clear(void)
+{
+    rt_base_t level;
+    int cpu;
+
+    level = rt_hw_local_irq_disable();
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+    {
+        _ktrace_ring[cpu].head = 0;
+    }
+    rt_hw_local_irq_enable(level);
+}
+
+rt_bool_t rt_ktrace_is_running(void)
+{
+    return _ktrace_running;
+}
+
+static void _ktrace_section(rt_ktrace_output_t output, void *parameter,
+                            rt_uint16_t tag, rt_size_t length)
+{
+    struct rt_ktrace_section section;
+
+    section.tag = tag;
+    section.length = (rt_uint16_t)length;
+    output(&section, sizeof(section), parameter);
+}
+
+static void _ktrace_dump_names(rt_ktrace_output_t output, void *parameter)
+{
+#ifdef RT_USING_HEAP
+    static const rt_uint8_t classes[] =
+    {
+        RT_Object_Class_Thread, RT_Object_Class_Semaphore, RT_Object_Class_Mutex,
+        RT_Object_Class_Event, RT_Object_Class_MailBox, RT_Object_Class_MessageQueue,
+        RT_Object_Class_MemPool, RT_Object_Class_Timer,
+    };
+    rt_object_t *objects;
+    rt_uint32_t address;
+    int index, count, i;
+
+    for (index = 0; index < sizeof(classes) / sizeof(classes[0]); index ++)
+    {
+        count = rt_object_get_length((enum rt_object_class_type)classes[index]);
+        if (count <= 0)
+            continue;
+
+        objects = (rt_object_t *)rt_malloc(count * sizeof(rt_object_t));
+        if (objects == RT_NULL)
+        {
+            LOG_W("no memory for the names of class %d", classes[index]);
+            continue;
+        }
+
+        count = rt_object_get_pointers((enum rt_object_class_type)classes[index], objects, count);
+        for (i = 0; i < count; i ++)
+        {
+            address = (rt_uint32_t)(rt_ubase_t)objects[i];
+            _ktrace_section(output, parameter, RT_KTRACE_TAG_NAME,
+                            sizeof(address) + sizeof(rt_uint8_t) + RT_NAME_MAX);
+            output(&address, sizeof(address), parameter);
+            output(&classes[index], sizeof(rt_uint8_t), parameter);
+            output(objects[i]->name, RT_NAME_MAX, parameter);
+        }
+
+        rt_free(objects);
+    }
+#endif /* RT_USING_HEAP */
+}
+
+static void _ktrace_dump_records(rt_ktrace_output_t output, void *parameter, rt_uint32_t cpu)
+{
+    struct ktrace_ring *ring = &_ktrace_ring[cpu];
+    rt_uint32_t count, lost, start, chunk, index;
+
+    count = ring->head;
+    lost = 0;
+    if (count > RT_KTRACE_RECORDS)
+    {
+        lost = count - RT_KTRACE_RECORDS;
+        count = RT_KTRACE_RECORDS;
+    }
+    start = ring->head - count;
+
+    do
+    {
+        chunk = count > KTRACE_RECORDS_PER_SECTION ? KTRACE_RECORDS_PER_SECTION : count;
+        _ktrace_section(output, parameter, RT_KTRACE_TAG_RECORDS,
+                        2 * sizeof(rt_uint32_t) + chunk * sizeof(struct rt_ktrace_record));
+        output(&cpu, sizeof(cpu), parameter);
+        output(&lost, sizeof(lost), parameter);
+
+        count -= chunk;
+        lost = 0;
+        /* output the records in chronological order */
+        while (chunk)
+        {
+            index = start & (RT_KTRACE_RECORDS - 1);
+            if (index + chunk > RT_KTRACE_RECORDS)
+            {
+                output(&ring->records[index], (RT_KTRACE_RECORDS - index) * sizeof(struct rt_ktrace_record), parameter);
+                start += RT_KTRACE_RECORDS - index;
+                chunk -= RT_KTRACE_RECORDS - index;
+            }
+            else
+            {
+                output(&ring->records[index], chunk * sizeof(struct rt_ktrace_record), parameter);
+                start += chunk;
+                chunk = 0;
+            }
+        }
+    } while (count);
+}
+
+/**
+ * @brief This function will serialize the recorded events through the output
+ *        function, see ktrace2json.py for the decoder.
+ *
+ * @param output is the function to write a piece of the dump.
+ *
+ * @param parameter is the parameter of the output function.
+ *
+ * @return RT_EOK on success, -RT_EBUSY if the tracer is still running.
+ */
+rt_err_t rt_ktrace_dump(rt_ktrace_output_t output, void *parameter)
+{
+    rt_uint32_t header[2];
+    rt_uint32_t info[4];
+    rt_uint64_t resolution;
+    rt_uint32_t cpu;
+
+    RT_ASSERT(output != RT_NULL);
+
+    if (_ktrace_running)
+        return -RT_EBUSY;
+
+    /* nanosecond per timestamp tick (x (1000UL * 1000)) */
+    resolution = (rt_uint64_t)(1000UL * 1000 * 1000 / RT_TICK_PER_SECOND) * 1000UL * 1000;
+#ifdef RT_USING_CPUTIME
+    if (_ktrace_use_cputime)
+        resolution = clock_cpu_getres();
+#endif
+
+    header[0] = RT_KTRACE_MAGIC;
+    header[1] = RT_KTRACE_VERSION | (sizeof(struct rt_ktrace_record) << 16);
+    output(header, sizeof(header), parameter);
+
+    info[0] = RT_CPUS_NR;
+    info[1] = RT_NAME_MAX;
+    rt_memcpy(&info[2], &resolution, sizeof(resolution));
+    _ktrace_section(output, parameter, RT_KTRACE_TAG_INFO, sizeof(info));
+    output(info, sizeof(info), parameter);
+
+    _ktrace_dump_names(output, parameter);
+
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+    {
+        _ktrace_dump_records(output, parameter, cpu);
+    }
+
+    _ktrace_section(output, parameter, RT_KTRACE_TAG_END, 0);
+
+    return RT_EOK;
+}
+
+#if defined(RT_USING_FINSH)
+#define KTRACE_HEX_LINE 32
+
+struct ktrace_hex
+{
+    rt_uint8_t line[KTRACE_HEX_LINE];
+    rt_size_t  used;
+};
+
+static void _ktrace_hex_flush(struct ktrace_hex *hex)
+{
+    rt_size_t i;
+
+    for (i = 0; i < hex->used; i ++)
+    {
+        rt_kprintf("%02x", hex->line[i]);
+    }
+    rt_kprintf("\n");
+    hex->used = 0;
+}
+
+static void _ktrace_hex_output(const void *buf, rt_size_t size, void *parameter)
+{
+    struct ktrace_hex *hex = (struct ktrace_hex *)parameter;
+    const rt_uint8_t *ptr = (const rt_uint8_t *)buf;
+
+    while (size --)
+    {
+        hex->line[hex->used ++] = *ptr ++;
+        if (hex->used == KTRACE_HEX_LINE)
+            _ktrace_hex_flush(hex);
+    }
+}
+
+#ifdef DFS_USING_POSIX
+static void _ktrace_file_output(const void *buf, rt_size_t size, void *parameter)
+{
+    write(*(int *)parameter, buf, size);
+}
+#endif /* DFS_USING_POSIX */
+
+static void _ktrace_status(void)
+{
+    rt_uint32_t cpu, head;
+
+    rt_kprintf("ktrace is %s, clock: %s\n", _ktrace_running ? "running" : "stopped",
+               _ktrace_use_cputime ? "cputime" : "tick");
+    for (cpu = 0; cpu < RT_CPUS_NR; cpu ++)
+    {
+        head = _ktrace_ring[cpu].head;
+        rt_kprintf("cpu%d: %d records, %d overwritten\n", cpu,
+                   head > RT_KTRACE_RECORDS ? RT_KTRACE_RECORDS : head,
+                   head > RT_KTRACE_RECORDS ? head - RT_KTRACE_RECORDS : 0);
+    }
+}
+
+static int ktrace(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        goto _usage;
+    }
+
+    if (!rt_strcmp(argv[1], "start"))
+    {
+        if (rt_ktrace_start() != RT_EOK)
+            rt_kprintf("ktrace is already running\n");
+    }
+    else if (!rt_strcmp(argv[1], "stop"))
+    {
+        if (rt_ktrace_stop() != RT_EOK)
+            rt_kprintf("ktrace is not running\n");
+    }
+    else if (!rt_strcmp(argv[1], "clear"))
+    {
+        rt_ktrace_clear();
+    }
+    else if (!rt_strcmp(argv[1], "status"))
+    {
+        _ktrace_status();
+    }
+    else if (!rt_strcmp(argv[1], "dump"))
+    {
+        /* the dump shall not trace itself */
+        if (rt_ktrace_stop() == RT_EOK)
+            rt_kprintf("ktrace stopped\n");
+
+        if (argc > 2)
+        {
+#ifdef DFS_USING_POSIX
+            int fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                rt_kprintf("open %s failed\n", argv[2]);
+                return -RT_ERROR;
+            }
+            rt_ktrace_dump(_ktrace_file_output, &fd);
+            close(fd);
+#else
+            rt_kprintf("dump to file requires DFS_USING_POSIX\n");
+            return -RT_ERROR;
+#endif /* DFS_USING_POSIX */
+        }
+        else
+        {
+            struct ktrace_hex hex;
+
+            hex.used = 0;
+            rt_kprintf("--- ktrace begin ---\n");
+            rt_ktrace_dump(_ktrace_hex_output, &hex);
+            if (hex.used)
+                _ktrace_hex_flush(&hex);
+            rt_kprintf("--- ktrace end ---\n");
+        }
+    }
+    else
+    {
+        goto _usage;
+    }
+
+    return RT_EOK;
+
+_usage:
+    rt_kprintf("Usage:\n");
+    rt_kprintf("ktrace start       - start recording kernel events\n");
+    rt_kprintf("ktrace stop        - stop recording\n");
+    rt_kprintf("ktrace clear       - drop all the records\n");
+    rt_kprintf("ktrace status      - show the recorder status\n");
+    rt_kprintf("ktrace dump [file] - dump the records as hex to console, or to a binary file\n");
+    return -RT_ERROR;
+}
+MSH_CMD_EXPORT(ktrace, kernel event tracer: ktrace start|stop|clear|status|dump [file]);
+#endif /* RT_USING_FINSH */
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    first version
+ */
+
+#ifndef __KTRACE_H__
+#define __KTRACE_H__
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RT_KTRACE_RECORDS
+#define RT_KTRACE_RECORDS               512
+#endif
+
+#if (RT_KTRACE_RECORDS & (RT_KTRACE_RECORDS - 1)) != 0
+#error "RT_KTRACE_RECORDS must be a power of 2"
+#endif
+
+/* a dump starts with the 'KTRC' magic, the version and the record size (rt_uint32_t, rt_uint16_t, rt_uint16_t) */
+#define RT_KTRACE_MAGIC                 0x4352544B
+#define RT_KTRACE_VERSION               1
+
+/* event types of a trace record */
+enum rt_ktrace_event
+{
+    RT_KTRACE_EVT_SWITCH = 1,           /**< object: to thread, param8: its priority, param16: from priority */
+    RT_KTRACE_EVT_SUSPEND,              /**< object: thread, param8: its priority */
+    RT_KTRACE_EVT_RESUME,               /**< object: thread, param8: its priority */
+    RT_KTRACE_EVT_IRQ_ENTER,            /**< param8: nest, param16: exception number */
+    RT_KTRACE_EVT_IRQ_LEAVE,            /**< param8: nest, param16: exception number */
+    RT_KTRACE_EVT_TIMER_ENTER,          /**< object: timer */
+    RT_KTRACE_EVT_TIMER_EXIT,           /**< object: timer */
+    RT_KTRACE_EVT_OBJ_TRYTAKE,          /**< object: ipc object, param8: object class */
+    RT_KTRACE_EVT_OBJ_TAKE,             /**< object: ipc object, param8: object class */
+    RT_KTRACE_EVT_OBJ_PUT,              /**< object: ipc object, param8: object class */
+    RT_KTRACE_EVT_MP_ALLOC,             /**< object: memory pool */
+    RT_KTRACE_EVT_MP_FREE,              /**< object: memory pool */
+};
+
+/* tags of the sections in a dump, each section is {tag, length, payload} */
+enum rt_ktrace_tag
+{
+    RT_KTRACE_TAG_END = 0,              /**< end of dump */
+    RT_KTRACE_TAG_INFO,                 /**< rt_uint32_t cpus, rt_uint32_t name_max, rt_uint64_t resolution */
+    RT_KTRACE_TAG_NAME,                 /**< rt_uint32_t object, rt_uint8_t class, char name[] */
+    RT_KTRACE_TAG_RECORDS,              /**< rt_uint32_t cpu, rt_uint32_t lost, struct rt_ktrace_record[] */
+};
+
+struct rt_ktrace_record
+{
+    rt_uint32_t timestamp;              /**< low 32 bits of the cputime (or OS tick) */
+    rt_uint8_t  event;                  /**< enum rt_ktrace_event */
+    rt_uint8_t  param8;
+    rt_uint16_t param16;
+    rt_uint32_t object;                 /**< low 32 bits of the object address */
+};
+
+struct rt_ktrace_section
+{
+    rt_uint16_t tag;
+    rt_uint16_t length;                 /**< length of the payload followed */
+};
+
+typedef void (*rt_ktrace_output_t)(const void *buf, rt_size_t size, void *parameter);
+
+rt_err_t rt_ktrace_start(void);
+rt_err_t rt_ktrace_stop(void);
+void rt_ktrace_clear(void);
+rt_bool_t rt_ktrace_is_running(void);
+rt_err_t rt_ktrace_dump(rt_ktrace_output_t output, void *parameter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __KTRACE_H__ */
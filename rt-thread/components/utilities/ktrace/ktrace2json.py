@@ -0,0 +1,266 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) 2006-2026, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-16     RT-Thread    first version
+#
+# Convert a ktrace dump into a Chrome/Perfetto JSON timeline.
+#
+# The input is either the binary file written by 'ktrace dump <file>', or a
+# console log which contains the hex lines printed by 'ktrace dump'. Open the
+# output in chrome://tracing or https://ui.perfetto.dev.
+#
+# usage: ktrace2json.py [-o trace.json] [--summary] <dump>
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+KTRACE_MAGIC = 0x4352544B
+
+TAG_END = 0
+TAG_INFO = 1
+TAG_NAME = 2
+TAG_RECORDS = 3
+
+EVT_SWITCH = 1
+EVT_SUSPEND = 2
+EVT_RESUME = 3
+EVT_IRQ_ENTER = 4
+EVT_IRQ_LEAVE = 5
+EVT_TIMER_ENTER = 6
+EVT_TIMER_EXIT = 7
+EVT_OBJ_TRYTAKE = 8
+EVT_OBJ_TAKE = 9
+EVT_OBJ_PUT = 10
+EVT_MP_ALLOC = 11
+EVT_MP_FREE = 12
+
+OBJECT_EVENTS = {
+    EVT_OBJ_TRYTAKE: 'trytake',
+    EVT_OBJ_TAKE: 'take',
+    EVT_OBJ_PUT: 'put',
+    EVT_MP_ALLOC: 'mp_alloc',
+    EVT_MP_FREE: 'mp_free',
+}
+
+CLASS_NAMES = {
+    1: 'thread', 2: 'sem', 3: 'mutex', 4: 'event', 5: 'mailbox',
+    6: 'mq', 8: 'mempool', 10: 'timer',
+}
+
+EXCEPTION_NAMES = {
+    2: 'NMI', 3: 'HardFault', 4: 'MemManage', 5: 'BusFault',
+    6: 'UsageFault', 11: 'SVCall', 12: 'DebugMon', 14: 'PendSV', 15: 'SysTick',
+}
+
+# the reserved tids for the non-thread tracks of a cpu
+TID_IRQ = 1
+TID_TIMER = 2
+
+
+def load(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if len(data) >= 4 and struct.unpack_from('<I', data)[0] == KTRACE_MAGIC:
+        return data
+
+    # console log, take the hex lines between the markers
+    text = data.decode('utf-8', errors='ignore')
+    inside = False
+    hexdata = []
+    for line in text.splitlines():
+        line = line.strip()
+        if line.endswith('--- ktrace begin ---'):
+            inside, hexdata = True, []
+        elif line.endswith('--- ktrace end ---'):
+            inside = False
+        elif inside and re.fullmatch(r'[0-9a-fA-F]+', line):
+            hexdata.append(line)
+    if not hexdata:
+        raise ValueError('no ktrace dump found in %s' % path)
+    return bytes.fromhex(''.join(hexdata))
+
+
+def parse(data):
+    magic, version, record_size = struct.unpack_from('<IHH', data, 0)
+    if magic != KTRACE_MAGIC:
+        raise ValueError('bad magic 0x%08x' % magic)
+    if version != 1 or record_size != 12:
+        raise ValueError('unsupported dump version %d, record size %d' % (version, record_size))
+
+    dump = {'resolution': 0, 'names': {}, 'records': {}, 'lost': {}}
+    offset = 8
+    while offset + 4 <= len(data):
+        tag, length = struct.unpack_from('<HH', data, offset)
+        offset += 4
+        payload = data[offset:offset + length]
+        offset += length
+
+        if tag == TAG_END:
+            break
+        elif tag == TAG_INFO:
+            _, name_max, dump['resolution'] = struct.unpack_from('<IIQ', payload)
+        elif tag == TAG_NAME:
+            address, cls = struct.unpack_from('<IB', payload)
+            name = payload[5:].split(b'\0', 1)[0].decode('utf-8', errors='replace')
+            dump['names'][address] = (name, cls)
+        elif tag == TAG_RECORDS:
+            cpu, lost = struct.unpack_from('<II', payload)
+            dump['lost'][cpu] = dump['lost'].get(cpu, 0) + lost
+            records = dump['records'].setdefault(cpu, [])
+            for i in range(8, len(payload) - 11, 12):
+                records.append(struct.unpack_from('<IBBHI', payload, i))
+    return dump
+
+
+def irq_name(number):
+    if number >= 16:
+        return 'IRQ%d' % (number - 16)
+    return EXCEPTION_NAMES.get(number, 'exception%d' % number)
+
+
+class Timeline:
+    def __init__(self, dump):
+        self.dump = dump
+        self.events = []
+        # nanosecond per tick (x 1000000) to microsecond per tick
+        self.scale = dump['resolution'] / 1e9
+        self.irq_stat = {}
+
+    def name(self, address):
+        if address in self.dump['names']:
+            return self.dump['names'][address][0]
+        return '0x%08x' % address
+
+    def object_name(self, address, cls):
+        return '%s %s' % (CLASS_NAMES.get(cls, 'object'), self.name(address))
+
+    def complete(self, pid, tid, name, begin, end, cat, args=None):
+        event = {'ph': 'X', 'pid': pid, 'tid': tid, 'name': name, 'cat': cat,
+                 'ts': begin, 'dur': max(end - begin, 0)}
+        if args:
+            event['args'] = args
+        self.events.append(event)
+
+    def instant(self, pid, tid, name, ts, cat, args=None):
+        event = {'ph': 'i', 's': 't', 'pid': pid, 'tid': tid, 'name': name, 'cat': cat, 'ts': ts}
+        if args:
+            event['args'] = args
+        self.events.append(event)
+
+    def metadata(self, pid, tid, key, value):
+        event = {'ph': 'M', 'pid': pid, 'name': key, 'args': {'name': value}}
+        if tid is not None:
+            event['tid'] = tid
+        self.events.append(event)
+
+    def convert_cpu(self, cpu, records):
+        pid = cpu
+        threads = set()
+        self.metadata(pid, None, 'process_name', 'CPU%d' % cpu)
+        self.metadata(pid, TID_IRQ, 'thread_name', 'interrupts')
+        self.metadata(pid, TID_TIMER, 'thread_name', 'timers')
+
+        ticks = 0
+        last = None
+        running = None          # (thread, priority, since)
+        irqs = []               # stack of (number, since)
+        timers = {}
+        ts = 0
+
+        for timestamp, event, param8, param16, obj in records:
+            # unwrap the 32 bits timestamp
+            if last is not None:
+                ticks += (timestamp - last) & 0xFFFFFFFF
+            last = timestamp
+            ts = ticks * self.scale
+
+            if event == EVT_SWITCH:
+                if running:
+                    thread, prio, since = running
+                    self.complete(pid, thread, self.name(thread), since, ts, 'sched',
+                                  {'priority': prio})
+                running = (obj, param8, ts)
+                threads.add(obj)
+            elif event in (EVT_SUSPEND, EVT_RESUME):
+                threads.add(obj)
+                self.instant(pid, obj, 'suspend' if event == EVT_SUSPEND else 'resume', ts,
+                             'sched', {'priority': param8})
+            elif event == EVT_IRQ_ENTER:
+                irqs.append((param16, ts))
+            elif event == EVT_IRQ_LEAVE:
+                if irqs:
+                    number, since = irqs.pop()
+                    self.complete(pid, TID_IRQ, irq_name(number), since, ts, 'irq')
+                    count, total, worst = self.irq_stat.get(number, (0, 0.0, 0.0))
+                    self.irq_stat[number] = (count + 1, total + ts - since, max(worst, ts - since))
+            elif event == EVT_TIMER_ENTER:
+                timers[obj] = ts
+            elif event == EVT_TIMER_EXIT:
+                if obj in timers:
+                    self.complete(pid, TID_TIMER, self.name(obj), timers.pop(obj), ts, 'timer')
+            elif event in OBJECT_EVENTS:
+                if irqs:
+                    tid = TID_IRQ
+                elif running:
+                    tid = running[0]
+                else:
+                    continue
+                cls = param8 if event not in (EVT_MP_ALLOC, EVT_MP_FREE) else 8
+                self.instant(pid, tid, '%s %s' % (OBJECT_EVENTS[event], self.object_name(obj, cls)),
+                             ts, 'ipc')
+
+        # close what is still in progress at the end of the trace
+        if running:
+            thread, prio, since = running
+            self.complete(pid, thread, self.name(thread), since, ts, 'sched', {'priority': prio})
+        for number, since in irqs:
+            self.complete(pid, TID_IRQ, irq_name(number), since, ts, 'irq')
+
+        for thread in threads:
+            self.metadata(pid, thread, 'thread_name', self.name(thread))
+
+    def convert(self):
+        for cpu, records in sorted(self.dump['records'].items()):
+            self.convert_cpu(cpu, records)
+        return {'traceEvents': self.events, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='convert a ktrace dump into a Chrome/Perfetto JSON timeline')
+    parser.add_argument('dump', help='binary dump, or a console log with the hex dump')
+    parser.add_argument('-o', '--output', help='output JSON file, default stdout')
+    parser.add_argument('--summary', action='store_true', help='print interrupt statistics to stderr')
+    args = parser.parse_args()
+
+    dump = parse(load(args.dump))
+    timeline = Timeline(dump)
+    trace = timeline.convert()
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+    for cpu, lost in sorted(dump['lost'].items()):
+        if lost:
+            sys.stderr.write('cpu%d: %d records overwritten before the dump\n' % (cpu, lost))
+
+    if args.summary:
+        sys.stderr.write('%-12s %8s %12s %12s\n' % ('interrupt', 'count', 'avg(us)', 'max(us)'))
+        for number, (count, total, worst) in sorted(timeline.irq_stat.items(), key=lambda x: -x[1][2]):
+            sys.stderr.write('%-12s %8d %12.2f %12.2f\n' % (irq_name(number), count, total / count, worst))
+
+
+if __name__ == '__main__':
+    main()
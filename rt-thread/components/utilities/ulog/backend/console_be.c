@@ -26,10 +26,30 @@ void ulog_console_backend_output(struct ulog_backend *backend, rt_uint32_t level
 
 }
 
+#if defined(ULOG_USING_DEFERRED) && defined(RT_USING_DEVICE)
+static void ulog_console_backend_output_bin(struct ulog_backend *backend, const void *buf, rt_size_t len)
+{
+    rt_device_t dev = rt_console_get_device();
+
+    if (dev)
+    {
+        rt_uint16_t open_flag = dev->open_flag;
+
+        /* the record is binary, do not insert '\r' before its '\n' bytes */
+        dev->open_flag &= ~RT_DEVICE_FLAG_STREAM;
+        rt_device_write(dev, 0, buf, len);
+        dev->open_flag = open_flag;
+    }
+}
+#endif /* defined(ULOG_USING_DEFERRED) && defined(RT_USING_DEVICE) */
+
 int ulog_console_backend_init(void)
 {
     ulog_init();
     console.output = ulog_console_backend_output;
+#if defined(ULOG_USING_DEFERRED) && defined(RT_USING_DEVICE)
+    console.output_bin = ulog_console_backend_output_bin;
+#endif
 
     ulog_backend_register(&console, "console", RT_TRUE);
 
@@ -74,12 +74,44 @@ __exit:
     return result;
 }
 
-static void ulog_file_backend_flush_with_buf(struct ulog_backend *backend)
+/* the worker of all file backends, the logging thread only copies the logs to the buffer */
+static struct rt_workqueue *ulog_file_worker;
+
+/* hand over the filled half to the writer when the writer is idle, the buffer lock is held */
+static rt_bool_t ulog_file_buf_hand_over(struct ulog_file_be *be)
 {
-    struct ulog_file_be *be = (struct ulog_file_be *) backend;
-    rt_size_t file_size = 0, write_size = 0;
+    rt_uint8_t *buf;
+
+    if (be->write_len != 0 || be->buf_ptr_now == be->file_buf)
+    {
+        return RT_FALSE;
+    }
+
+    buf = be->write_buf;
+    be->write_buf = be->file_buf;
+    be->write_len = (rt_size_t)(be->buf_ptr_now - be->file_buf);
+    be->file_buf = buf;
+    be->buf_ptr_now = buf;
+
+    return RT_TRUE;
+}
+
+/**
+ * write the half which is handed over to the file, the file lock is held
+ *
+ * @param can_rotate RT_TRUE: called by the worker, RT_FALSE: the worker rotates the full file later
+ */
+static void ulog_file_write(struct ulog_file_be *be, rt_bool_t can_rotate)
+{
+    rt_size_t file_size = 0;
+    rt_tick_t tick;
 
-    if (be->enable == RT_FALSE || be->buf_ptr_now == be->file_buf)
+    if (be->enable == RT_FALSE)
+    {
+        return;
+    }
+    /* nothing to write, but the worker still rotates the file a flush found full */
+    if (be->write_len == 0 && (can_rotate == RT_FALSE || be->cur_log_file_fd < 0))
     {
         return;
     }
@@ -96,6 +128,7 @@ static void ulog_file_backend_flush_with_buf(struct ulog_backend *backend)
         if (be->cur_log_file_fd < 0)
         {
             rt_kprintf("ulog file(%s) open failed.", be->cur_log_file_path);
+            be->stat.write_errors++;
             return;
         }
     }
@@ -103,23 +136,96 @@ static void ulog_file_backend_flush_with_buf(struct ulog_backend *backend)
     file_size = lseek(be->cur_log_file_fd, 0, SEEK_END);
     if (file_size >= (be->file_max_size - be->buf_size * 2))
     {
-        if (!ulog_file_rotate(be))
+        if (can_rotate)
         {
-            return;
+            be->stat.rotations++;
+            if (!ulog_file_rotate(be))
+            {
+                be->stat.write_errors++;
+                return;
+            }
+        }
+        else
+        {
+            rt_workqueue_submit_work(ulog_file_worker, &be->flush_work, 0);
         }
     }
+    if (be->write_len == 0)
+    {
+        return;
+    }
 
-    write_size = (rt_size_t)(be->buf_ptr_now - be->file_buf);
+    tick = rt_tick_get();
     /* write to the file */
-    if (write(be->cur_log_file_fd, be->file_buf, write_size) != write_size)
+    if (write(be->cur_log_file_fd, be->write_buf, be->write_len) != be->write_len)
     {
+        be->stat.write_errors++;
         return;
     }
     /* flush file cache */
     fsync(be->cur_log_file_fd);
+    tick = rt_tick_get() - tick;
 
-    /* point be->buf_ptr_now at the head of be->file_buf[be->buf_size] */
-    be->buf_ptr_now = be->file_buf;
+    be->stat.writes++;
+    be->stat.write_bytes += be->write_len;
+    if (tick > be->stat.write_max_ticks)
+    {
+        be->stat.write_max_ticks = tick;
+    }
+
+    /* the writer is idle */
+    rt_mutex_take(&be->buf_lock, RT_WAITING_FOREVER);
+    be->write_len = 0;
+    rt_mutex_release(&be->buf_lock);
+}
+
+/**
+ * write the half which is handed over and the half which is filling now
+ *
+ * @param count the flush counter of the reason
+ * @param can_rotate RT_TRUE: called by the worker
+ */
+static void ulog_file_flush(struct ulog_file_be *be, rt_uint32_t *count, rt_bool_t can_rotate)
+{
+    rt_bool_t handed_over;
+
+    rt_mutex_take(&be->file_lock, RT_WAITING_FOREVER);
+    ulog_file_write(be, can_rotate);
+
+    rt_mutex_take(&be->buf_lock, RT_WAITING_FOREVER);
+    handed_over = ulog_file_buf_hand_over(be);
+    rt_mutex_release(&be->buf_lock);
+    if (handed_over)
+    {
+        (*count)++;
+        ulog_file_write(be, can_rotate);
+    }
+    rt_mutex_release(&be->file_lock);
+}
+
+static void ulog_file_work(struct rt_work *work, void *work_data)
+{
+    struct ulog_file_be *be = (struct ulog_file_be *)work_data;
+
+    if (work == &be->age_work)
+    {
+        /* the oldest log in the buffer is too old */
+        ulog_file_flush(be, &be->stat.flush_by_age, RT_TRUE);
+    }
+    else
+    {
+        /* the full half, or the file which needs rotating */
+        rt_mutex_take(&be->file_lock, RT_WAITING_FOREVER);
+        ulog_file_write(be, RT_TRUE);
+        rt_mutex_release(&be->file_lock);
+    }
+}
+
+static void ulog_file_backend_flush_with_buf(struct ulog_backend *backend)
+{
+    struct ulog_file_be *be = (struct ulog_file_be *) backend;
+
+    ulog_file_flush(be, &be->stat.flush_by_user, RT_FALSE);
 }
 
 static void ulog_file_backend_output_with_buf(struct ulog_backend *backend, rt_uint32_t level,
@@ -127,10 +233,16 @@ static void ulog_file_backend_output_with_buf(struct ulog_backend *backend, rt_u
 {
     struct ulog_file_be *be = (struct ulog_file_be *)backend;
     rt_size_t copy_len = 0, free_len = 0;
-    const unsigned char *buf_ptr_end = be->file_buf + be->buf_size;
+    const unsigned char *buf_ptr_end;
+    rt_bool_t was_empty, handed_over = RT_FALSE;
+    /* write it now, it may be the last log before a crash */
+    rt_bool_t sync = !is_raw && level <= ULOG_FILE_BACKEND_FLUSH_LVL;
 
+    rt_mutex_take(&be->buf_lock, RT_WAITING_FOREVER);
+    was_empty = (be->buf_ptr_now == be->file_buf);
     while (len)
     {
+        buf_ptr_end = be->file_buf + be->buf_size / 2;
         /* free space length */
         free_len = buf_ptr_end - be->buf_ptr_now;
         /* copy the log to the mem buffer */
@@ -152,40 +264,110 @@ static void ulog_file_backend_output_with_buf(struct ulog_backend *backend, rt_u
         /* check the log buffer remain size */
         if (buf_ptr_end == be->buf_ptr_now)
         {
-            ulog_file_backend_flush_with_buf(backend);
-            if (buf_ptr_end == be->buf_ptr_now)
+            if (!ulog_file_buf_hand_over(be))
             {
-                /* There is no space, indicating that the data cannot be refreshed
-                   to the back end of the file Discard data and exit directly */
-                break;
+                if (!sync)
+                {
+                    /* the other half is not written yet, discard the rest of the log */
+                    be->stat.drop_bytes += len;
+                    break;
+                }
+                /* never drop the log which is written now, make room by writing both halves */
+                rt_mutex_release(&be->buf_lock);
+                ulog_file_flush(be, &be->stat.flush_by_level, RT_FALSE);
+                rt_mutex_take(&be->buf_lock, RT_WAITING_FOREVER);
+                if (be->buf_ptr_now == buf_ptr_end)
+                {
+                    /* the file is not writable */
+                    be->stat.drop_bytes += len;
+                    break;
+                }
+                continue;
             }
+            be->stat.flush_by_size++;
+            handed_over = RT_TRUE;
+            was_empty = RT_TRUE;
         }
     }
+    /* the age of the buffer starts at its first log */
+    was_empty = was_empty && be->buf_ptr_now != be->file_buf;
+    rt_mutex_release(&be->buf_lock);
+
+    if (handed_over)
+    {
+        rt_workqueue_submit_work(ulog_file_worker, &be->flush_work, 0);
+    }
+    if (was_empty)
+    {
+        rt_workqueue_submit_work(ulog_file_worker, &be->age_work,
+                rt_tick_from_millisecond(ULOG_FILE_BACKEND_FLUSH_AGE));
+    }
+    if (sync)
+    {
+        ulog_file_flush(be, &be->stat.flush_by_level, RT_FALSE);
+    }
+}
+
+#ifdef ULOG_USING_DEFERRED
+static void ulog_file_backend_output_bin(struct ulog_backend *backend, const void *buf, rt_size_t len)
+{
+    ulog_file_backend_output_with_buf(backend, LOG_LVL_DBG, "", RT_TRUE, (const char *)buf, len);
 }
+#endif /* ULOG_USING_DEFERRED */
 
-/* initialize the ulog file backend */
+/**
+ * initialize the ulog file backend
+ * the logs are collected in the buffer, then the worker writes them when a half of the buffer is full,
+ * when the oldest log is older than ULOG_FILE_BACKEND_FLUSH_AGE, and the level of log is higher than or
+ * equal to ULOG_FILE_BACKEND_FLUSH_LVL, which is written by the logging thread immediately.
+ *
+ * @param buf_size the buffer size, it is split into two halves
+ */
 int ulog_file_backend_init(struct ulog_file_be *be, const char *name, const char *dir_path, rt_size_t max_num,
         rt_size_t max_size, rt_size_t buf_size)
 {
-    be->file_buf = rt_calloc(1, buf_size);
-    if (!be->file_buf)
+    if (ulog_file_worker == RT_NULL)
+    {
+        ulog_file_worker = rt_workqueue_create("ulog_fw", ULOG_FILE_BACKEND_WORKER_STACK,
+                ULOG_FILE_BACKEND_WORKER_PRIORITY);
+        if (ulog_file_worker == RT_NULL)
+        {
+            rt_kprintf("Warning: NO MEMORY for %s file backend worker\n", name);
+            return -RT_ENOMEM;
+        }
+    }
+
+    be->buf = rt_calloc(1, buf_size);
+    if (!be->buf)
     {
         rt_kprintf("Warning: NO MEMORY for %s file backend\n", name);
         return -RT_ENOMEM;
     }
     /* temporarily store the start address of the ulog file buffer */
+    be->file_buf = be->buf;
     be->buf_ptr_now = be->file_buf;
+    be->write_buf = be->buf + buf_size / 2;
+    be->write_len = 0;
     be->cur_log_file_fd = -1;
     be->file_max_num = max_num;
     be->file_max_size = max_size;
     be->buf_size = buf_size;
     be->enable = RT_FALSE;
+    rt_memset(&be->stat, 0, sizeof(be->stat));
     rt_strncpy(be->cur_log_dir_path, dir_path, ULOG_FILE_PATH_LEN);
     /* the buffer length MUST less than file size */
     RT_ASSERT(be->buf_size < be->file_max_size);
 
+    rt_mutex_init(&be->buf_lock, "ulog_fb", RT_IPC_FLAG_PRIO);
+    rt_mutex_init(&be->file_lock, "ulog_ff", RT_IPC_FLAG_PRIO);
+    rt_work_init(&be->flush_work, ulog_file_work, be);
+    rt_work_init(&be->age_work, ulog_file_work, be);
+
     be->parent.output = ulog_file_backend_output_with_buf;
     be->parent.flush = ulog_file_backend_flush_with_buf;
+#ifdef ULOG_USING_DEFERRED
+    be->parent.output_bin = ulog_file_backend_output_bin;
+#endif
     ulog_backend_register((ulog_backend_t) be, name, RT_FALSE);
 
     return 0;
@@ -194,22 +376,31 @@ int ulog_file_backend_init(struct ulog_file_be *be, const char *name, const char
 /* uninitialize the ulog file backend */
 int ulog_file_backend_deinit(struct ulog_file_be *be)
 {
+    ulog_backend_unregister((ulog_backend_t)be);
+
+    /* flush log to file, it may submit the rotation to the worker, so cancel the works after it */
+    ulog_file_backend_flush_with_buf((ulog_backend_t)be);
+    rt_workqueue_cancel_work_sync(ulog_file_worker, &be->age_work);
+    rt_workqueue_cancel_work_sync(ulog_file_worker, &be->flush_work);
+
     if (be->cur_log_file_fd >= 0)
     {
-        /* flush log to file */
-        ulog_file_backend_flush_with_buf((ulog_backend_t)be);
         /* close */
         close(be->cur_log_file_fd);
         be->cur_log_file_fd = -1;
     }
 
-    if (!be->file_buf)
+    if (be->buf)
     {
-        rt_free(be->file_buf);
+        rt_free(be->buf);
+        be->buf = RT_NULL;
         be->file_buf = RT_NULL;
+        be->write_buf = RT_NULL;
     }
 
-    ulog_backend_unregister((ulog_backend_t)be);
+    rt_mutex_detach(&be->buf_lock);
+    rt_mutex_detach(&be->file_lock);
+
     return 0;
 }
 
@@ -223,4 +414,51 @@ void ulog_file_backend_disable(struct ulog_file_be *be)
     be->enable = RT_FALSE;
 }
 
+void ulog_file_backend_stat_reset(struct ulog_file_be *be)
+{
+    rt_mutex_take(&be->file_lock, RT_WAITING_FOREVER);
+    rt_memset(&be->stat, 0, sizeof(be->stat));
+    rt_mutex_release(&be->file_lock);
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void ulog_file(uint8_t argc, char **argv)
+{
+    struct ulog_file_be *be;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Please input: ulog_file <backend name> [reset].\n");
+        return;
+    }
+
+    be = (struct ulog_file_be *)ulog_backend_find(argv[1]);
+    if (be == RT_NULL || be->parent.output != ulog_file_backend_output_with_buf)
+    {
+        rt_kprintf("The file backend %s is not found.\n", argv[1]);
+        return;
+    }
+
+    if (argc > 2 && !rt_strcmp(argv[2], "reset"))
+    {
+        ulog_file_backend_stat_reset(be);
+        return;
+    }
+
+    rt_kprintf("file      : %s/%s.log\n", be->cur_log_dir_path, be->parent.name);
+    rt_kprintf("buffer    : 2 x %d bytes, %d bytes buffered\n", be->buf_size / 2,
+            (int)(be->buf_ptr_now - be->file_buf) + (int)be->write_len);
+    rt_kprintf("flushes   : size %d, age %d, level %d, user %d\n", be->stat.flush_by_size, be->stat.flush_by_age,
+            be->stat.flush_by_level, be->stat.flush_by_user);
+    rt_kprintf("writes    : %d, %d KB, max %d ms, errors %d\n", be->stat.writes,
+            (int)(be->stat.write_bytes / 1024), be->stat.write_max_ticks * 1000 / RT_TICK_PER_SECOND,
+            be->stat.write_errors);
+    rt_kprintf("rotations : %d\n", be->stat.rotations);
+    rt_kprintf("dropped   : %d bytes\n", be->stat.drop_bytes);
+}
+MSH_CMD_EXPORT(ulog_file, Show ulog file backend statistics: ulog_file <backend name> [reset]);
+#endif /* RT_USING_FINSH */
+
 #endif /* ULOG_BACKEND_USING_FILE */
@@ -13,11 +13,49 @@
 #define _ULOG_BE_H_
 
 #include <ulog.h>
+#include <rtdevice.h>
 
 #ifndef ULOG_FILE_PATH_LEN
 #define ULOG_FILE_PATH_LEN   128
 #endif
 
+/* the buffered logs are written when the oldest one is older than it (ms) */
+#ifndef ULOG_FILE_BACKEND_FLUSH_AGE
+#define ULOG_FILE_BACKEND_FLUSH_AGE          1000
+#endif
+
+/* the logs which level is higher than or equal to it are written immediately */
+#ifndef ULOG_FILE_BACKEND_FLUSH_LVL
+#define ULOG_FILE_BACKEND_FLUSH_LVL          LOG_LVL_ERROR
+#endif
+
+/* the worker which writes the buffers and rotates the files */
+#ifndef ULOG_FILE_BACKEND_WORKER_STACK
+#define ULOG_FILE_BACKEND_WORKER_STACK       2048
+#endif
+
+#ifndef ULOG_FILE_BACKEND_WORKER_PRIORITY
+#define ULOG_FILE_BACKEND_WORKER_PRIORITY    (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+
+/* the write statistics of a file backend */
+struct ulog_file_be_stat
+{
+    /* the buffers written when they are full, too old, on a high level log and on ulog_flush() */
+    rt_uint32_t flush_by_size;
+    rt_uint32_t flush_by_age;
+    rt_uint32_t flush_by_level;
+    rt_uint32_t flush_by_user;
+    rt_uint32_t writes;
+    rt_uint64_t write_bytes;
+    /* the longest write and sync of a buffer */
+    rt_tick_t write_max_ticks;
+    rt_uint32_t write_errors;
+    /* the log bytes dropped when both buffers are full */
+    rt_uint32_t drop_bytes;
+    rt_uint32_t rotations;
+};
+
 struct ulog_file_be
 {
     struct ulog_backend parent;
@@ -27,8 +65,19 @@ struct ulog_file_be
     rt_size_t buf_size;
     rt_bool_t enable;
 
+    /* the buffer is split into two halves, the logs are put to one while the other one is written */
+    rt_uint8_t *buf;
     rt_uint8_t *file_buf;
     rt_uint8_t *buf_ptr_now;
+    /* the half which is handed over to the writer, write_len is 0 when the writer is idle */
+    rt_uint8_t *write_buf;
+    rt_size_t write_len;
+    /* buf_lock protects the halves, file_lock protects the file and it is held while writing */
+    struct rt_mutex buf_lock;
+    struct rt_mutex file_lock;
+    struct rt_work flush_work;
+    struct rt_work age_work;
+    struct ulog_file_be_stat stat;
 
     char cur_log_file_path[ULOG_FILE_PATH_LEN];
     char cur_log_dir_path[ULOG_FILE_PATH_LEN];
@@ -40,5 +89,6 @@ int ulog_file_backend_init(struct ulog_file_be *be, const char *name, const char
 int ulog_file_backend_deinit(struct ulog_file_be *be);
 void ulog_file_backend_enable(struct ulog_file_be *be);
 void ulog_file_backend_disable(struct ulog_file_be *be);
+void ulog_file_backend_stat_reset(struct ulog_file_be *be);
 
 #endif /* _ULOG_BE_H_ */
@@ -9,6 +9,7 @@
  */
 
 #include <stdarg.h>
+#include <stddef.h>
 #include "ulog.h"
 #include "rthw.h"
 
@@ -20,17 +21,27 @@
 #include <sys/time.h>
 #endif
 
-#ifdef ULOG_USING_ASYNC_OUTPUT
-#include <rtdevice.h>
-#endif
-
 #ifdef RT_USING_ULOG
 
-/* the number which is max stored line logs */
-#ifndef ULOG_ASYNC_OUTPUT_STORE_LINES
-#define ULOG_ASYNC_OUTPUT_STORE_LINES  (ULOG_ASYNC_OUTPUT_BUF_SIZE * 3 / 2 / 80)
+#ifdef ULOG_USING_ASYNC_OUTPUT
+/* the default async output policy when the buffer is full */
+#if defined(ULOG_ASYNC_OUTPUT_DROP_OLDEST)
+#define ULOG_ASYNC_OUTPUT_POLICY       ULOG_ASYNC_DROP_OLDEST
+#elif defined(ULOG_ASYNC_OUTPUT_BLOCK)
+#define ULOG_ASYNC_OUTPUT_POLICY       ULOG_ASYNC_BLOCK
+#else
+#define ULOG_ASYNC_OUTPUT_POLICY       ULOG_ASYNC_DROP_NEWEST
 #endif
 
+/* the async record state, 0: the record is reserved and being written */
+#define ASYNC_REC_COMMIT               0x01
+#define ASYNC_REC_PAD                  0x02
+#define ASYNC_REC_LEVEL(state)         (((state) >> 4) & 0x07)
+#define ASYNC_REC_SIZE(state)          ((rt_size_t)(state) >> 8)
+/* set on the ring tail while its record is output or dropped */
+#define ASYNC_RING_BUSY                ((rt_atomic_t)1 << 30)
+#endif /* ULOG_USING_ASYNC_OUTPUT */
+
 #ifdef ULOG_USING_COLOR
 /**
  * CSI(Control Sequence Introducer/Initiator) sign
@@ -70,6 +81,32 @@
 #error "the log line buffer size must more than 80"
 #endif
 
+#ifdef ULOG_USING_DEFERRED
+#if !defined(ULOG_USING_ASYNC_OUTPUT) || defined(ULOG_USING_SYSLOG)
+#error "the deferred log needs the async output mode and does not support the syslog format"
+#endif
+#if ULOG_DEFERRED_ARGS_MAX > 255
+#error "the deferred log arguments length must less than 256"
+#endif
+
+/*
+ * a deferred log in the async output buffer, the time and the thread name are only
+ * used to render the text, the binary output starts at the head
+ */
+struct deferred_frame
+{
+#if defined(ULOG_OUTPUT_TIME) && defined(ULOG_TIME_USING_TIMESTAMP)
+    struct timeval time;
+#endif
+#ifdef ULOG_OUTPUT_THREAD_NAME
+    /* "ISR" in the interrupt context */
+    char thread_name[RT_NAME_MAX];
+#endif
+    struct ulog_deferred_record head;
+    rt_uint8_t args[ULOG_DEFERRED_ARGS_MAX];
+};
+#endif /* ULOG_USING_DEFERRED */
+
 struct rt_ulog
 {
     rt_bool_t init_ok;
@@ -88,13 +125,37 @@ struct rt_ulog
 
 #ifdef ULOG_USING_ASYNC_OUTPUT
     rt_bool_t async_enabled;
-    rt_rbb_t async_rbb;
-    /* ringbuffer for log_raw function only */
-    struct rt_ringbuffer *async_rb;
+    /* lock free ring of the async log frames, multi producer and single consumer */
+    struct
+    {
+        rt_uint8_t *buf;
+        rt_size_t size;
+        /*
+         * the positions run freely up to wrap, the largest multiple of the size below
+         * ASYNC_RING_BUSY, so a stale head never matches again before a producer retries
+         */
+        rt_size_t wrap;
+        rt_atomic_t head;
+        rt_atomic_t tail;
+        rt_atomic_t high_water;
+        rt_atomic_t drops[LOG_LVL_DBG + 1];
+        rt_uint8_t policy;
+        /* the threads which wait for the room on ULOG_ASYNC_BLOCK policy */
+        rt_atomic_t waiters;
+        struct rt_semaphore room;
+    } async_ring;
     rt_thread_t async_th;
     struct rt_semaphore async_notice;
 #endif
 
+#ifdef ULOG_USING_DEFERRED
+    /* send the deferred log records to the backends as binary */
+    rt_bool_t deferred_bin;
+    /* the deferred log's line buffer, and the deferred log which is rendering */
+    char log_buf_deferred[ULOG_LINE_BUF_SIZE + 1];
+    const struct deferred_frame *deferred_rendering;
+#endif /* ULOG_USING_DEFERRED */
+
 #ifdef ULOG_USING_FILTER
     struct
     {
@@ -104,6 +165,10 @@ struct rt_ulog
         rt_uint32_t level;
         char tag[ULOG_FILTER_TAG_MAX_LEN + 1];
         char keyword[ULOG_FILTER_KW_MAX_LEN + 1];
+        /* all tag's level filter indexed by the tag hash */
+        ulog_tag_lvl_filter_t tag_lvl_hash[ULOG_FILTER_TAG_HASH_SIZE];
+        /* changed when the tag's level filters change, the call site's caches are invalid then */
+        rt_atomic_t generation;
     } filter;
 #endif /* ULOG_USING_FILTER */
 };
@@ -278,6 +343,15 @@ rt_weak rt_size_t ulog_head_formater(char *log_buf, rt_uint32_t level, const cha
         static rt_bool_t check_usec_support = RT_FALSE, usec_is_support = RT_FALSE;
         time_t t = (time_t)0;
 
+#ifdef ULOG_USING_DEFERRED
+        /* the deferred log shows the time when it was recorded */
+        if (ulog.deferred_rendering)
+        {
+            now = ulog.deferred_rendering->time;
+            t = now.tv_sec;
+        }
+        else
+#endif
         if (gettimeofday(&now, RT_NULL) >= 0)
         {
             t = now.tv_sec;
@@ -307,9 +381,18 @@ rt_weak rt_size_t ulog_head_formater(char *log_buf, rt_uint32_t level, const cha
 
 #else
         static rt_size_t tick_len = 0;
+        rt_tick_t tick = rt_tick_get();
+
+#ifdef ULOG_USING_DEFERRED
+        /* the deferred log shows the tick when it was recorded */
+        if (ulog.deferred_rendering)
+        {
+            tick = ulog.deferred_rendering->head.tick;
+        }
+#endif
 
         log_buf[log_len] = '[';
-        tick_len = ulog_ultoa(log_buf + log_len + 1, rt_tick_get());
+        tick_len = ulog_ultoa(log_buf + log_len + 1, tick);
         log_buf[log_len + 1 + tick_len] = ']';
         log_buf[log_len + 1 + tick_len + 1] = '\0';
 #endif /* ULOG_TIME_USING_TIMESTAMP */
@@ -346,6 +429,16 @@ rt_weak rt_size_t ulog_head_formater(char *log_buf, rt_uint32_t level, const cha
         log_len += ulog_strcpy(log_len, log_buf + log_len, " ");
 #endif
 
+#ifdef ULOG_USING_DEFERRED
+        /* the deferred log shows the thread which recorded it */
+        if (ulog.deferred_rendering)
+        {
+            rt_size_t name_len = rt_strnlen(ulog.deferred_rendering->thread_name, RT_NAME_MAX);
+            rt_strncpy(log_buf + log_len, ulog.deferred_rendering->thread_name, name_len);
+            log_len += name_len;
+        }
+        else
+#endif
         /* is not in interrupt context */
         if (rt_interrupt_get_nest() == 0)
         {
@@ -499,7 +592,13 @@ rt_weak rt_size_t ulog_hex_formater(char *log_buf, const char *tag, const rt_uin
     return ulog_tail_formater(log_buf, log_len, RT_TRUE, LOG_LVL_DBG);
 }
 
-static void ulog_output_to_all_backend(rt_uint32_t level, const char *tag, rt_bool_t is_raw, const char *log, rt_size_t len)
+/**
+ * output the log to all backends
+ *
+ * @param skip_bin skip the backends which have received the binary deferred record of this log
+ */
+static void ulog_output_to_all_backend(rt_uint32_t level, const char *tag, rt_bool_t is_raw, const char *log, rt_size_t len,
+        rt_bool_t skip_bin)
 {
     rt_slist_t *node;
     ulog_backend_t backend;
@@ -522,6 +621,12 @@ static void ulog_output_to_all_backend(rt_uint32_t level, const char *tag, rt_bo
         {
             continue;
         }
+#ifdef ULOG_USING_DEFERRED
+        if (skip_bin && backend->output_bin)
+        {
+            continue;
+        }
+#endif
 #if !defined(ULOG_USING_COLOR) || defined(ULOG_USING_SYSLOG)
         backend->output(backend, level, tag, is_raw, log, len);
 #else
@@ -556,54 +661,247 @@ static void ulog_output_to_all_backend(rt_uint32_t level, const char *tag, rt_bo
     }
 }
 
-static void do_output(rt_uint32_t level, const char *tag, rt_bool_t is_raw, const char *log_buf, rt_size_t log_len)
-{
 #ifdef ULOG_USING_ASYNC_OUTPUT
-    rt_size_t log_buf_size = log_len + sizeof((char)'\0');
-    if (ulog.async_enabled)
+/*
+ * The async frames are records in a byte ring. A producer reserves its record by moving the
+ * head with compare and swap, writes it and commits it by setting its state, so the threads
+ * and the ISRs put the logs without any lock. The oldest record is taken by setting
+ * ASYNC_RING_BUSY on the tail, its owner frees it by clearing it and moving the tail.
+ */
+struct async_record
+{
+    rt_atomic_t state;
+    struct ulog_frame frame;
+};
+
+static rt_size_t async_ring_offset(rt_atomic_t pos)
+{
+    return (rt_size_t)pos % ulog.async_ring.size;
+}
+
+static rt_atomic_t async_ring_advance(rt_atomic_t pos, rt_size_t len)
+{
+    rt_size_t next = (rt_size_t)pos + len;
+
+    return (rt_atomic_t)(next < ulog.async_ring.wrap ? next : next - ulog.async_ring.wrap);
+}
+
+static rt_size_t async_ring_used(rt_atomic_t tail, rt_atomic_t head)
+{
+    return head >= tail ? (rt_size_t)(head - tail) : (rt_size_t)(head - tail) + ulog.async_ring.wrap;
+}
+
+/**
+ * take the oldest committed record, no one else takes it until it is freed
+ *
+ * @param pos the position of the record
+ *
+ * @return the record, RT_NULL: the ring is empty, the oldest record is not committed or is taken
+ */
+static struct async_record *async_ring_take(rt_atomic_t *pos)
+{
+    rt_atomic_t tail = rt_atomic_load(&ulog.async_ring.tail);
+    struct async_record *rec;
+
+    if ((tail & ASYNC_RING_BUSY) || tail == rt_atomic_load(&ulog.async_ring.head))
+    {
+        return RT_NULL;
+    }
+    if (!rt_atomic_compare_exchange_strong(&ulog.async_ring.tail, &tail, tail | ASYNC_RING_BUSY))
+    {
+        return RT_NULL;
+    }
+
+    rec = (struct async_record *)(ulog.async_ring.buf + async_ring_offset(tail));
+    if ((rt_atomic_load(&rec->state) & ASYNC_REC_COMMIT) == 0)
+    {
+        /* the producer is writing it */
+        rt_atomic_store(&ulog.async_ring.tail, tail);
+        return RT_NULL;
+    }
+    *pos = tail;
+
+    return rec;
+}
+
+/* free the record which is taken, it is cleared for the record which is reserved next on it */
+static void async_ring_free(struct async_record *rec, rt_atomic_t pos)
+{
+    rt_size_t size = ASYNC_REC_SIZE(rt_atomic_load(&rec->state));
+
+    rt_memset(rec, 0, size);
+    rt_atomic_store(&ulog.async_ring.tail, async_ring_advance(pos, size));
+
+    if (rt_atomic_load(&ulog.async_ring.waiters))
+    {
+        rt_sem_release(&ulog.async_ring.room);
+    }
+}
+
+/**
+ * make the room on the full ring by the async output policy
+ *
+ * @param start the tick when the log started to reserve
+ * @param can_wait the caller does not hold the output lock, which the async output may take
+ *
+ * @return RT_TRUE: try to reserve again, RT_FALSE: drop the newest log
+ */
+static rt_bool_t async_ring_make_room(rt_tick_t start, rt_bool_t can_wait)
+{
+    struct async_record *rec;
+    rt_atomic_t pos, state;
+    rt_tick_t timeout, waited;
+
+    switch (ulog.async_ring.policy)
     {
-        if (is_raw == RT_FALSE)
+    case ULOG_ASYNC_DROP_OLDEST:
+        /* the oldest one may be output or written now, then drop the newest one */
+        rec = async_ring_take(&pos);
+        if (rec == RT_NULL)
+        {
+            return RT_FALSE;
+        }
+        state = rt_atomic_load(&rec->state);
+        if ((state & ASYNC_REC_PAD) == 0)
+        {
+            rt_atomic_add(&ulog.async_ring.drops[ASYNC_REC_LEVEL(state)], 1);
+        }
+        async_ring_free(rec, pos);
+        return RT_TRUE;
+
+    case ULOG_ASYNC_BLOCK:
+        /* only the threads wait, the ISRs and the async output thread never */
+        if (!can_wait || rt_interrupt_get_nest() != 0 || !rt_scheduler_is_available()
+                || rt_thread_self() == ulog.async_th)
+        {
+            return RT_FALSE;
+        }
+        timeout = rt_tick_from_millisecond(ULOG_ASYNC_OUTPUT_BLOCK_TIMEOUT);
+        waited = rt_tick_get() - start;
+        if (waited >= timeout)
         {
-            rt_rbb_blk_t log_blk;
-            ulog_frame_t log_frame;
+            return RT_FALSE;
+        }
+        rt_atomic_add(&ulog.async_ring.waiters, 1);
+        rt_sem_release(&ulog.async_notice);
+        rt_sem_take(&ulog.async_ring.room, timeout - waited);
+        rt_atomic_sub(&ulog.async_ring.waiters, 1);
+        return RT_TRUE;
 
-            /* allocate log frame */
-            log_blk = rt_rbb_blk_alloc(ulog.async_rbb, RT_ALIGN(sizeof(struct ulog_frame) + log_buf_size, RT_ALIGN_SIZE));
-            if (log_blk)
-            {
-                /* package the log frame */
-                log_frame = (ulog_frame_t) log_blk->buf;
-                log_frame->magic = ULOG_FRAME_MAGIC;
-                log_frame->is_raw = is_raw;
-                log_frame->level = level;
-                log_frame->log_len = log_len;
-                log_frame->tag = tag;
-                log_frame->log = (const char *)log_blk->buf + sizeof(struct ulog_frame);
-                /* copy log data */
-                rt_strncpy((char *)(log_blk->buf + sizeof(struct ulog_frame)), log_buf, log_buf_size);
-                /* put the block */
-                rt_rbb_blk_put(log_blk);
-                /* send a notice */
-                rt_sem_release(&ulog.async_notice);
-            }
-            else
+    default:
+        return RT_FALSE;
+    }
+}
+
+/**
+ * reserve a record on the ring, the record never wraps around the end of the ring
+ *
+ * @param level level, the log of it is counted when it is dropped
+ * @param size the record size
+ * @param can_wait the caller may wait for the room
+ *
+ * @return the record which state is 0, RT_NULL: the log is dropped
+ */
+static struct async_record *async_ring_reserve(rt_uint32_t level, rt_size_t size, rt_bool_t can_wait)
+{
+    rt_atomic_t head, tail, used, high_water;
+    rt_size_t offset, pad;
+    rt_tick_t start = rt_tick_get();
+    struct async_record *rec;
+
+    while (1)
+    {
+        /* the tail is read first, so the used size is never less than it is */
+        tail = rt_atomic_load(&ulog.async_ring.tail) & ~ASYNC_RING_BUSY;
+        head = rt_atomic_load(&ulog.async_ring.head);
+        used = async_ring_used(tail, head);
+        offset = async_ring_offset(head);
+        /* the room left at the end of the ring is padded when the record does not fit in */
+        pad = (offset + size > ulog.async_ring.size) ? ulog.async_ring.size - offset : 0;
+
+        if (used + pad + size <= ulog.async_ring.size)
+        {
+            if (rt_atomic_compare_exchange_strong(&ulog.async_ring.head, &head, async_ring_advance(head, pad + size)))
             {
-                static rt_bool_t already_output = RT_FALSE;
-                if (already_output == RT_FALSE)
-                {
-                    rt_kprintf("Warning: There is no enough buffer for saving async log,"
-                            " please increase the ULOG_ASYNC_OUTPUT_BUF_SIZE option.\n");
-                    already_output = RT_TRUE;
-                }
+                break;
             }
         }
-        else if (ulog.async_rb)
+        else if (size > ulog.async_ring.size || !async_ring_make_room(start, can_wait))
+        {
+            rt_atomic_add(&ulog.async_ring.drops[level & 0x07], 1);
+            return RT_NULL;
+        }
+    }
+
+    if (pad)
+    {
+        rec = (struct async_record *)(ulog.async_ring.buf + offset);
+        rt_atomic_store(&rec->state, (rt_atomic_t)(pad << 8) | ASYNC_REC_PAD | ASYNC_REC_COMMIT);
+        offset = 0;
+    }
+
+    used += pad + size;
+    high_water = rt_atomic_load(&ulog.async_ring.high_water);
+    while (used > high_water && !rt_atomic_compare_exchange_strong(&ulog.async_ring.high_water, &high_water, used));
+
+    return (struct async_record *)(ulog.async_ring.buf + offset);
+}
+
+/**
+ * put a log frame to the async output buffer
+ *
+ * @param magic ULOG_FRAME_MAGIC: log is a string, ULOG_DEFERRED_FRAME_MAGIC: log is a deferred record
+ * @param size the size of log data which will be copied
+ * @param can_wait RT_FALSE: the caller holds the output lock, it can not wait for the async output
+ */
+static void async_frame_put(rt_uint8_t magic, rt_uint32_t level, const char *tag, rt_bool_t is_raw, const void *log,
+        rt_size_t log_len, rt_size_t size, rt_bool_t can_wait)
+{
+    struct async_record *rec;
+    rt_size_t rec_size = RT_ALIGN(sizeof(struct async_record) + size, RT_ALIGN_SIZE);
+
+    rec = async_ring_reserve(level, rec_size, can_wait);
+    if (rec)
+    {
+        /* package the log frame */
+        rec->frame.magic = magic;
+        rec->frame.is_raw = is_raw;
+        rec->frame.level = level;
+        rec->frame.log_len = log_len;
+        rec->frame.tag = tag;
+        rec->frame.log = (const char *)rec + sizeof(struct async_record);
+        /* copy log data */
+        rt_memcpy((rt_uint8_t *)rec + sizeof(struct async_record), log, size);
+        /* commit it, the async output can take it now */
+        rt_atomic_store(&rec->state, (rt_atomic_t)(rec_size << 8) | ((level & 0x07) << 4) | ASYNC_REC_COMMIT);
+        /* send a notice */
+        rt_sem_release(&ulog.async_notice);
+    }
+    else
+    {
+        static rt_bool_t already_output = RT_FALSE;
+        if (already_output == RT_FALSE)
         {
-            rt_ringbuffer_put(ulog.async_rb, (const rt_uint8_t *)log_buf, (rt_uint16_t)log_buf_size);
-            /* send a notice */
-            rt_sem_release(&ulog.async_notice);
+            rt_kprintf("Warning: There is no enough buffer for saving async log,"
+                    " please increase the ULOG_ASYNC_OUTPUT_BUF_SIZE option. Run 'ulog_async' for the drops.\n");
+            already_output = RT_TRUE;
         }
+    }
+}
+#endif /* ULOG_USING_ASYNC_OUTPUT */
 
+static void do_output(rt_uint32_t level, const char *tag, rt_bool_t is_raw, const char *log_buf, rt_size_t log_len)
+{
+#ifdef ULOG_USING_ASYNC_OUTPUT
+    rt_size_t log_buf_size = log_len + sizeof((char)'\0');
+    if (ulog.async_enabled)
+    {
+#ifdef ULOG_USING_DEFERRED
+        /* the async output renders the deferred logs with the output lock, which is held here */
+        async_frame_put(ULOG_FRAME_MAGIC, level, tag, is_raw, log_buf, log_len, log_buf_size, RT_FALSE);
+#else
+        async_frame_put(ULOG_FRAME_MAGIC, level, tag, is_raw, log_buf, log_len, log_buf_size, RT_TRUE);
+#endif
         return;
     }
 #endif /* ULOG_USING_ASYNC_OUTPUT */
@@ -611,7 +909,7 @@ static void do_output(rt_uint32_t level, const char *tag, rt_bool_t is_raw, cons
     if (rt_interrupt_get_nest() == 0)
     {
         /* output to all backends */
-        ulog_output_to_all_backend(level, tag, is_raw, log_buf, log_len);
+        ulog_output_to_all_backend(level, tag, is_raw, log_buf, log_len, RT_FALSE);
     }
     else
     {
@@ -625,21 +923,66 @@ static void do_output(rt_uint32_t level, const char *tag, rt_bool_t is_raw, cons
     }
 }
 
+#ifdef ULOG_USING_FILTER
 /**
- * output the log by variable argument list
+ * get the level on tag's level filter by the call site's cache
+ * it takes no lock until the tag's level filters change
  *
- * @param level level
- * @param tag tag
- * @param newline has_newline
- * @param hex_buf != RT_NULL: enable hex log mode, data buffer
- * @param hex_size hex data buffer size
- * @param hex_width hex log width
- * @param hex_addr hex data address
- * @param format output format
- * @param args variable argument list
+ * @param cache the call site's cache, RT_NULL: look up the filter
+ * @param tag log tag
  */
-void ulog_voutput(rt_uint32_t level, const char *tag, rt_bool_t newline, const rt_uint8_t *hex_buf, rt_size_t hex_size,
-        rt_size_t hex_width, rt_base_t hex_addr, const char *format, va_list args)
+static rt_uint32_t tag_lvl_cache_get(struct ulog_tag_lvl_cache *cache, const char *tag)
+{
+    rt_atomic_t generation;
+
+    if (cache == RT_NULL)
+    {
+        return ulog_tag_lvl_filter_get(tag);
+    }
+
+    generation = rt_atomic_load(&ulog.filter.generation);
+    if (rt_atomic_load(&cache->generation) != generation || cache->tag != tag)
+    {
+        /* the call site may be running on the others, invalidate it before updating */
+        rt_atomic_store(&cache->generation, 0);
+        cache->tag = tag;
+        cache->level = ulog_tag_lvl_filter_get(tag);
+        rt_atomic_store(&cache->generation, generation);
+    }
+
+    return cache->level;
+}
+
+/* check the log by the level filters and the global tag filter */
+static rt_bool_t filter_lvl_tag_match(rt_uint32_t level, const char *tag, struct ulog_tag_lvl_cache *cache)
+{
+    /* level filter */
+#ifndef ULOG_USING_SYSLOG
+    if (level > ulog.filter.level || level > tag_lvl_cache_get(cache, tag))
+    {
+        return RT_FALSE;
+    }
+#else
+    if (((LOG_MASK(LOG_PRI(level)) & ulog.filter.level) == 0)
+            || ((LOG_MASK(LOG_PRI(level)) & tag_lvl_cache_get(cache, tag)) == 0))
+    {
+        return RT_FALSE;
+    }
+#endif /* ULOG_USING_SYSLOG */
+    else if (!rt_strstr(tag, ulog.filter.tag))
+    {
+        /* tag filter */
+        return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+#endif /* ULOG_USING_FILTER */
+
+/* ulog_voutput() with the call site's cache of the tag's level filter, it may be RT_NULL */
+static void do_voutput(struct ulog_tag_lvl_cache *cache, rt_uint32_t level, const char *tag, rt_bool_t newline,
+        const rt_uint8_t *hex_buf, rt_size_t hex_size, rt_size_t hex_width, rt_base_t hex_addr, const char *format,
+        va_list args)
 {
     static rt_bool_t ulog_voutput_recursion = RT_FALSE;
     char *log_buf = RT_NULL;
@@ -659,22 +1002,8 @@ void ulog_voutput(rt_uint32_t level, const char *tag, rt_bool_t newline, const r
     }
 
 #ifdef ULOG_USING_FILTER
-    /* level filter */
-#ifndef ULOG_USING_SYSLOG
-    if (level > ulog.filter.level || level > ulog_tag_lvl_filter_get(tag))
-    {
-        return;
-    }
-#else
-    if (((LOG_MASK(LOG_PRI(level)) & ulog.filter.level) == 0)
-            || ((LOG_MASK(LOG_PRI(level)) & ulog_tag_lvl_filter_get(tag)) == 0))
-    {
-        return;
-    }
-#endif /* ULOG_USING_SYSLOG */
-    else if (!rt_strstr(tag, ulog.filter.tag))
+    if (!filter_lvl_tag_match(level, tag, cache))
     {
-        /* tag filter */
         return;
     }
 #endif /* ULOG_USING_FILTER */
@@ -739,6 +1068,25 @@ void ulog_voutput(rt_uint32_t level, const char *tag, rt_bool_t newline, const r
     output_unlock();
 }
 
+/**
+ * output the log by variable argument list
+ *
+ * @param level level
+ * @param tag tag
+ * @param newline has_newline
+ * @param hex_buf != RT_NULL: enable hex log mode, data buffer
+ * @param hex_size hex data buffer size
+ * @param hex_width hex log width
+ * @param hex_addr hex data address
+ * @param format output format
+ * @param args variable argument list
+ */
+void ulog_voutput(rt_uint32_t level, const char *tag, rt_bool_t newline, const rt_uint8_t *hex_buf, rt_size_t hex_size,
+        rt_size_t hex_width, rt_base_t hex_addr, const char *format, va_list args)
+{
+    do_voutput(RT_NULL, level, tag, newline, hex_buf, hex_size, hex_width, hex_addr, format, args);
+}
+
 /**
  * output the log
  *
@@ -760,6 +1108,29 @@ void ulog_output(rt_uint32_t level, const char *tag, rt_bool_t newline, const ch
     va_end(args);
 }
 
+#ifdef ULOG_USING_FILTER
+/**
+ * output the log with newline, the tag's level filter is cached by the call site
+ *
+ * @param cache the call site's cache, it is invalidated by ulog_tag_lvl_filter_set()
+ * @param level level
+ * @param tag tag
+ * @param format output format
+ * @param ... args
+ */
+void ulog_output_cached(struct ulog_tag_lvl_cache *cache, rt_uint32_t level, const char *tag, const char *format, ...)
+{
+    va_list args;
+
+    /* args point to the first variable parameter */
+    va_start(args, format);
+
+    do_voutput(cache, level, tag, RT_TRUE, RT_NULL, 0, 0, 0, format, args);
+
+    va_end(args);
+}
+#endif /* ULOG_USING_FILTER */
+
 /**
  * output RAW string format log
  *
@@ -775,13 +1146,6 @@ void ulog_raw(const char *format, ...)
 
     RT_ASSERT(ulog.init_ok);
 
-#ifdef ULOG_USING_ASYNC_OUTPUT
-    if (ulog.async_rb == RT_NULL)
-    {
-        ulog.async_rb = rt_ringbuffer_create(ULOG_ASYNC_OUTPUT_BUF_SIZE);
-    }
-#endif
-
     /* get log buffer */
     log_buf = get_log_buf();
 
@@ -837,19 +1201,542 @@ void ulog_hexdump(const char *tag, rt_size_t width, const rt_uint8_t *buf, rt_si
     va_end(args);
 }
 
-#ifdef ULOG_USING_FILTER
-/**
- * Set the filter's level by different backend.
- * The log on this backend which level is less than it will stop output.
- *
- * @param be_name backend name
- * @param level The filter level. When the level is LOG_FILTER_LVL_SILENT, the log enter silent mode.
- *        When the level is LOG_FILTER_LVL_ALL, it will remove this tag's level filer.
- *        Then all level log will resume output.
- *
- * @return  0 : success
- *         -10: level is out of range
- */
+#ifdef ULOG_USING_DEFERRED
+/* the argument types of a conversion */
+enum deferred_arg_type
+{
+    DEFERRED_ARG_NONE,
+    DEFERRED_ARG_INT,
+    DEFERRED_ARG_LONG,
+    DEFERRED_ARG_LLONG,
+    DEFERRED_ARG_PTR,
+    DEFERRED_ARG_DOUBLE,
+    DEFERRED_ARG_STR,
+};
+
+union deferred_arg
+{
+    int i;
+    long l;
+    long long ll;
+    void *p;
+    double d;
+};
+
+#if defined(__ICCARM__) || defined(__ICCRX__)
+#pragma section="ULogFmtTab"
+#endif
+
+/* the first format of the ULogFmtTab section, the record id is the index from it */
+static const struct ulog_fmt *deferred_fmt_table(void)
+{
+#if defined(__ARMCC_VERSION)
+    extern const int ULogFmtTab$$Base;
+    return (const struct ulog_fmt *)&ULogFmtTab$$Base;
+#elif defined(__ICCARM__) || defined(__ICCRX__)
+    return (const struct ulog_fmt *)__section_begin("ULogFmtTab");
+#elif defined(__GNUC__)
+    extern const int __ulogfmt_start;
+    return (const struct ulog_fmt *)&__ulogfmt_start;
+#else
+#error "the deferred log does not support this toolchain"
+#endif
+}
+
+/**
+ * parse a conversion of the format
+ *
+ * @param format the character after '%'
+ * @param stars the number of '*' in width and precision, each one takes an int argument before the value
+ * @param type the argument type of the value
+ *
+ * @return the character after the conversion
+ */
+static const char *deferred_parse_conv(const char *format, int *stars, enum deferred_arg_type *type)
+{
+    int longs = 0;
+
+    *stars = 0;
+    *type = DEFERRED_ARG_NONE;
+
+    /* flags, width and precision */
+    while (*format == '-' || *format == '+' || *format == ' ' || *format == '#' || *format == '.'
+            || *format == '*' || (*format >= '0' && *format <= '9'))
+    {
+        if (*format == '*')
+        {
+            (*stars)++;
+        }
+        format++;
+    }
+    /* length */
+    while (*format == 'h' || *format == 'l' || *format == 'L' || *format == 'z' || *format == 't' || *format == 'j')
+    {
+        if (*format == 'l')
+        {
+            longs++;
+        }
+        else if (*format == 'z' || *format == 't')
+        {
+            longs = 1;
+        }
+        else if (*format == 'j')
+        {
+            longs = 2;
+        }
+        format++;
+    }
+
+    switch (*format)
+    {
+    case '\0':
+        return format;
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+        *type = longs >= 2 ? DEFERRED_ARG_LLONG : (longs ? DEFERRED_ARG_LONG : DEFERRED_ARG_INT);
+        break;
+    case 'p':
+        *type = DEFERRED_ARG_PTR;
+        break;
+    case 's':
+        *type = DEFERRED_ARG_STR;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        *type = DEFERRED_ARG_DOUBLE;
+        break;
+    default:
+        break;
+    }
+
+    return format + 1;
+}
+
+/* size of the argument in the record, the string is variable */
+static rt_size_t deferred_arg_size(enum deferred_arg_type type)
+{
+    switch (type)
+    {
+    case DEFERRED_ARG_INT:
+        return sizeof(int);
+    case DEFERRED_ARG_LONG:
+    case DEFERRED_ARG_PTR:
+        return sizeof(long);
+    case DEFERRED_ARG_LLONG:
+        return sizeof(long long);
+    case DEFERRED_ARG_DOUBLE:
+        return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * pack the arguments of the format, the packing stops at the first one which has no space
+ *
+ * @return the length of the arguments
+ */
+static rt_size_t deferred_pack(rt_uint8_t *buf, const char *format, va_list args)
+{
+    enum deferred_arg_type type;
+    union deferred_arg value;
+    rt_size_t len = 0, size;
+    const char *str;
+    int stars;
+
+    while (*format)
+    {
+        if (*format++ != '%')
+        {
+            continue;
+        }
+        format = deferred_parse_conv(format, &stars, &type);
+
+        while (stars--)
+        {
+            value.i = va_arg(args, int);
+            if (len + sizeof(int) > ULOG_DEFERRED_ARGS_MAX)
+            {
+                return len;
+            }
+            rt_memcpy(buf + len, &value, sizeof(int));
+            len += sizeof(int);
+        }
+
+        switch (type)
+        {
+        case DEFERRED_ARG_NONE:
+            continue;
+        case DEFERRED_ARG_STR:
+            str = va_arg(args, const char *);
+            if (str == RT_NULL)
+            {
+                str = "(NULL)";
+            }
+            /* length, characters and end sign, cut it to fit */
+            if (len + 2 > ULOG_DEFERRED_ARGS_MAX)
+            {
+                return len;
+            }
+            size = rt_strnlen(str, ULOG_DEFERRED_ARGS_MAX - len - 2);
+            buf[len] = (rt_uint8_t)size;
+            rt_memcpy(buf + len + 1, str, size);
+            buf[len + 1 + size] = '\0';
+            len += size + 2;
+            continue;
+        case DEFERRED_ARG_INT:
+            value.i = va_arg(args, int);
+            break;
+        case DEFERRED_ARG_LONG:
+            value.l = va_arg(args, long);
+            break;
+        case DEFERRED_ARG_LLONG:
+            value.ll = va_arg(args, long long);
+            break;
+        case DEFERRED_ARG_PTR:
+            value.l = (long)va_arg(args, void *);
+            break;
+        case DEFERRED_ARG_DOUBLE:
+            value.d = va_arg(args, double);
+            break;
+        }
+
+        size = deferred_arg_size(type);
+        if (len + size > ULOG_DEFERRED_ARGS_MAX)
+        {
+            return len;
+        }
+        rt_memcpy(buf + len, &value, size);
+        len += size;
+    }
+
+    return len;
+}
+
+/**
+ * format the deferred log record like ulog_formater()
+ * the log is cut at the first argument which was not recorded
+ */
+static rt_size_t deferred_formater(char *log_buf, const struct ulog_fmt *fmt, const struct ulog_deferred_record *record)
+{
+    const rt_uint8_t *args = (const rt_uint8_t *)(record + 1);
+    const char *format = fmt->format, *conv;
+    enum deferred_arg_type type;
+    union deferred_arg value;
+    /* a conversion with the '*' replaced by its value */
+    char spec[24];
+    rt_size_t log_len, pos = 0, spec_len, size;
+    int stars, result = 0;
+
+    /* log head */
+    log_len = ulog_head_formater(log_buf, fmt->level, fmt->tag);
+
+    /* log content */
+    while (*format && log_len < ULOG_LINE_BUF_SIZE)
+    {
+        if (*format != '%')
+        {
+            log_buf[log_len++] = *format++;
+            continue;
+        }
+        conv = format++;
+        format = deferred_parse_conv(format, &stars, &type);
+        if (type == DEFERRED_ARG_NONE)
+        {
+            if (format[-1] == '%')
+            {
+                log_buf[log_len++] = '%';
+            }
+            continue;
+        }
+
+        for (spec_len = 0; conv < format && spec_len < sizeof(spec) - 12; conv++)
+        {
+            if (*conv != '*')
+            {
+                spec[spec_len++] = *conv;
+                continue;
+            }
+            if (pos + sizeof(int) > record->len)
+            {
+                goto __tail;
+            }
+            rt_memcpy(&value.i, args + pos, sizeof(int));
+            pos += sizeof(int);
+            spec_len += rt_snprintf(spec + spec_len, sizeof(spec) - spec_len, "%d", value.i);
+        }
+        spec[spec_len] = '\0';
+
+        if (type == DEFERRED_ARG_STR)
+        {
+            if (pos + 2 > record->len)
+            {
+                goto __tail;
+            }
+            size = args[pos] + 2;
+        }
+        else
+        {
+            size = deferred_arg_size(type);
+        }
+        if (pos + size > record->len)
+        {
+            goto __tail;
+        }
+        if (type == DEFERRED_ARG_STR)
+        {
+            value.p = (void *)(args + pos + 1);
+        }
+        else
+        {
+            rt_memcpy(&value, args + pos, size);
+        }
+        pos += size;
+
+        switch (type)
+        {
+        case DEFERRED_ARG_INT:
+            result = rt_snprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, spec, value.i);
+            break;
+        case DEFERRED_ARG_LONG:
+            result = rt_snprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, spec, value.l);
+            break;
+        case DEFERRED_ARG_LLONG:
+            result = rt_snprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, spec, value.ll);
+            break;
+        case DEFERRED_ARG_PTR:
+            result = rt_snprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, spec, (void *)value.l);
+            break;
+        case DEFERRED_ARG_DOUBLE:
+            result = rt_snprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, spec, value.d);
+            break;
+        case DEFERRED_ARG_STR:
+            result = rt_snprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, spec, (const char *)value.p);
+            break;
+        default:
+            break;
+        }
+        if (result < 0)
+        {
+            break;
+        }
+        log_len += result;
+    }
+
+__tail:
+    if (log_len > ULOG_LINE_BUF_SIZE)
+    {
+        /* using max length */
+        log_len = ULOG_LINE_BUF_SIZE;
+    }
+    /* log tail */
+    return ulog_tail_formater(log_buf, log_len, RT_TRUE, fmt->level);
+}
+
+/**
+ * output the deferred log, it only records the format id, the arguments, the tick, and the
+ * time and thread name when they are shown, to the async output buffer. The text is rendered
+ * by the async output.
+ *
+ * @note the LOG_X API calls it when ULOG_USING_DEFERRED is enabled
+ *
+ * @param fmt the format in the ULogFmtTab section
+ * @param cache the call site's cache of the tag's level filter, RT_NULL when ULOG_USING_FILTER is disabled
+ * @param ... args
+ */
+void ulog_deferred_output(const struct ulog_fmt *fmt, struct ulog_tag_lvl_cache *cache, ...)
+{
+    struct deferred_frame record;
+    rt_size_t record_size;
+    va_list args;
+
+    RT_ASSERT(fmt);
+
+    if (!ulog.init_ok)
+    {
+        return;
+    }
+
+    va_start(args, cache);
+
+    if (!ulog.async_enabled)
+    {
+        /* the log will be output directly, format it now */
+        do_voutput(cache, fmt->level, fmt->tag, RT_TRUE, RT_NULL, 0, 0, 0, fmt->format, args);
+        va_end(args);
+        return;
+    }
+
+#ifdef ULOG_USING_FILTER
+    if (!filter_lvl_tag_match(fmt->level, fmt->tag, cache))
+    {
+        va_end(args);
+        return;
+    }
+#endif /* ULOG_USING_FILTER */
+
+    record.head.sync = ULOG_DEFERRED_SYNC;
+    record.head.id = (rt_uint16_t)(fmt - deferred_fmt_table());
+    record.head.tick = rt_tick_get();
+    record.head.len = (rt_uint8_t)deferred_pack(record.args, fmt->format, args);
+    va_end(args);
+
+#if defined(ULOG_OUTPUT_TIME) && defined(ULOG_TIME_USING_TIMESTAMP)
+    if (gettimeofday(&record.time, RT_NULL) < 0)
+    {
+        record.time.tv_sec = 0;
+        record.time.tv_usec = 0;
+    }
+#endif
+#ifdef ULOG_OUTPUT_THREAD_NAME
+    if (rt_interrupt_get_nest() != 0)
+    {
+        rt_strncpy(record.thread_name, "ISR", RT_NAME_MAX);
+    }
+    else
+    {
+        rt_strncpy(record.thread_name, rt_thread_self() ? rt_thread_self()->parent.name : "N/A", RT_NAME_MAX);
+    }
+#endif
+
+    record_size = offsetof(struct deferred_frame, args) + record.head.len;
+    async_frame_put(ULOG_DEFERRED_FRAME_MAGIC, fmt->level, fmt->tag, RT_FALSE, &record, record_size, record_size,
+            RT_TRUE);
+}
+
+/* output a deferred log frame of the async output buffer */
+static void deferred_async_output(ulog_frame_t frame)
+{
+    /* copied out of the async output buffer, which only keeps the records RT_ALIGN_SIZE aligned */
+    struct deferred_frame record;
+    const struct ulog_fmt *fmt;
+    rt_bool_t need_text, skip_bin = RT_FALSE;
+    rt_slist_t *node;
+    ulog_backend_t backend;
+    rt_size_t log_len = 0;
+
+    rt_memcpy(&record, frame->log, frame->log_len);
+    fmt = deferred_fmt_table() + record.head.id;
+
+    /* the line buffer, the formaters and the backends are shared */
+    output_lock();
+
+    /* the text is needed by the text backends and by the filters */
+    need_text = !ulog.deferred_bin || !rt_slist_first(&ulog.backend_list);
+#ifdef ULOG_USING_FILTER
+    if (ulog.filter.keyword[0] != '\0')
+    {
+        need_text = RT_TRUE;
+    }
+#endif /* ULOG_USING_FILTER */
+    for (node = rt_slist_first(&ulog.backend_list); node && !need_text; node = rt_slist_next(node))
+    {
+        backend = rt_slist_entry(node, struct ulog_backend, list);
+        if (backend->out_level >= frame->level && (!backend->output_bin || backend->filter))
+        {
+            need_text = RT_TRUE;
+        }
+    }
+
+    if (need_text)
+    {
+        ulog.deferred_rendering = &record;
+        log_len = deferred_formater(ulog.log_buf_deferred, fmt, &record.head);
+        ulog.deferred_rendering = RT_NULL;
+
+#ifdef ULOG_USING_FILTER
+        /* keyword filter */
+        if (ulog.filter.keyword[0] != '\0' && !rt_strstr(ulog.log_buf_deferred, ulog.filter.keyword))
+        {
+            output_unlock();
+            return;
+        }
+#endif /* ULOG_USING_FILTER */
+    }
+
+    if (ulog.deferred_bin && rt_slist_first(&ulog.backend_list))
+    {
+        rt_bool_t has_text_backend = RT_FALSE;
+
+        for (node = rt_slist_first(&ulog.backend_list); node; node = rt_slist_next(node))
+        {
+            backend = rt_slist_entry(node, struct ulog_backend, list);
+            if (backend->out_level < frame->level)
+            {
+                continue;
+            }
+            if (!backend->output_bin)
+            {
+                has_text_backend = RT_TRUE;
+                continue;
+            }
+            if (backend->filter && backend->filter(backend, frame->level, fmt->tag, RT_FALSE,
+                    ulog.log_buf_deferred, log_len) == RT_FALSE)
+            {
+                /* backend's filter is not match, so skip output */
+                continue;
+            }
+            backend->output_bin(backend, &record.head, frame->log_len - offsetof(struct deferred_frame, head));
+        }
+        if (!has_text_backend)
+        {
+            output_unlock();
+            return;
+        }
+        skip_bin = RT_TRUE;
+    }
+
+    ulog_output_to_all_backend(frame->level, fmt->tag, RT_FALSE, ulog.log_buf_deferred, log_len, skip_bin);
+
+    output_unlock();
+}
+
+/**
+ * enable or disable the binary output of the deferred log
+ * the backends which support it receive the deferred log records instead of the text,
+ * decode them on the host by ulog_decode.py
+ *
+ * @param enabled RT_TRUE: enabled, RT_FALSE: disabled
+ */
+void ulog_deferred_binary_enabled(rt_bool_t enabled)
+{
+    ulog.deferred_bin = enabled;
+}
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void ulog_bin(uint8_t argc, char **argv)
+{
+    if (argc > 1 && !rt_strcmp(argv[1], "on"))
+    {
+        ulog_deferred_binary_enabled(RT_TRUE);
+    }
+    else if (argc > 1 && !rt_strcmp(argv[1], "off"))
+    {
+        ulog_deferred_binary_enabled(RT_FALSE);
+    }
+    else
+    {
+        rt_kprintf("Please input: ulog_bin <on|off>.\n");
+        rt_kprintf("The deferred log binary output is %s.\n", ulog.deferred_bin ? "on" : "off");
+    }
+}
+MSH_CMD_EXPORT(ulog_bin, Set ulog deferred log binary output: ulog_bin on|off);
+#endif /* RT_USING_FINSH */
+#endif /* ULOG_USING_DEFERRED */
+
+#ifdef ULOG_USING_FILTER
+/**
+ * Set the filter's level by different backend.
+ * The log on this backend which level is less than it will stop output.
+ *
+ * @param be_name backend name
+ * @param level The filter level. When the level is LOG_FILTER_LVL_SILENT, the log enter silent mode.
+ *        When the level is LOG_FILTER_LVL_ALL, it will remove this tag's level filer.
+ *        Then all level log will resume output.
+ *
+ * @return  0 : success
+ *         -10: level is out of range
+ */
 int ulog_be_lvl_filter_set(const char *be_name, rt_uint32_t level)
 {
     rt_slist_t *node = RT_NULL;
@@ -874,6 +1761,24 @@ int ulog_be_lvl_filter_set(const char *be_name, rt_uint32_t level)
     return result;
 }
 
+/* the bucket of tag's level filter */
+static rt_size_t tag_lvl_hash(const char *tag)
+{
+    return rt_strnhash(tag, ULOG_FILTER_TAG_MAX_LEN) & (ULOG_FILTER_TAG_HASH_SIZE - 1);
+}
+
+/* invalidate all call site's caches, 0 is left for the cache which is being updated */
+static void tag_lvl_generation_update(void)
+{
+    rt_atomic_t generation = rt_atomic_load(&ulog.filter.generation) + 1;
+
+    if (generation == 0)
+    {
+        generation = 1;
+    }
+    rt_atomic_store(&ulog.filter.generation, generation);
+}
+
 /**
  * Set the filter's level by different tag.
  * The log on this tag which level is less than it will stop output.
@@ -897,7 +1802,7 @@ int ulog_be_lvl_filter_set(const char *be_name, rt_uint32_t level)
  */
 int ulog_tag_lvl_filter_set(const char *tag, rt_uint32_t level)
 {
-    rt_slist_t *node;
+    ulog_tag_lvl_filter_t *bucket;
     ulog_tag_lvl_filter_t tag_lvl = RT_NULL;
     int result = RT_EOK;
 
@@ -909,18 +1814,14 @@ int ulog_tag_lvl_filter_set(const char *tag, rt_uint32_t level)
 
     /* lock output */
     output_lock();
-    /* find the tag in list */
-    for (node = rt_slist_first(ulog_tag_lvl_list_get()); node; node = rt_slist_next(node))
+    /* find the tag in its hash bucket */
+    for (bucket = &ulog.filter.tag_lvl_hash[tag_lvl_hash(tag)]; *bucket; bucket = &(*bucket)->hash_next)
     {
-        tag_lvl = rt_slist_entry(node, struct ulog_tag_lvl_filter, list);
-        if (!rt_strncmp(tag_lvl->tag, tag, ULOG_FILTER_TAG_MAX_LEN))
+        if (!rt_strncmp((*bucket)->tag, tag, ULOG_FILTER_TAG_MAX_LEN))
         {
+            tag_lvl = *bucket;
             break;
         }
-        else
-        {
-            tag_lvl = RT_NULL;
-        }
     }
     /* find OK */
     if (tag_lvl)
@@ -928,6 +1829,7 @@ int ulog_tag_lvl_filter_set(const char *tag, rt_uint32_t level)
         if (level == LOG_FILTER_LVL_ALL)
         {
             /* remove current tag's level filter when input level is the lowest level */
+            *bucket = tag_lvl->hash_next;
             rt_slist_remove(ulog_tag_lvl_list_get(), &tag_lvl->list);
             rt_free(tag_lvl);
         }
@@ -949,6 +1851,8 @@ int ulog_tag_lvl_filter_set(const char *tag, rt_uint32_t level)
                 rt_memset(tag_lvl->tag, 0 , sizeof(tag_lvl->tag));
                 rt_strncpy(tag_lvl->tag, tag, ULOG_FILTER_TAG_MAX_LEN);
                 tag_lvl->level = level;
+                tag_lvl->hash_next = RT_NULL;
+                *bucket = tag_lvl;
                 rt_slist_append(ulog_tag_lvl_list_get(), &tag_lvl->list);
             }
             else
@@ -957,6 +1861,8 @@ int ulog_tag_lvl_filter_set(const char *tag, rt_uint32_t level)
             }
         }
     }
+    /* the levels cached by the call sites are stale now */
+    tag_lvl_generation_update();
     /* unlock output */
     output_unlock();
 
@@ -973,8 +1879,7 @@ int ulog_tag_lvl_filter_set(const char *tag, rt_uint32_t level)
  */
 rt_uint32_t ulog_tag_lvl_filter_get(const char *tag)
 {
-    rt_slist_t *node;
-    ulog_tag_lvl_filter_t tag_lvl = RT_NULL;
+    ulog_tag_lvl_filter_t tag_lvl;
     rt_uint32_t level = LOG_FILTER_LVL_ALL;
 
     if (!ulog.init_ok)
@@ -982,10 +1887,9 @@ rt_uint32_t ulog_tag_lvl_filter_get(const char *tag)
 
     /* lock output */
     output_lock();
-    /* find the tag in list */
-    for (node = rt_slist_first(ulog_tag_lvl_list_get()); node; node = rt_slist_next(node))
+    /* find the tag in its hash bucket */
+    for (tag_lvl = ulog.filter.tag_lvl_hash[tag_lvl_hash(tag)]; tag_lvl; tag_lvl = tag_lvl->hash_next)
     {
-        tag_lvl = rt_slist_entry(node, struct ulog_tag_lvl_filter, list);
         if (!rt_strncmp(tag_lvl->tag, tag, ULOG_FILTER_TAG_MAX_LEN))
         {
             level = tag_lvl->level;
@@ -1343,37 +2247,37 @@ ulog_backend_t ulog_backend_find(const char *name)
  */
 void ulog_async_output(void)
 {
-    rt_rbb_blk_t log_blk;
+    struct async_record *rec;
     ulog_frame_t log_frame;
+    rt_atomic_t pos;
 
     if (!ulog.async_enabled)
     {
         return;
     }
 
-    while ((log_blk = rt_rbb_blk_get(ulog.async_rbb)) != RT_NULL)
+    while ((rec = async_ring_take(&pos)) != RT_NULL)
     {
-        log_frame = (ulog_frame_t) log_blk->buf;
+        if (rt_atomic_load(&rec->state) & ASYNC_REC_PAD)
+        {
+            /* the room left at the end of the ring has no frame */
+            async_ring_free(rec, pos);
+            continue;
+        }
+        log_frame = &rec->frame;
         if (log_frame->magic == ULOG_FRAME_MAGIC)
         {
             /* output to all backends */
             ulog_output_to_all_backend(log_frame->level, log_frame->tag, log_frame->is_raw, log_frame->log,
-                    log_frame->log_len);
+                    log_frame->log_len, RT_FALSE);
         }
-        rt_rbb_blk_free(ulog.async_rbb, log_blk);
-    }
-    /* output the log_raw format log */
-    if (ulog.async_rb)
-    {
-        rt_size_t log_len = rt_ringbuffer_data_len(ulog.async_rb);
-        char *log = rt_malloc(log_len + 1);
-        if (log)
+#ifdef ULOG_USING_DEFERRED
+        else if (log_frame->magic == ULOG_DEFERRED_FRAME_MAGIC)
         {
-            rt_size_t len = rt_ringbuffer_get(ulog.async_rb, (rt_uint8_t *)log, (rt_uint16_t)log_len);
-            log[log_len] = '\0';
-            ulog_output_to_all_backend(LOG_LVL_DBG, "", RT_TRUE, log, len);
-            rt_free(log);
+            deferred_async_output(log_frame);
         }
+#endif
+        async_ring_free(rec, pos);
     }
 }
 
@@ -1388,6 +2292,21 @@ void ulog_async_output_enabled(rt_bool_t enabled)
     ulog.async_enabled = enabled;
 }
 
+/**
+ * set the async output policy when the async output buffer is full
+ *
+ * @param policy ULOG_ASYNC_DROP_NEWEST: drop the log which is being output
+ *               ULOG_ASYNC_DROP_OLDEST: drop the oldest logs in the buffer
+ *               ULOG_ASYNC_BLOCK: the thread waits ULOG_ASYNC_OUTPUT_BLOCK_TIMEOUT ms at most for the room,
+ *                                 the ISR log is dropped
+ */
+void ulog_async_policy_set(rt_uint8_t policy)
+{
+    RT_ASSERT(policy <= ULOG_ASYNC_BLOCK);
+
+    ulog.async_ring.policy = policy;
+}
+
 /**
  * waiting for get asynchronous output log
  *
@@ -1426,6 +2345,68 @@ static void async_output_thread_entry(void *param)
         }
     }
 }
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void ulog_async(uint8_t argc, char **argv)
+{
+    static const char * const policy_name[] = {"newest", "oldest", "block"};
+    rt_size_t used, high_water;
+    int i;
+
+    if (!ulog.init_ok)
+    {
+        return;
+    }
+
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        rt_atomic_store(&ulog.async_ring.high_water, 0);
+        for (i = 0; i <= LOG_LVL_DBG; i++)
+        {
+            rt_atomic_store(&ulog.async_ring.drops[i], 0);
+        }
+        return;
+    }
+    else if (argc > 2 && !rt_strcmp(argv[1], "policy"))
+    {
+        for (i = 0; i <= ULOG_ASYNC_BLOCK; i++)
+        {
+            if (!rt_strcmp(argv[2], policy_name[i]))
+            {
+                ulog_async_policy_set(i);
+                return;
+            }
+        }
+        rt_kprintf("Please input: ulog_async policy <newest|oldest|block>.\n");
+        return;
+    }
+    else if (argc > 1)
+    {
+        rt_kprintf("Please input: ulog_async [reset|policy <newest|oldest|block>].\n");
+        return;
+    }
+
+    used = async_ring_used(rt_atomic_load(&ulog.async_ring.tail) & ~ASYNC_RING_BUSY,
+            rt_atomic_load(&ulog.async_ring.head));
+    high_water = rt_atomic_load(&ulog.async_ring.high_water);
+    rt_kprintf("buffer    : %u bytes, used %u, high water %u (%u%%)\n", (unsigned int)ulog.async_ring.size,
+            (unsigned int)used, (unsigned int)high_water, (unsigned int)(high_water * 100 / ulog.async_ring.size));
+    rt_kprintf("policy    : %s%s\n", ulog.async_ring.policy == ULOG_ASYNC_BLOCK ? "" : "drop ",
+            policy_name[ulog.async_ring.policy]);
+    rt_kprintf("dropped   :");
+    for (i = 0; i <= LOG_LVL_DBG; i++)
+    {
+        if (level_output_info[i])
+        {
+            rt_kprintf(" %c %u", level_output_info[i][0], (unsigned int)rt_atomic_load(&ulog.async_ring.drops[i]));
+        }
+    }
+    rt_kprintf("\n");
+}
+MSH_CMD_EXPORT(ulog_async, Show ulog async buffer statistics: ulog_async [reset|policy <newest|oldest|block>]);
+#endif /* RT_USING_FINSH */
 #endif /* ULOG_USING_ASYNC_OUTPUT */
 
 /**
@@ -1465,19 +2446,25 @@ int ulog_init(void)
 
 #ifdef ULOG_USING_FILTER
     rt_slist_init(ulog_tag_lvl_list_get());
+    rt_memset(ulog.filter.tag_lvl_hash, 0, sizeof(ulog.filter.tag_lvl_hash));
+    tag_lvl_generation_update();
 #endif
 
 #ifdef ULOG_USING_ASYNC_OUTPUT
-    RT_ASSERT(ULOG_ASYNC_OUTPUT_STORE_LINES >= 2);
     ulog.async_enabled = RT_TRUE;
-    /* async output ring block buffer */
-    ulog.async_rbb = rt_rbb_create(RT_ALIGN(ULOG_ASYNC_OUTPUT_BUF_SIZE, RT_ALIGN_SIZE), ULOG_ASYNC_OUTPUT_STORE_LINES);
-    if (ulog.async_rbb == RT_NULL)
+    /* async output ring, it is cleared for the records state */
+    ulog.async_ring.size = RT_ALIGN_DOWN(ULOG_ASYNC_OUTPUT_BUF_SIZE, RT_ALIGN_SIZE);
+    ulog.async_ring.wrap = (ASYNC_RING_BUSY / ulog.async_ring.size) * ulog.async_ring.size;
+    ulog.async_ring.buf = rt_malloc(ulog.async_ring.size);
+    if (ulog.async_ring.buf == RT_NULL)
     {
-        rt_kprintf("Error: ulog init failed! No memory for async rbb.\n");
+        rt_kprintf("Error: ulog init failed! No memory for async buffer.\n");
         rt_mutex_detach(&ulog.output_locker);
         return -RT_ENOMEM;
     }
+    rt_memset(ulog.async_ring.buf, 0, ulog.async_ring.size);
+    ulog.async_ring.policy = ULOG_ASYNC_OUTPUT_POLICY;
+    rt_sem_init(&ulog.async_ring.room, "ulog_rm", 0, RT_IPC_FLAG_FIFO);
     rt_sem_init(&ulog.async_notice, "ulog", 0, RT_IPC_FLAG_FIFO);
 #endif /* ULOG_USING_ASYNC_OUTPUT */
 
@@ -1534,21 +2521,23 @@ void ulog_deinit(void)
     /* deinit tag's level filter */
     {
         ulog_tag_lvl_filter_t tag_lvl;
-        for (node = rt_slist_first(ulog_tag_lvl_list_get()); node; node = rt_slist_next(node))
+        for (node = rt_slist_first(ulog_tag_lvl_list_get()); node; )
         {
             tag_lvl = rt_slist_entry(node, struct ulog_tag_lvl_filter, list);
+            node = rt_slist_next(node);
             rt_free(tag_lvl);
         }
+        rt_memset(ulog.filter.tag_lvl_hash, 0, sizeof(ulog.filter.tag_lvl_hash));
+        tag_lvl_generation_update();
     }
 #endif /* ULOG_USING_FILTER */
 
     rt_mutex_detach(&ulog.output_locker);
 
 #ifdef ULOG_USING_ASYNC_OUTPUT
-    rt_rbb_destroy(ulog.async_rbb);
     rt_thread_delete(ulog.async_th);
-    if (ulog.async_rb)
-        rt_ringbuffer_destroy(ulog.async_rb);
+    rt_sem_detach(&ulog.async_ring.room);
+    rt_free(ulog.async_ring.buf);
 #endif
 
     ulog.init_ok = RT_FALSE;
@@ -39,6 +39,9 @@ void ulog_deinit(void);
  *
  * LOG_D("this is a debug log!");
  * LOG_E("this is a error log!");
+ *
+ * NOTE: When ULOG_USING_DEFERRED is enabled, the format of LOG_X API must be a string literal.
+ * Define `ULOG_DEFERRED_DISABLE` before including the <ulog.h> to format the log at the call site.
  */
 #define LOG_E(...)                      ulog_e(LOG_TAG, __VA_ARGS__)
 #define LOG_W(...)                      ulog_w(LOG_TAG, __VA_ARGS__)
@@ -68,6 +71,7 @@ void ulog_global_filter_tag_set(const char *tag);
 const char *ulog_global_filter_tag_get(void);
 void ulog_global_filter_kw_set(const char *keyword);
 const char *ulog_global_filter_kw_get(void);
+void ulog_output_cached(struct ulog_tag_lvl_cache *cache, rt_uint32_t level, const char *tag, const char *format, ...);
 #endif /* ULOG_USING_FILTER */
 
 /*
@@ -82,6 +86,15 @@ void ulog_flush(void);
 void ulog_async_output(void);
 void ulog_async_output_enabled(rt_bool_t enabled);
 rt_err_t ulog_async_waiting_log(rt_int32_t time);
+void ulog_async_policy_set(rt_uint8_t policy);
+#endif
+
+#ifdef ULOG_USING_DEFERRED
+/*
+ * deferred output API
+ */
+void ulog_deferred_output(const struct ulog_fmt *fmt, struct ulog_tag_lvl_cache *cache, ...);
+void ulog_deferred_binary_enabled(rt_bool_t enabled);
 #endif
 
 /*
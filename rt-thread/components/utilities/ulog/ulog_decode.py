@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright (c) 2006-2026, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-16     RT-Thread    first version
+#
+# Decode the ulog deferred log records into text.
+#
+# Enable ULOG_USING_DEFERRED and run 'ulog_bin on', then the console and file
+# backends output the binary records. The formats are read from the ULogFmtTab
+# section of the ELF file which is running on the target. The text output by
+# the others (rt_kprintf, LOG_RAW, LOG_HEX) is passed through.
+#
+# usage: ulog_decode.py [-o log.txt] <rtthread.elf> [capture]
+#        cat /dev/ttyUSB0 | ulog_decode.py rtthread.elf
+
+import argparse
+import re
+import struct
+import sys
+
+ULOG_DEFERRED_SYNC = 0xA5
+
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+LEVEL_NAMES = {0: 'A', 3: 'E', 4: 'W', 6: 'I', 7: 'D'}
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|L|z|t|j)?([diouxXcpsfFeEgGaA%])')
+
+
+class Elf(object):
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+
+        self.word = 4 if self.data[4] == 1 else 8
+        self.endian = '<' if self.data[5] == 1 else '>'
+        if self.word == 4:
+            shoff, = struct.unpack_from(self.endian + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(self.endian + 'HH', self.data, 0x2E)
+            layout = 'IIIIIIIIII'
+        else:
+            shoff, = struct.unpack_from(self.endian + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(self.endian + 'HH', self.data, 0x3A)
+            layout = 'IIQQQQIIQQ'
+
+        # name, type, flags, addr, offset, size, link, info, addralign, entsize
+        self.sections = [struct.unpack_from(self.endian + layout, self.data, shoff + i * shentsize)
+                         for i in range(shnum)]
+
+    def symbols(self):
+        result = {}
+        for section in self.sections:
+            if section[1] != SHT_SYMTAB:
+                continue
+            strtab = self.sections[section[6]]
+            entry = 16 if self.word == 4 else 24
+            for offset in range(section[4], section[4] + section[5], entry):
+                if self.word == 4:
+                    name, value = struct.unpack_from(self.endian + 'II', self.data, offset)
+                else:
+                    name, _, _, _, value = struct.unpack_from(self.endian + 'IBBHQ', self.data, offset)
+                start = strtab[4] + name
+                result[self.data[start:self.data.index(b'\0', start)].decode()] = value
+        return result
+
+    def read(self, address, size):
+        for section in self.sections:
+            if section[2] & SHF_ALLOC and section[1] != SHT_NOBITS \
+                    and section[3] <= address and address + size <= section[3] + section[5]:
+                offset = section[4] + address - section[3]
+                return self.data[offset:offset + size]
+        raise ValueError('address 0x%x is not in the ELF file' % address)
+
+    def read_word(self, address):
+        return struct.unpack(self.endian + ('I' if self.word == 4 else 'Q'), self.read(address, self.word))[0]
+
+    def read_string(self, address):
+        for section in self.sections:
+            if section[2] & SHF_ALLOC and section[1] != SHT_NOBITS \
+                    and section[3] <= address < section[3] + section[5]:
+                start = section[4] + address - section[3]
+                return self.data[start:self.data.index(b'\0', start)].decode('utf-8', errors='replace')
+        raise ValueError('address 0x%x is not in the ELF file' % address)
+
+
+def load_formats(elf):
+    symbols = elf.symbols()
+    if '__ulogfmt_start' not in symbols:
+        raise ValueError('no ULogFmtTab section, is ULOG_USING_DEFERRED enabled?')
+    start, end = symbols['__ulogfmt_start'], symbols['__ulogfmt_end']
+
+    # struct ulog_fmt { const char *tag; const char *format; rt_uint32_t level; }
+    size = (2 * elf.word + 4 + elf.word - 1) // elf.word * elf.word
+    formats = []
+    for address in range(start, end, size):
+        tag = elf.read_string(elf.read_word(address))
+        fmt = elf.read_string(elf.read_word(address + elf.word))
+        level, = struct.unpack(elf.endian + 'I', elf.read(address + 2 * elf.word, 4))
+        formats.append((tag, fmt, level))
+    return formats
+
+
+class Decoder(object):
+    def __init__(self, elf, formats):
+        self.endian = elf.endian
+        self.word = elf.word
+        self.formats = formats
+        self.pending = b''
+
+    def unpack(self, kind, args, pos):
+        size, code = {
+            'int': (4, 'i'), 'uint': (4, 'I'),
+            'long': (self.word, 'i' if self.word == 4 else 'q'), 'ulong': (self.word, 'I' if self.word == 4 else 'Q'),
+            'llong': (8, 'q'), 'ullong': (8, 'Q'), 'double': (8, 'd'),
+        }[kind]
+        if pos + size > len(args):
+            raise IndexError
+        return struct.unpack_from(self.endian + code, args, pos)[0], pos + size
+
+    def render(self, fmt, args):
+        """format the arguments like rt_vsnprintf"""
+        out, pos, last = [], 0, 0
+        try:
+            for m in CONVERSION.finditer(fmt):
+                out.append(fmt[last:m.start()])
+                last = m.end()
+                flags, width, precision, length, conv = m.groups()
+                if conv == '%':
+                    out.append('%')
+                    continue
+                if width == '*':
+                    width, pos = self.unpack('int', args, pos)
+                    width = str(width)
+                if precision == '*':
+                    precision, pos = self.unpack('int', args, pos)
+                    precision = str(precision)
+                spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+
+                if conv == 's':
+                    if pos + 2 > len(args) or pos + args[pos] + 2 > len(args) or args[pos + args[pos] + 1] != 0:
+                        raise IndexError
+                    value = args[pos + 1:pos + 1 + args[pos]].decode('utf-8', errors='replace')
+                    pos += args[pos] + 2
+                    out.append((spec + 's') % value)
+                elif conv in 'fFeEgGaA':
+                    value, pos = self.unpack('double', args, pos)
+                    out.append(value.hex() if conv in 'aA' else (spec + conv) % value)
+                elif conv == 'p':
+                    value, pos = self.unpack('ulong', args, pos)
+                    out.append('0x%0*x' % (self.word * 2, value) if width is None else (spec + 'x') % value)
+                else:
+                    if length in ('ll', 'j'):
+                        kind = 'llong'
+                    elif length in ('l', 'z', 't'):
+                        kind = 'long'
+                    else:
+                        kind = 'int'
+                    if conv not in 'di':
+                        kind = 'u' + kind
+                    value, pos = self.unpack(kind, args, pos)
+                    if conv == 'c':
+                        out.append((spec + 'c') % chr(value & 0xFF))
+                    else:
+                        out.append((spec + ('d' if conv in 'iu' else conv)) % value)
+        except IndexError:
+            # the target cuts the log at the first argument which was not recorded
+            return ''.join(out)
+        out.append(fmt[last:])
+        return ''.join(out)
+
+    def record(self, data, offset):
+        """decode a record at offset, returns (text, size), None if it is not a record"""
+        if len(data) - offset < 8:
+            return None
+        sync, length, ident, tick = struct.unpack_from(self.endian + 'BBHI', data, offset)
+        if sync != ULOG_DEFERRED_SYNC or ident >= len(self.formats):
+            return None
+        if len(data) - offset < 8 + length:
+            return None
+        tag, fmt, level = self.formats[ident]
+        text = self.render(fmt, data[offset + 8:offset + 8 + length])
+        return '[%d] %s/%s: %s\n' % (tick, LEVEL_NAMES.get(level, '?'), tag, text), 8 + length
+
+    def feed(self, chunk, final=False):
+        """decode the captured bytes, the partial record at the end waits for the next chunk"""
+        data = self.pending + chunk
+        out, text, offset = [], bytearray(), 0
+        while offset < len(data):
+            if data[offset] == ULOG_DEFERRED_SYNC:
+                # wait for the rest of the record
+                if not final and len(data) - offset < 8 + (data[offset + 1] if offset + 1 < len(data) else 255):
+                    break
+                result = self.record(data, offset)
+                if result:
+                    if text:
+                        out.append(text.decode('utf-8', errors='replace'))
+                        text = bytearray()
+                    out.append(result[0])
+                    offset += result[1]
+                    continue
+            text.append(data[offset])
+            offset += 1
+        if text:
+            out.append(text.decode('utf-8', errors='replace'))
+        self.pending = data[offset:]
+        return ''.join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode the ulog deferred log records into text')
+    parser.add_argument('elf', help='the ELF file running on the target')
+    parser.add_argument('capture', nargs='?', help='binary capture of the console or log file, default stdin')
+    parser.add_argument('-o', '--output', help='output text file, default stdout')
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    decoder = Decoder(elf, load_formats(elf))
+
+    source = open(args.capture, 'rb') if args.capture else sys.stdin.buffer
+    output = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        while True:
+            chunk = source.read1(4096) if hasattr(source, 'read1') else source.read(4096)
+            if not chunk:
+                break
+            output.write(decoder.feed(chunk))
+            output.flush()
+        output.write(decoder.feed(b'', final=True))
+    finally:
+        if args.capture:
+            source.close()
+        if args.output:
+            output.close()
+
+
+if __name__ == '__main__':
+    main()
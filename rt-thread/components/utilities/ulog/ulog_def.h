@@ -76,26 +76,41 @@ extern "C" {
     #endif
 #endif /* !defined(LOG_LVL) */
 
+#if defined(ULOG_USING_DEFERRED) && !defined(ULOG_DEFERRED_DISABLE)
+    /* record the format id and the arguments only, the text is rendered later */
+    #define ulog_lvl_output(LVL, TAG, ...) ulog_deferred(LVL, TAG, __VA_ARGS__)
+#elif defined(ULOG_USING_FILTER)
+    /* the call site caches its tag's level filter */
+    #define ulog_lvl_output(LVL, TAG, ...)                                          \
+        do                                                                          \
+        {                                                                           \
+            static struct ulog_tag_lvl_cache __ulog_lvl_cache;                      \
+            ulog_output_cached(&__ulog_lvl_cache, LVL, TAG, __VA_ARGS__);           \
+        } while (0)
+#else
+    #define ulog_lvl_output(LVL, TAG, ...) ulog_output(LVL, TAG, RT_TRUE, __VA_ARGS__)
+#endif /* defined(ULOG_USING_DEFERRED) && !defined(ULOG_DEFERRED_DISABLE) */
+
 #if (LOG_LVL >= LOG_LVL_DBG) && (ULOG_OUTPUT_LVL >= LOG_LVL_DBG)
-    #define ulog_d(TAG, ...)           ulog_output(LOG_LVL_DBG, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_d(TAG, ...)           ulog_lvl_output(LOG_LVL_DBG, TAG, __VA_ARGS__)
 #else
     #define ulog_d(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_DBG) && (ULOG_OUTPUT_LVL >= LOG_LVL_DBG) */
 
 #if (LOG_LVL >= LOG_LVL_INFO) && (ULOG_OUTPUT_LVL >= LOG_LVL_INFO)
-    #define ulog_i(TAG, ...)           ulog_output(LOG_LVL_INFO, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_i(TAG, ...)           ulog_lvl_output(LOG_LVL_INFO, TAG, __VA_ARGS__)
 #else
     #define ulog_i(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_INFO) && (ULOG_OUTPUT_LVL >= LOG_LVL_INFO) */
 
 #if (LOG_LVL >= LOG_LVL_WARNING) && (ULOG_OUTPUT_LVL >= LOG_LVL_WARNING)
-    #define ulog_w(TAG, ...)           ulog_output(LOG_LVL_WARNING, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_w(TAG, ...)           ulog_lvl_output(LOG_LVL_WARNING, TAG, __VA_ARGS__)
 #else
     #define ulog_w(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_WARNING) && (ULOG_OUTPUT_LVL >= LOG_LVL_WARNING) */
 
 #if (LOG_LVL >= LOG_LVL_ERROR) && (ULOG_OUTPUT_LVL >= LOG_LVL_ERROR)
-    #define ulog_e(TAG, ...)           ulog_output(LOG_LVL_ERROR, TAG, RT_TRUE, __VA_ARGS__)
+    #define ulog_e(TAG, ...)           ulog_lvl_output(LOG_LVL_ERROR, TAG, __VA_ARGS__)
 #else
     #define ulog_e(TAG, ...)
 #endif /* (LOG_LVL >= LOG_LVL_ERROR) && (ULOG_OUTPUT_LVL >= LOG_LVL_ERROR) */
@@ -167,6 +182,11 @@ extern "C" {
 #define ULOG_FILTER_TAG_MAX_LEN        23
 #endif
 
+/* output filter's tag hash table size, it must be power of 2 */
+#ifndef ULOG_FILTER_TAG_HASH_SIZE
+#define ULOG_FILTER_TAG_HASH_SIZE      16
+#endif
+
 /* output filter's keyword max length */
 #ifndef ULOG_FILTER_KW_MAX_LEN
 #define ULOG_FILTER_KW_MAX_LEN         15
@@ -176,7 +196,25 @@ extern "C" {
 #define ULOG_NEWLINE_SIGN              "\r\n"
 #endif
 
+/* the async output policy when the async output buffer is full */
+#define ULOG_ASYNC_DROP_NEWEST         0
+#define ULOG_ASYNC_DROP_OLDEST         1
+#define ULOG_ASYNC_BLOCK               2
+
+#ifndef ULOG_ASYNC_OUTPUT_BLOCK_TIMEOUT
+#define ULOG_ASYNC_OUTPUT_BLOCK_TIMEOUT 10
+#endif
+
 #define ULOG_FRAME_MAGIC               0x10
+#define ULOG_DEFERRED_FRAME_MAGIC      0x11
+
+/* max length of the arguments recorded by a deferred log */
+#ifndef ULOG_DEFERRED_ARGS_MAX
+#define ULOG_DEFERRED_ARGS_MAX         64
+#endif
+
+/* first byte of every deferred record, the decoder syncs on it */
+#define ULOG_DEFERRED_SYNC             0xA5
 
 /* tag's level filter */
 struct ulog_tag_lvl_filter
@@ -184,9 +222,19 @@ struct ulog_tag_lvl_filter
     char tag[ULOG_FILTER_TAG_MAX_LEN + 1];
     rt_uint32_t level;
     rt_slist_t list;
+    /* next one in the same bucket of the tag hash table */
+    struct ulog_tag_lvl_filter *hash_next;
 };
 typedef struct ulog_tag_lvl_filter *ulog_tag_lvl_filter_t;
 
+/* the tag's level filter cached by a call site, it is valid until the tag's level filters change */
+struct ulog_tag_lvl_cache
+{
+    rt_atomic_t generation;
+    const char *tag;
+    rt_uint32_t level;
+};
+
 struct ulog_frame
 {
     /* magic word is 0x10 ('lo') */
@@ -199,6 +247,45 @@ struct ulog_frame
 };
 typedef struct ulog_frame *ulog_frame_t;
 
+/* the format of a deferred log, all of them are collected in the ULogFmtTab section */
+struct ulog_fmt
+{
+    const char *tag;
+    const char *format;
+    rt_uint32_t level;
+};
+
+/*
+ * deferred log record, it is followed by the arguments:
+ * int: 4 bytes, long and pointer: sizeof(long), long long and double: 8 bytes,
+ * string: 1 byte length, the characters and the end sign.
+ * All of them are in the byte order of the CPU.
+ */
+struct ulog_deferred_record
+{
+    rt_uint8_t  sync;                  /* ULOG_DEFERRED_SYNC */
+    rt_uint8_t  len;                   /* length of the arguments */
+    rt_uint16_t id;                    /* index of the format in the ULogFmtTab section */
+    rt_uint32_t tick;
+};
+
+#ifdef ULOG_USING_FILTER
+#define ulog_deferred(LVL, TAG, FMT, ...)                                                       \
+    do                                                                                          \
+    {                                                                                           \
+        rt_used static const struct ulog_fmt __ulog_fmt rt_section("ULogFmtTab") = {TAG, FMT, LVL}; \
+        static struct ulog_tag_lvl_cache __ulog_lvl_cache;                                      \
+        ulog_deferred_output(&__ulog_fmt, &__ulog_lvl_cache, ##__VA_ARGS__);                    \
+    } while (0)
+#else
+#define ulog_deferred(LVL, TAG, FMT, ...)                                                       \
+    do                                                                                          \
+    {                                                                                           \
+        rt_used static const struct ulog_fmt __ulog_fmt rt_section("ULogFmtTab") = {TAG, FMT, LVL}; \
+        ulog_deferred_output(&__ulog_fmt, RT_NULL, ##__VA_ARGS__);                              \
+    } while (0)
+#endif /* ULOG_USING_FILTER */
+
 struct ulog_backend
 {
     char name[RT_NAME_MAX];
@@ -210,6 +297,8 @@ struct ulog_backend
     void (*deinit)(struct ulog_backend *backend);
     /* The filter will be call before output. It will return TRUE when the filter condition is math. */
     rt_bool_t (*filter)(struct ulog_backend *backend, rt_uint32_t level, const char *tag, rt_bool_t is_raw, const char *log, rt_size_t len);
+    /* Optional. It receives the deferred log records when the binary output is enabled, the text log otherwise. */
+    void (*output_bin)(struct ulog_backend *backend, const void *buf, rt_size_t len);
     rt_slist_t list;
 };
 typedef struct ulog_backend *ulog_backend_t;
@@ -329,6 +329,12 @@ typedef int (*init_fn_t)(void);
  */
 #define RT_OBJECT_FLAG_MODULE           0x80            /**< is module object. */
 
+#ifdef RT_USING_OBJECT_HASH
+#ifndef RT_OBJECT_HASH_SIZE
+#define RT_OBJECT_HASH_SIZE             16              /**< name hash buckets of each object class */
+#endif
+#endif /* RT_USING_OBJECT_HASH */
+
 /**
  * Base structure of Kernel object
  */
@@ -351,6 +357,10 @@ struct rt_object
 #endif /* RT_USING_SMART */
 
     rt_list_t   list;                                    /**< list node of kernel object */
+
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                         /**< next object in the same name hash bucket */
+#endif /* RT_USING_OBJECT_HASH */
 };
 typedef struct rt_object *rt_object_t;                   /**< Type for kernel objects. */
 
@@ -403,6 +413,9 @@ struct rt_object_information
     rt_list_t                 object_list;              /**< object list */
     rt_size_t                 object_size;              /**< object size */
     struct rt_spinlock        spinlock;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object         *hash_table[RT_OBJECT_HASH_SIZE]; /**< objects indexed by name hash */
+#endif /* RT_USING_OBJECT_HASH */
 };
 
 /**
@@ -899,6 +912,7 @@ struct rt_thread
 
 #ifdef RT_USING_CPU_USAGE
     rt_uint64_t                 duration_tick;          /**< cpu usage tick */
+    rt_uint32_t                 max_slice_tick;         /**< the longest time slice in cpu usage tick */
 #endif /* RT_USING_CPU_USAGE */
 
 #ifdef RT_USING_PTHREADS
@@ -998,7 +1012,11 @@ struct rt_semaphore
 {
     struct rt_ipc_object parent;                        /**< inherit from ipc_object */
 
+#ifdef RT_USING_IPC_FASTPATH
+    rt_atomic_t          value;                         /**< value of semaphore, updated atomically. */
+#else
     rt_uint16_t          value;                         /**< value of semaphore. */
+#endif /* RT_USING_IPC_FASTPATH */
     rt_uint16_t          max_value;
     struct rt_spinlock   spinlock;
 };
@@ -1130,6 +1148,10 @@ typedef rt_mem_t rt_smem_t;
 typedef rt_mem_t rt_slab_t;
 #endif /* RT_USING_SLAB */
 
+#ifdef RT_USING_TLSF_MEM
+typedef rt_mem_t rt_tlsf_t;
+#endif /* RT_USING_TLSF_MEM */
+
 #ifdef RT_USING_MEMHEAP
 /**
  * memory item on the heap
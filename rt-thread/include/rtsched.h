@@ -130,6 +130,10 @@ rt_err_t rt_sched_unlock_n_resched(rt_sched_lock_level_t level);
 
 rt_bool_t rt_sched_is_locked(void);
 
+#ifdef RT_USING_CPU_USAGE
+rt_uint64_t rt_sched_usage_irq_tick(int cpu);
+#endif /* RT_USING_CPU_USAGE */
+
 #ifdef RT_USING_SMP
 #define RT_SCHED_DEBUG_IS_LOCKED do { RT_ASSERT(rt_sched_is_locked()); } while (0)
 #define RT_SCHED_DEBUG_IS_UNLOCKED do { RT_ASSERT(!rt_sched_is_locked()); } while (0)
@@ -171,6 +175,13 @@ rt_err_t rt_sched_thread_timer_start(struct rt_thread *thread);
 void rt_sched_insert_thread(struct rt_thread *thread);
 void rt_sched_remove_thread(struct rt_thread *thread);
 
+#ifdef RT_USING_CPU_USAGE
+/* cpu usage accounting */
+void rt_sched_usage_switch(struct rt_thread *from, struct rt_thread *to);
+void rt_sched_usage_irq_enter(void);
+void rt_sched_usage_irq_leave(void);
+#endif /* RT_USING_CPU_USAGE */
+
 #endif /* defined(__RT_KERNEL_SOURCE__) || defined(__RT_IPC_SOURCE__) */
 
 #ifdef __cplusplus
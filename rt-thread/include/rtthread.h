@@ -84,6 +84,9 @@ void rt_object_detach_sethook(void (*hook)(struct rt_object *object));
 void rt_object_trytake_sethook(void (*hook)(struct rt_object *object));
 void rt_object_take_sethook(void (*hook)(struct rt_object *object));
 void rt_object_put_sethook(void (*hook)(struct rt_object *object));
+void (*rt_object_trytake_gethook(void))(struct rt_object *object);
+void (*rt_object_take_gethook(void))(struct rt_object *object);
+void (*rt_object_put_gethook(void))(struct rt_object *object);
 #endif /* RT_USING_HOOK */
 
 /**@}*/
@@ -131,6 +134,8 @@ void rt_timer_check(void);
 #ifdef RT_USING_HOOK
 void rt_timer_enter_sethook(void (*hook)(struct rt_timer *timer));
 void rt_timer_exit_sethook(void (*hook)(struct rt_timer *timer));
+void (*rt_timer_enter_gethook(void))(struct rt_timer *timer);
+void (*rt_timer_exit_gethook(void))(struct rt_timer *timer);
 #endif /* RT_USING_HOOK */
 
 /**@}*/
@@ -185,6 +190,8 @@ int  rt_thread_kill(rt_thread_t tid, int sig);
 #ifdef RT_USING_HOOK
 void rt_thread_suspend_sethook(void (*hook)(rt_thread_t thread));
 void rt_thread_resume_sethook (void (*hook)(rt_thread_t thread));
+void (*rt_thread_suspend_gethook(void))(rt_thread_t thread);
+void (*rt_thread_resume_gethook(void))(rt_thread_t thread);
 
 /**
  * @brief Sets a hook function when a thread is initialized.
@@ -233,6 +240,7 @@ rt_uint16_t rt_critical_level(void);
 
 #ifdef RT_USING_HOOK
 void rt_scheduler_sethook(void (*hook)(rt_thread_t from, rt_thread_t to));
+void (*rt_scheduler_gethook(void))(rt_thread_t from, rt_thread_t to);
 void rt_scheduler_switch_sethook(void (*hook)(struct rt_thread *tid));
 #endif /* RT_USING_HOOK */
 
@@ -285,6 +293,8 @@ void rt_mp_free(void *block);
 #ifdef RT_USING_HOOK
 void rt_mp_alloc_sethook(void (*hook)(struct rt_mempool *mp, void *block));
 void rt_mp_free_sethook(void (*hook)(struct rt_mempool *mp, void *block));
+void (*rt_mp_alloc_gethook(void))(struct rt_mempool *mp, void *block);
+void (*rt_mp_free_gethook(void))(struct rt_mempool *mp, void *block);
 #endif /* RT_USING_HOOK */
 
 #endif /* RT_USING_MEMPOOL */
@@ -373,6 +383,17 @@ void *rt_slab_realloc(rt_slab_t m, void *ptr, rt_size_t size);
 void rt_slab_free(rt_slab_t m, void *ptr);
 #endif /* RT_USING_SLAB */
 
+#ifdef RT_USING_TLSF_MEM
+/**
+ * TLSF memory object interface
+ */
+rt_tlsf_t rt_tlsf_init(const char *name, void *begin_addr, rt_size_t size);
+rt_err_t rt_tlsf_detach(rt_tlsf_t m);
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size);
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize);
+void rt_tlsf_free(rt_tlsf_t m, void *rmem);
+#endif /* RT_USING_TLSF_MEM */
+
 /**@}*/
 
 /**
@@ -580,6 +601,11 @@ rt_ssize_t rt_mq_recv_killable(rt_mq_t    mq,
                     rt_int32_t timeout);
 rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg);
 
+rt_err_t rt_mq_reserve(rt_mq_t mq, void **buffer, rt_int32_t timeout);
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer, rt_size_t size);
+rt_ssize_t rt_mq_borrow(rt_mq_t mq, void **buffer, rt_int32_t timeout);
+rt_err_t rt_mq_release(rt_mq_t mq, void *buffer);
+
 #ifdef RT_USING_MESSAGEQUEUE_PRIORITY
 rt_err_t rt_mq_send_wait_prio(rt_mq_t mq,
                               const void *buffer,
@@ -722,6 +748,8 @@ rt_uint8_t rt_interrupt_get_nest(void);
 #ifdef RT_USING_HOOK
 void rt_interrupt_enter_sethook(void (*hook)(void));
 void rt_interrupt_leave_sethook(void (*hook)(void));
+void (*rt_interrupt_enter_gethook(void))(void);
+void (*rt_interrupt_leave_gethook(void))(void);
 #endif /* RT_USING_HOOK */
 
 #ifdef RT_USING_COMPONENTS_INIT
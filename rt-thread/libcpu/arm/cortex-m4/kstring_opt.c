@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_KSERVICE_USING_ARCH_OPTIMIZED
+
+/*
+ * Word oriented string routines for Cortex-M4. They replace the generic
+ * versions in src/klibc/kstring.c, which are renamed to rt_*_generic with
+ * this option and only used by 'kstring_bench'.
+ *
+ * The bulk loops move eight (memcpy/memset) or four (shift-merge) words per
+ * iteration, which the compiler turns into LDM/STM bursts. A source that is
+ * not co-aligned with the destination is read as aligned words and the bytes
+ * are merged with shifts, so no unaligned or byte access is made in the bulk
+ * loop. The aligned reads never touch a word that holds no byte of the buffer.
+ */
+
+#ifdef ARCH_CPU_BIG_ENDIAN
+#define MERGE(lo, hi, rs, ls)       (((lo) << (rs)) | ((hi) >> (ls)))
+#else
+#define MERGE(lo, hi, rs, ls)       (((lo) >> (rs)) | ((hi) << (ls)))
+#endif /* ARCH_CPU_BIG_ENDIAN */
+
+#define WORD_UNALIGNED(x)           ((rt_ubase_t)(x) & 3)
+#define WORD_HAS_ZERO(w)            (((w) - 0x01010101UL) & ~(w) & 0x80808080UL)
+
+#if defined(RT_KSERVICE_USING_STDLIB_MEMORY) || defined(RT_KSERVICE_USING_TINY_SIZE)
+#error "RT_KSERVICE_USING_ARCH_OPTIMIZED can not be used with RT_KSERVICE_USING_STDLIB_MEMORY or RT_KSERVICE_USING_TINY_SIZE"
+#endif
+
+void *rt_memset(void *s, int c, rt_ubase_t count)
+{
+    rt_uint8_t *d = (rt_uint8_t *)s;
+    rt_uint8_t v = (rt_uint8_t)c;
+
+    if (count >= 16)
+    {
+        rt_uint32_t *dw;
+        rt_uint32_t w;
+
+        while (WORD_UNALIGNED(d))
+        {
+            *d++ = v;
+            count--;
+        }
+
+        w = v * 0x01010101UL;
+        dw = (rt_uint32_t *)d;
+        while (count >= 32)
+        {
+            dw[0] = w; dw[1] = w; dw[2] = w; dw[3] = w;
+            dw[4] = w; dw[5] = w; dw[6] = w; dw[7] = w;
+            dw += 8;
+            count -= 32;
+        }
+        while (count >= 4)
+        {
+            *dw++ = w;
+            count -= 4;
+        }
+        d = (rt_uint8_t *)dw;
+    }
+
+    while (count--)
+        *d++ = v;
+
+    return s;
+}
+RTM_EXPORT(rt_memset);
+
+void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
+{
+    rt_uint8_t *d = (rt_uint8_t *)dst;
+    const rt_uint8_t *s = (const rt_uint8_t *)src;
+
+    if (count >= 16)
+    {
+        rt_uint32_t *dw;
+        rt_uint32_t shift;
+
+        while (WORD_UNALIGNED(d))
+        {
+            *d++ = *s++;
+            count--;
+        }
+
+        dw = (rt_uint32_t *)d;
+        shift = WORD_UNALIGNED(s);
+        if (shift == 0)
+        {
+            const rt_uint32_t *sw = (const rt_uint32_t *)s;
+            rt_uint32_t w0, w1, w2, w3, w4, w5, w6, w7;
+
+            while (count >= 32)
+            {
+                w0 = sw[0]; w1 = sw[1]; w2 = sw[2]; w3 = sw[3];
+                w4 = sw[4]; w5 = sw[5]; w6 = sw[6]; w7 = sw[7];
+                dw[0] = w0; dw[1] = w1; dw[2] = w2; dw[3] = w3;
+                dw[4] = w4; dw[5] = w5; dw[6] = w6; dw[7] = w7;
+                sw += 8;
+                dw += 8;
+                count -= 32;
+            }
+            while (count >= 4)
+            {
+                *dw++ = *sw++;
+                count -= 4;
+            }
+            s = (const rt_uint8_t *)sw;
+        }
+        else
+        {
+            const rt_uint32_t *sw = (const rt_uint32_t *)(s - shift);
+            rt_uint32_t rs = shift * 8, ls = 32 - rs;
+            rt_uint32_t w0, w1, w2, w3, w4;
+
+            w0 = *sw++;
+            while (count >= 16)
+            {
+                w1 = sw[0]; w2 = sw[1]; w3 = sw[2]; w4 = sw[3];
+                dw[0] = MERGE(w0, w1, rs, ls);
+                dw[1] = MERGE(w1, w2, rs, ls);
+                dw[2] = MERGE(w2, w3, rs, ls);
+                dw[3] = MERGE(w3, w4, rs, ls);
+                w0 = w4;
+                sw += 4;
+                dw += 4;
+                count -= 16;
+            }
+            while (count >= 4)
+            {
+                w1 = *sw++;
+                *dw++ = MERGE(w0, w1, rs, ls);
+                w0 = w1;
+                count -= 4;
+            }
+            /* back to the first byte not copied */
+            s = (const rt_uint8_t *)sw - 4 + shift;
+        }
+        d = (rt_uint8_t *)dw;
+    }
+
+    while (count--)
+        *d++ = *s++;
+
+    return dst;
+}
+RTM_EXPORT(rt_memcpy);
+
+rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_size_t count)
+{
+    const rt_uint8_t *s1 = (const rt_uint8_t *)cs;
+    const rt_uint8_t *s2 = (const rt_uint8_t *)ct;
+
+    if (count >= 16)
+    {
+        const rt_uint32_t *w1;
+        rt_uint32_t shift;
+
+        while (WORD_UNALIGNED(s1))
+        {
+            if (*s1 != *s2)
+                return *s1 - *s2;
+            s1++;
+            s2++;
+            count--;
+        }
+
+        /* skip the equal words, the different one is located bytewise */
+        w1 = (const rt_uint32_t *)s1;
+        shift = WORD_UNALIGNED(s2);
+        if (shift == 0)
+        {
+            const rt_uint32_t *w2 = (const rt_uint32_t *)s2;
+
+            while (count >= 4 && *w1 == *w2)
+            {
+                w1++;
+                w2++;
+                count -= 4;
+            }
+            s2 = (const rt_uint8_t *)w2;
+        }
+        else
+        {
+            const rt_uint32_t *w2 = (const rt_uint32_t *)(s2 - shift);
+            rt_uint32_t rs = shift * 8, ls = 32 - rs;
+            rt_uint32_t lo = *w2++, hi;
+
+            while (count >= 4)
+            {
+                hi = *w2;
+                if (*w1 != MERGE(lo, hi, rs, ls))
+                    break;
+                lo = hi;
+                w1++;
+                w2++;
+                count -= 4;
+            }
+            s2 = (const rt_uint8_t *)w2 - 4 + shift;
+        }
+        s1 = (const rt_uint8_t *)w1;
+    }
+
+    while (count--)
+    {
+        if (*s1 != *s2)
+            return *s1 - *s2;
+        s1++;
+        s2++;
+    }
+
+    return 0;
+}
+RTM_EXPORT(rt_memcmp);
+
+#ifndef RT_KSERVICE_USING_STDLIB
+rt_size_t rt_strlen(const char *s)
+{
+    const char *sc = s;
+    const rt_uint32_t *w;
+
+    while (WORD_UNALIGNED(sc))
+    {
+        if (*sc == '\0')
+            return sc - s;
+        sc++;
+    }
+
+    /* an aligned word never crosses the end of the string's memory */
+    w = (const rt_uint32_t *)sc;
+    while (!WORD_HAS_ZERO(*w))
+        w++;
+
+    sc = (const char *)w;
+    while (*sc != '\0')
+        sc++;
+
+    return sc - s;
+}
+RTM_EXPORT(rt_strlen);
+#endif /* RT_KSERVICE_USING_STDLIB */
+
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
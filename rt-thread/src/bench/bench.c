@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#ifdef RT_DEBUGING_BENCH
+#include <stdlib.h>
+#include "bench.h"
+
+/**
+ * @brief Get the optional count argument of a bench command.
+ *
+ * @param argc is the argument count of the command.
+ *
+ * @param argv is the argument vector, argv[1] is the count if given.
+ *
+ * @param count is the default count.
+ *
+ * @param min is the smallest count accepted.
+ *
+ * @param max is the largest count accepted.
+ *
+ * @return the count, or -1 after printing the usage when it is out of range.
+ */
+int bench_get_count(int argc, char **argv, int count, int min, int max)
+{
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (argc > 2 || count < min || count > max)
+    {
+        rt_kprintf("Usage: %s [count, %d to %d]\n", argv[0], min, max);
+        return -1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Print the result of a bench command.
+ *
+ * @param name is the name of the command.
+ *
+ * @param failed is RT_TRUE when a check of the command failed.
+ *
+ * @return RT_EOK when passed, -RT_ERROR when failed.
+ */
+int bench_result(const char *name, rt_bool_t failed)
+{
+    rt_kprintf("%s: %s\n", name, failed ? "FAILED" : "PASS");
+
+    return failed ? -RT_ERROR : RT_EOK;
+}
+
+#endif /* RT_DEBUGING_BENCH */
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#ifndef __KERNEL_BENCH_H__
+#define __KERNEL_BENCH_H__
+
+#include <rtthread.h>
+
+#ifdef RT_USING_CPUTIME
+extern rt_uint64_t clock_cpu_gettime(void);
+
+/*
+ * All benchmarks are timed with the cputime counter, cycles on Cortex-M with
+ * RT_USING_CPUTIME_CORTEXM. Only differences of the low 32 bits are used, an
+ * interval must be shorter than one period of the counter.
+ */
+rt_inline rt_uint32_t bench_now(void)
+{
+    return (rt_uint32_t)clock_cpu_gettime();
+}
+#endif /* RT_USING_CPUTIME */
+
+int bench_get_count(int argc, char **argv, int count, int min, int max);
+int bench_result(const char *name, rt_bool_t failed);
+
+#endif /* __KERNEL_BENCH_H__ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_CPUTIME) && (defined(RT_USING_SEMAPHORE) || defined(RT_USING_MUTEX))
+#include <finsh.h>
+#include "bench.h"
+
+#define IPC_BENCH_ROUNDS    1000
+
+#ifdef RT_USING_SEMAPHORE
+/* the average cputime counts of an uncontended take and release pair */
+static rt_uint32_t _ipc_bench_sem(rt_sem_t sem, int rounds)
+{
+    rt_uint32_t start;
+    int round;
+
+    start = bench_now();
+    for (round = 0; round < rounds; round++)
+    {
+        rt_sem_take(sem, RT_WAITING_FOREVER);
+        rt_sem_release(sem);
+    }
+
+    return (bench_now() - start) / rounds;
+}
+#endif /* RT_USING_SEMAPHORE */
+
+#ifdef RT_USING_MUTEX
+static rt_uint32_t _ipc_bench_mutex(rt_mutex_t mutex, int rounds)
+{
+    rt_uint32_t start;
+    int round;
+
+    start = bench_now();
+    for (round = 0; round < rounds; round++)
+    {
+        rt_mutex_take(mutex, RT_WAITING_FOREVER);
+        rt_mutex_release(mutex);
+    }
+
+    return (bench_now() - start) / rounds;
+}
+#endif /* RT_USING_MUTEX */
+
+/*
+ * Prints the cost of uncontended take and release pairs on the path selected
+ * by RT_USING_IPC_FASTPATH. A mutex with a priority ceiling always runs the
+ * locked path, with the ceiling at the priority of the caller it gives the
+ * locked cost in the same build.
+ */
+static int ipc_bench(int argc, char **argv)
+{
+#ifdef RT_USING_SEMAPHORE
+    struct rt_semaphore sem;
+#endif
+#ifdef RT_USING_MUTEX
+    struct rt_mutex mutex;
+#endif
+    int rounds;
+
+    rounds = bench_get_count(argc, argv, IPC_BENCH_ROUNDS, 1, 100000);
+    if (rounds < 0)
+        return -RT_EINVAL;
+
+#ifdef RT_USING_IPC_FASTPATH
+    rt_kprintf("uncontended take and release, cputime counts per pair, fast path on\n");
+#else
+    rt_kprintf("uncontended take and release, cputime counts per pair, fast path off\n");
+#endif
+
+#ifdef RT_USING_SEMAPHORE
+    rt_sem_init(&sem, "ipcb", 1, RT_IPC_FLAG_PRIO);
+    rt_kprintf("semaphore     : %d\n", _ipc_bench_sem(&sem, rounds));
+    rt_sem_detach(&sem);
+#endif
+
+#ifdef RT_USING_MUTEX
+    rt_mutex_init(&mutex, "ipcb", RT_IPC_FLAG_PRIO);
+    rt_kprintf("mutex         : %d\n", _ipc_bench_mutex(&mutex, rounds));
+    rt_mutex_setprioceiling(&mutex, RT_SCHED_PRIV(rt_thread_self()).current_priority);
+    rt_kprintf("mutex, locked : %d\n", _ipc_bench_mutex(&mutex, rounds));
+    rt_mutex_detach(&mutex);
+#endif
+
+    return RT_EOK;
+}
+MSH_CMD_EXPORT(ipc_bench, measure uncontended semaphore and mutex take and release: ipc_bench [count]);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_CPUTIME && (RT_USING_SEMAPHORE || RT_USING_MUTEX) */
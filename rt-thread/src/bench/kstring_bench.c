@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_CPUTIME) && defined(RT_KSERVICE_USING_ARCH_OPTIMIZED)
+#include <finsh.h>
+#include "bench.h"
+
+#define KSTRING_BENCH_MAX       1024
+#define KSTRING_BENCH_ROUNDS    16
+
+void *rt_memset_generic(void *s, int c, rt_ubase_t count);
+void *rt_memcpy_generic(void *dst, const void *src, rt_ubase_t count);
+rt_int32_t rt_memcmp_generic(const void *cs, const void *ct, rt_size_t count);
+#ifndef RT_KSERVICE_USING_STDLIB
+rt_size_t rt_strlen_generic(const char *s);
+#endif
+
+/* the source is followed by the destination, each one has room for the offsets */
+static rt_uint32_t kstring_bench_buf[2][(KSTRING_BENCH_MAX + 8) / 4];
+
+enum kstring_bench_op
+{
+    KSTRING_BENCH_MEMCPY,
+    KSTRING_BENCH_MEMSET,
+    KSTRING_BENCH_MEMCMP,
+    KSTRING_BENCH_STRLEN,
+};
+
+/* the average cputime counts of a call, the call overhead is included */
+static rt_uint32_t kstring_bench_run(enum kstring_bench_op op, rt_bool_t generic, rt_size_t size,
+                                     rt_size_t dst_offset, rt_size_t src_offset)
+{
+    char *dst = (char *)kstring_bench_buf[1] + dst_offset;
+    char *src = (char *)kstring_bench_buf[0] + src_offset;
+    volatile rt_size_t sink = 0;
+    rt_uint32_t start, elapsed;
+    rt_base_t level;
+    int round;
+
+    rt_memset(kstring_bench_buf, 'a', sizeof(kstring_bench_buf));
+    src[size] = '\0';
+
+    level = rt_hw_interrupt_disable();
+    start = bench_now();
+    for (round = 0; round < KSTRING_BENCH_ROUNDS; round++)
+    {
+        switch (op)
+        {
+        case KSTRING_BENCH_MEMCPY:
+            sink += (rt_size_t)(generic ? rt_memcpy_generic(dst, src, size) : rt_memcpy(dst, src, size));
+            break;
+        case KSTRING_BENCH_MEMSET:
+            sink += (rt_size_t)(generic ? rt_memset_generic(dst, round, size) : rt_memset(dst, round, size));
+            break;
+        case KSTRING_BENCH_MEMCMP:
+            /* equal buffers, the whole size is compared */
+            sink += generic ? rt_memcmp_generic(dst, src, size) : rt_memcmp(dst, src, size);
+            break;
+        case KSTRING_BENCH_STRLEN:
+#ifndef RT_KSERVICE_USING_STDLIB
+            sink += generic ? rt_strlen_generic(src) : rt_strlen(src);
+#endif
+            break;
+        }
+    }
+    elapsed = bench_now() - start;
+    rt_hw_interrupt_enable(level);
+
+    return elapsed / KSTRING_BENCH_ROUNDS;
+}
+
+static void kstring_bench_op(const char *name, enum kstring_bench_op op, rt_size_t size)
+{
+    rt_size_t dst_offset, src_offset;
+    rt_uint32_t generic, optimized;
+
+    for (dst_offset = 0; dst_offset < 4; dst_offset++)
+    {
+        for (src_offset = 0; src_offset < 4; src_offset++)
+        {
+            /* memset and strlen have one buffer only */
+            if ((op == KSTRING_BENCH_MEMSET && src_offset != 0) || (op == KSTRING_BENCH_STRLEN && dst_offset != 0))
+            {
+                continue;
+            }
+
+            generic = kstring_bench_run(op, RT_TRUE, size, dst_offset, src_offset);
+            optimized = kstring_bench_run(op, RT_FALSE, size, dst_offset, src_offset);
+            rt_kprintf("%-6s %5d   %d   %d %8d %10d  %3d.%02dx\n", name, (int)size, (int)dst_offset, (int)src_offset,
+                       generic, optimized, generic / optimized, generic * 100 / optimized % 100);
+        }
+    }
+}
+
+static void kstring_bench(int argc, char **argv)
+{
+    static const rt_size_t sizes[] = {8, 64, 256, KSTRING_BENCH_MAX};
+    rt_size_t i;
+
+    if (argc > 1)
+    {
+        rt_kprintf("Usage: kstring_bench\n");
+        return;
+    }
+
+    rt_kprintf("cputime counts per call of the generic and the optimized routines\n");
+    rt_kprintf("op      size dst src  generic  optimized  speedup\n");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        kstring_bench_op("memcpy", KSTRING_BENCH_MEMCPY, sizes[i]);
+        kstring_bench_op("memset", KSTRING_BENCH_MEMSET, sizes[i]);
+        kstring_bench_op("memcmp", KSTRING_BENCH_MEMCMP, sizes[i]);
+#ifndef RT_KSERVICE_USING_STDLIB
+        kstring_bench_op("strlen", KSTRING_BENCH_STRLEN, sizes[i]);
+#endif
+    }
+}
+MSH_CMD_EXPORT(kstring_bench, compare the optimized rt_memcpy/memset/memcmp/strlen with the generic ones);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_CPUTIME && RT_KSERVICE_USING_ARCH_OPTIMIZED */
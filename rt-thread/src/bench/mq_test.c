@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_MESSAGEQUEUE)
+#include <finsh.h>
+#include "bench.h"
+
+#define MQ_ZC_TEST_MSGS     2
+#define MQ_ZC_TEST_SIZE     16
+
+static void _mq_zc_test_producer(void *parameter)
+{
+    rt_mq_t mq = (rt_mq_t)parameter;
+    void *buffer;
+
+    if (rt_mq_reserve(mq, &buffer, RT_WAITING_FOREVER) == RT_EOK)
+    {
+        rt_memset(buffer, 0x5a, MQ_ZC_TEST_SIZE);
+        rt_mq_commit(mq, buffer, MQ_ZC_TEST_SIZE);
+    }
+}
+
+/*
+ * Runs a reserve/commit/borrow/release cycle on a queue of two slots and
+ * checks that every slot goes back to the free list.
+ */
+static int mq_zc_test(void)
+{
+    static rt_uint8_t pool[MQ_ZC_TEST_MSGS * (RT_ALIGN(MQ_ZC_TEST_SIZE, RT_ALIGN_SIZE) + sizeof(struct rt_mq_message))];
+    struct rt_messagequeue mq;
+    void *slot[MQ_ZC_TEST_MSGS], *buffer;
+    rt_uint8_t data[MQ_ZC_TEST_SIZE];
+    rt_thread_t producer;
+    rt_ssize_t length;
+    int round;
+    rt_bool_t failed = RT_FALSE;
+
+    rt_mq_init(&mq, "mqzc", pool, MQ_ZC_TEST_SIZE, sizeof(pool), RT_IPC_FLAG_PRIO);
+
+    for (round = 0; round < 2 && !failed; round++)
+    {
+        /* every slot can be reserved, then the queue is full */
+        if (rt_mq_reserve(&mq, &slot[0], 0) != RT_EOK ||
+            rt_mq_reserve(&mq, &slot[1], 0) != RT_EOK ||
+            rt_mq_reserve(&mq, &buffer, 0) != -RT_EFULL)
+        {
+            rt_kprintf("mq_zc_test: reserve failed in round %d\n", round);
+            failed = RT_TRUE;
+            break;
+        }
+
+        /* a rejected commit leaves the slot with the caller */
+        if (rt_mq_commit(&mq, slot[0], MQ_ZC_TEST_SIZE + 1) != -RT_ERROR || mq.entry != 0)
+        {
+            rt_kprintf("mq_zc_test: oversized commit was not rejected\n");
+            failed = RT_TRUE;
+            break;
+        }
+
+        /* commit one slot, discard the other one */
+        rt_memset(slot[0], round, MQ_ZC_TEST_SIZE);
+        rt_mq_commit(&mq, slot[0], MQ_ZC_TEST_SIZE);
+        rt_mq_release(&mq, slot[1]);
+
+        /* the message is lent in place */
+        length = rt_mq_borrow(&mq, &buffer, 0);
+        if (length != MQ_ZC_TEST_SIZE || buffer != slot[0] || ((rt_uint8_t *)buffer)[0] != round)
+        {
+            rt_kprintf("mq_zc_test: borrow got %d bytes at %p, not the committed slot\n", (int)length, buffer);
+            failed = RT_TRUE;
+            break;
+        }
+        if (rt_mq_borrow(&mq, &buffer, 0) != -RT_ETIMEOUT)
+        {
+            rt_kprintf("mq_zc_test: borrow from an empty queue did not time out\n");
+            failed = RT_TRUE;
+            break;
+        }
+        rt_mq_release(&mq, slot[0]);
+    }
+
+    /* a blocked reserve gets a slot once a borrowed one is released */
+    if (!failed)
+    {
+        rt_memset(data, 0, sizeof(data));
+        rt_mq_send(&mq, data, sizeof(data));
+        rt_mq_send(&mq, data, sizeof(data));
+        producer = rt_thread_create("mqzc", _mq_zc_test_producer, &mq, 512,
+                                    RT_SCHED_PRIV(rt_thread_self()).current_priority, 10);
+        if (producer != RT_NULL)
+        {
+            rt_thread_startup(producer);
+            rt_thread_mdelay(10);
+            length = rt_mq_borrow(&mq, &buffer, 0);
+            rt_mq_release(&mq, buffer);
+            rt_thread_mdelay(10);
+            rt_mq_recv(&mq, data, sizeof(data), 0);
+            if (length != sizeof(data) || rt_mq_recv(&mq, data, sizeof(data), 0) != MQ_ZC_TEST_SIZE ||
+                data[0] != 0x5a)
+            {
+                rt_kprintf("mq_zc_test: blocked reserve did not get the released slot\n");
+                failed = RT_TRUE;
+            }
+        }
+    }
+
+    rt_mq_detach(&mq);
+
+    return bench_result("mq_zc_test", failed);
+}
+MSH_CMD_EXPORT(mq_zc_test, run a zero-copy reserve/commit/borrow/release cycle on a message queue);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_MESSAGEQUEUE */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_CPUTIME) && defined(RT_USING_SEMAPHORE) && defined(RT_USING_HEAP)
+#include <finsh.h>
+#include "bench.h"
+
+#define OBJECT_BENCH_COUNT  200
+
+/*
+ * Registers a few hundred semaphores, checks that every name is found and
+ * that a detached one is gone, and prints the average cputime counts of a
+ * lookup, with or without RT_USING_OBJECT_HASH.
+ */
+static int object_bench(int argc, char **argv)
+{
+    struct rt_semaphore *sems;
+    char name[RT_NAME_MAX];
+    rt_uint32_t start, elapsed;
+    int count, index;
+    rt_bool_t failed = RT_FALSE;
+
+    count = bench_get_count(argc, argv, OBJECT_BENCH_COUNT, 1, 1000);
+    if (count < 0)
+        return -RT_EINVAL;
+
+    sems = (struct rt_semaphore *)rt_malloc(count * sizeof(struct rt_semaphore));
+    if (sems == RT_NULL)
+    {
+        rt_kprintf("object_bench: no memory for %d semaphores\n", count);
+        return -RT_ENOMEM;
+    }
+
+    for (index = 0; index < count; index++)
+    {
+        rt_snprintf(name, sizeof(name), "ob%d", index);
+        rt_sem_init(&sems[index], name, 0, RT_IPC_FLAG_PRIO);
+    }
+
+    start = bench_now();
+    for (index = 0; index < count; index++)
+    {
+        if (rt_object_find(sems[index].parent.parent.name, RT_Object_Class_Semaphore) !=
+            &sems[index].parent.parent)
+            failed = RT_TRUE;
+    }
+    elapsed = bench_now() - start;
+
+    /* a detached object can not be found any more */
+    rt_snprintf(name, sizeof(name), "ob%d", count / 2);
+    rt_sem_detach(&sems[count / 2]);
+    if (rt_object_find(name, RT_Object_Class_Semaphore) != RT_NULL)
+        failed = RT_TRUE;
+
+    for (index = 0; index < count; index++)
+    {
+        if (index != count / 2)
+            rt_sem_detach(&sems[index]);
+    }
+    rt_free(sems);
+
+#ifdef RT_USING_OBJECT_HASH
+    rt_kprintf("%d objects, %d buckets, lookup: %d cputime counts\n", count, RT_OBJECT_HASH_SIZE, elapsed / count);
+#else
+    rt_kprintf("%d objects, no hash, lookup: %d cputime counts\n", count, elapsed / count);
+#endif
+
+    return bench_result("object_bench", failed);
+}
+MSH_CMD_EXPORT(object_bench, measure rt_object_find with a few hundred objects: object_bench [count]);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_CPUTIME && RT_USING_SEMAPHORE && RT_USING_HEAP */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_CPUTIME) && defined(RT_USING_HEAP)
+#include <finsh.h>
+#include "bench.h"
+
+#define TIMER_BENCH_COUNT   200
+#define TIMER_BENCH_EXPIRE  10      /* ticks until the expire round fires */
+
+static volatile int _timer_bench_fired;
+static volatile rt_uint32_t _timer_bench_first, _timer_bench_last;
+
+static void _timer_bench_timeout(void *parameter)
+{
+    rt_uint32_t now = bench_now();
+
+    if (_timer_bench_fired++ == 0)
+        _timer_bench_first = now;
+    _timer_bench_last = now;
+}
+
+/* a one shot timer which restarts itself from its callback until the count is reached */
+static void _timer_bench_restart(void *parameter)
+{
+    if (++_timer_bench_fired < 3)
+        rt_timer_start((rt_timer_t)parameter);
+}
+
+/*
+ * Starts and stops a few hundred hard timers with spread timeouts, then lets
+ * them all expire on the same tick, and prints the average cputime counts of
+ * a start, a stop and an expiry. RT_USING_TIMER_WHEEL selects the backend.
+ */
+static int timer_bench(int argc, char **argv)
+{
+    struct rt_timer *timers;
+    struct rt_timer restart;
+    rt_uint32_t start, start_cost, stop_cost, expire_cost = 0;
+    rt_tick_t timeout;
+    rt_base_t level;
+    int count, index;
+    rt_bool_t failed = RT_FALSE;
+
+    count = bench_get_count(argc, argv, TIMER_BENCH_COUNT, 2, 1000);
+    if (count < 0)
+        return -RT_EINVAL;
+
+    timers = (struct rt_timer *)rt_malloc(count * sizeof(struct rt_timer));
+    if (timers == RT_NULL)
+    {
+        rt_kprintf("timer_bench: no memory for %d timers\n", count);
+        return -RT_ENOMEM;
+    }
+
+    for (index = 0; index < count; index++)
+    {
+        /* spread the timeouts over a few seconds, out of order */
+        rt_timer_init(&timers[index], "tmb", _timer_bench_timeout, RT_NULL,
+                      RT_TICK_PER_SECOND + (index * 37) % (3 * RT_TICK_PER_SECOND), RT_TIMER_FLAG_ONE_SHOT);
+    }
+
+    start = bench_now();
+    for (index = 0; index < count; index++)
+        rt_timer_start(&timers[index]);
+    start_cost = (bench_now() - start) / count;
+
+    start = bench_now();
+    for (index = 0; index < count; index++)
+        rt_timer_stop(&timers[index]);
+    stop_cost = (bench_now() - start) / count;
+
+    /* all of them expire in the same tick check, the callbacks only take a timestamp */
+    _timer_bench_fired = 0;
+    timeout = TIMER_BENCH_EXPIRE;
+    for (index = 0; index < count; index++)
+    {
+        rt_timer_control(&timers[index], RT_TIMER_CTRL_SET_TIME, &timeout);
+    }
+    level = rt_hw_interrupt_disable();
+    for (index = 0; index < count; index++)
+        rt_timer_start(&timers[index]);
+    rt_hw_interrupt_enable(level);
+    rt_thread_delay(2 * TIMER_BENCH_EXPIRE);
+    if (_timer_bench_fired != count)
+        failed = RT_TRUE;
+    else
+        expire_cost = (_timer_bench_last - _timer_bench_first) / (count - 1);
+
+    for (index = 0; index < count; index++)
+        rt_timer_detach(&timers[index]);
+    rt_free(timers);
+
+    /* a timer restarted from its own callback keeps running */
+    _timer_bench_fired = 0;
+    rt_timer_init(&restart, "tmb", _timer_bench_restart, &restart, 1, RT_TIMER_FLAG_ONE_SHOT);
+    rt_timer_start(&restart);
+    rt_thread_delay(10);
+    if (_timer_bench_fired != 3)
+        failed = RT_TRUE;
+    rt_timer_detach(&restart);
+
+#ifdef RT_USING_TIMER_WHEEL
+    rt_kprintf("%d timers, timing wheel, cputime counts per timer\n", count);
+#else
+    rt_kprintf("%d timers, sorted list, cputime counts per timer\n", count);
+#endif
+    rt_kprintf("start  : %d\n", start_cost);
+    rt_kprintf("stop   : %d\n", stop_cost);
+    rt_kprintf("expire : %d\n", expire_cost);
+
+    return bench_result("timer_bench", failed);
+}
+MSH_CMD_EXPORT(timer_bench, measure timer start stop and expire: timer_bench [count]);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_CPUTIME && RT_USING_HEAP */
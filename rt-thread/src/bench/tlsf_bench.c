@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_CPUTIME) && defined(RT_USING_TLSF_MEM) && defined(RT_USING_HEAP)
+#include <finsh.h>
+#include "bench.h"
+
+#define TLSF_BENCH_ROUNDS   2000
+#define TLSF_BENCH_SLOTS    32
+#define TLSF_BENCH_POOL     (16 * 1024)
+#define TLSF_BENCH_SIZE_MAX 512
+
+struct _tlsf_bench_result
+{
+    rt_uint32_t alloc_total, alloc_max, alloc_count;
+    rt_uint32_t free_total, free_max, free_count;
+    rt_uint32_t no_memory;
+};
+
+/*
+ * Run the same pseudo random sequence of alloc and free calls with block
+ * sizes up to TLSF_BENCH_SIZE_MAX on heap m, or on the system heap when m
+ * is RT_NULL. Every block is filled with a pattern that is checked before
+ * it is released. Returns the number of corrupted blocks.
+ */
+static int _tlsf_bench_run(rt_tlsf_t m, int rounds, struct _tlsf_bench_result *result)
+{
+    rt_uint8_t *blocks[TLSF_BENCH_SLOTS] = {RT_NULL};
+    rt_uint16_t sizes[TLSF_BENCH_SLOTS];
+    rt_uint32_t seed = 0x12345678, start, cost;
+    int round, slot, index, corrupted = 0;
+
+    rt_memset(result, 0, sizeof(*result));
+    for (round = 0; round < rounds + TLSF_BENCH_SLOTS; round++)
+    {
+        /* release everything left in the last TLSF_BENCH_SLOTS rounds */
+        if (round < rounds)
+        {
+            seed = seed * 1103515245 + 12345;
+            slot = (seed >> 16) % TLSF_BENCH_SLOTS;
+        }
+        else
+        {
+            slot = round - rounds;
+        }
+
+        if (blocks[slot] == RT_NULL)
+        {
+            if (round >= rounds)
+                continue;
+
+            sizes[slot] = 1 + (seed >> 8) % TLSF_BENCH_SIZE_MAX;
+            start = bench_now();
+            blocks[slot] = m ? rt_tlsf_alloc(m, sizes[slot]) : rt_malloc(sizes[slot]);
+            cost = bench_now() - start;
+            if (blocks[slot] == RT_NULL)
+            {
+                result->no_memory++;
+                continue;
+            }
+
+            result->alloc_total += cost;
+            result->alloc_count++;
+            if (result->alloc_max < cost)
+                result->alloc_max = cost;
+            rt_memset(blocks[slot], slot ^ sizes[slot], sizes[slot]);
+        }
+        else
+        {
+            for (index = 0; index < sizes[slot]; index++)
+            {
+                if (blocks[slot][index] != (rt_uint8_t)(slot ^ sizes[slot]))
+                {
+                    corrupted++;
+                    break;
+                }
+            }
+
+            start = bench_now();
+            if (m)
+                rt_tlsf_free(m, blocks[slot]);
+            else
+                rt_free(blocks[slot]);
+            cost = bench_now() - start;
+            blocks[slot] = RT_NULL;
+
+            result->free_total += cost;
+            result->free_count++;
+            if (result->free_max < cost)
+                result->free_max = cost;
+        }
+    }
+
+    return corrupted;
+}
+
+static void _tlsf_bench_print(const char *name, struct _tlsf_bench_result *result)
+{
+    rt_kprintf("%s: alloc avg %d max %d, free avg %d max %d, %d out of memory\n", name,
+               result->alloc_count ? result->alloc_total / result->alloc_count : 0, result->alloc_max,
+               result->free_count ? result->free_total / result->free_count : 0, result->free_max,
+               result->no_memory);
+}
+
+/*
+ * Run a random alloc/free stress on a private TLSF heap and the same sequence
+ * on the system heap for comparison. The system heap numbers include its lock.
+ */
+static int tlsf_bench(int argc, char **argv)
+{
+    struct _tlsf_bench_result result;
+    rt_tlsf_t heap;
+    void *pool;
+    int rounds;
+    rt_bool_t failed = RT_FALSE;
+
+    rounds = bench_get_count(argc, argv, TLSF_BENCH_ROUNDS, 1, 100000);
+    if (rounds < 0)
+        return -RT_EINVAL;
+
+    pool = rt_malloc(TLSF_BENCH_POOL);
+    if (pool == RT_NULL)
+    {
+        rt_kprintf("tlsf_bench: no memory for a %d bytes pool\n", TLSF_BENCH_POOL);
+        return -RT_ENOMEM;
+    }
+    heap = rt_tlsf_init("tlsfb", pool, TLSF_BENCH_POOL);
+    if (heap == RT_NULL)
+    {
+        rt_free(pool);
+        return -RT_ERROR;
+    }
+
+    rt_kprintf("%d rounds, 1 to %d bytes, cputime counts per call\n", rounds, TLSF_BENCH_SIZE_MAX);
+
+    if (_tlsf_bench_run(heap, rounds, &result) != 0)
+        failed = RT_TRUE;
+    /* everything is released, the heap must be empty again */
+    if (heap->used != 0)
+        failed = RT_TRUE;
+    _tlsf_bench_print("tlsf", &result);
+
+    if (_tlsf_bench_run(RT_NULL, rounds, &result) != 0)
+        failed = RT_TRUE;
+    _tlsf_bench_print("heap", &result);
+
+    rt_tlsf_detach(heap);
+    rt_free(pool);
+
+    return bench_result("tlsf_bench", failed);
+}
+MSH_CMD_EXPORT(tlsf_bench, TLSF alloc and free stress and timing: tlsf_bench [count]);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_CPUTIME && RT_USING_TLSF_MEM && RT_USING_HEAP */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined(RT_DEBUGING_BENCH) && defined(RT_USING_CPU_USAGE)
+#include <finsh.h>
+#include "bench.h"
+
+#define USAGE_BENCH_COUNT   1000
+
+/*
+ * Measure rt_sched_usage_switch(), the accounting added to every context
+ * switch. The switches are accounted on a dummy thread with interrupts
+ * disabled, and the time of the dummy is given back to the calling thread
+ * afterwards, which is the one that really ran.
+ */
+static int usage_bench(int argc, char **argv)
+{
+    struct rt_thread dummy, *self = rt_thread_self();
+    rt_uint32_t start, read_cost, elapsed;
+    rt_uint64_t duration;
+    rt_base_t level;
+    int count, index;
+    rt_bool_t failed = RT_FALSE;
+
+    count = bench_get_count(argc, argv, USAGE_BENCH_COUNT, 1, 100000);
+    if (count < 0)
+        return -RT_EINVAL;
+
+    rt_memset(&dummy, 0, sizeof(dummy));
+
+    level = rt_hw_local_irq_disable();
+
+    /* the cost of reading the counter, which bounds the accounting from below */
+    start = bench_now();
+    for (index = 0; index < count; index++)
+    {
+        (void)bench_now();
+    }
+    read_cost = (bench_now() - start) / count;
+
+    /* the first switch closes the slice of this thread */
+    start = bench_now();
+    rt_sched_usage_switch(self, &dummy);
+    for (index = 0; index < count; index++)
+    {
+        rt_sched_usage_switch(&dummy, &dummy);
+    }
+    elapsed = bench_now() - start;
+    duration = dummy.duration_tick;
+
+    rt_sched_usage_switch(&dummy, self);
+    self->duration_tick += dummy.duration_tick;
+
+    rt_hw_local_irq_enable(level);
+
+    /* the dummy thread got the time between the switches, and nothing else */
+    if (duration == 0 || duration > elapsed ||
+        dummy.max_slice_tick == 0 || dummy.max_slice_tick > duration)
+        failed = RT_TRUE;
+
+    rt_kprintf("%d switches, cputime counts per call\n", count);
+    rt_kprintf("counter read      : %d\n", read_cost);
+    rt_kprintf("switch accounting : %d\n", elapsed / (count + 1));
+
+    return bench_result("usage_bench", failed);
+}
+MSH_CMD_EXPORT(usage_bench, measure the cpu usage accounting per switch: usage_bench [count]);
+
+#endif /* RT_DEBUGING_BENCH && RT_USING_CPU_USAGE */
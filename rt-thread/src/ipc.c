@@ -56,6 +56,7 @@
 #include <rtdbg.h>
 
 #define GET_MESSAGEBYTE_ADDR(msg)               ((struct rt_mq_message *) msg + 1)
+#define GET_MESSAGE_FROM_BYTE_ADDR(buf)         ((struct rt_mq_message *) (buf) - 1)
 #if defined(RT_USING_HOOK) && defined(RT_HOOK_USING_FUNC_PTR)
 extern void (*rt_object_trytake_hook)(struct rt_object *object);
 extern void (*rt_object_take_hook)(struct rt_object *object);
@@ -335,6 +336,40 @@ static void _sem_object_init(rt_sem_t       sem,
     rt_spin_lock_init(&(sem->spinlock));
 }
 
+#ifdef RT_USING_IPC_FASTPATH
+/*
+ * The value of semaphore is changed with compare-and-swap out of the lock,
+ * while the locked path may change it directly: on a single CPU nothing else
+ * runs while the lock is held, and an interrupted compare-and-swap fails and
+ * retries.
+ */
+rt_inline rt_bool_t _sem_value_take(rt_sem_t sem)
+{
+    rt_atomic_t value = rt_atomic_load(&(sem->value));
+
+    while (value > 0)
+    {
+        if (rt_atomic_compare_exchange_strong(&(sem->value), &value, value - 1))
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+rt_inline rt_bool_t _sem_value_give(rt_sem_t sem)
+{
+    rt_atomic_t value = rt_atomic_load(&(sem->value));
+
+    while (value < sem->max_value)
+    {
+        if (rt_atomic_compare_exchange_strong(&(sem->value), &value, value + 1))
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+#endif /* RT_USING_IPC_FASTPATH */
+
 /**
  * @brief    This function will initialize a static semaphore object.
  *
@@ -570,6 +605,16 @@ static rt_err_t _rt_sem_take(rt_sem_t sem, rt_int32_t timeout, int suspend_flag)
     /* current context checking */
     RT_DEBUG_SCHEDULER_AVAILABLE(1);
 
+#ifdef RT_USING_IPC_FASTPATH
+    /* semaphore is available, take it without lock */
+    if (_sem_value_take(sem))
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(sem->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif /* RT_USING_IPC_FASTPATH */
+
     level = rt_spin_lock_irqsave(&(sem->spinlock));
 
     LOG_D("thread %s take sem:%s, which value is: %d",
@@ -705,6 +750,34 @@ rt_err_t rt_sem_release(rt_sem_t sem)
 
     need_schedule = RT_FALSE;
 
+#ifdef RT_USING_IPC_FASTPATH
+    if (rt_list_isempty(&sem->parent.suspend_thread))
+    {
+        /* nobody is waiting, increase value without lock */
+        if (!_sem_value_give(sem))
+            return -RT_EFULL; /* value overflowed */
+
+        if (rt_list_isempty(&sem->parent.suspend_thread))
+            return RT_EOK;
+
+        /* a thread was suspended meanwhile, hand the value over to it */
+        level = rt_spin_lock_irqsave(&(sem->spinlock));
+        if (!rt_list_isempty(&sem->parent.suspend_thread) && _sem_value_take(sem))
+        {
+            if (rt_susp_list_dequeue(&(sem->parent.suspend_thread), RT_EOK) != RT_NULL)
+                need_schedule = RT_TRUE;
+            else
+                _sem_value_give(sem); /* the thread is being resumed by timeout */
+        }
+        rt_spin_unlock_irqrestore(&(sem->spinlock), level);
+
+        if (need_schedule == RT_TRUE)
+            rt_schedule();
+
+        return RT_EOK;
+    }
+#endif /* RT_USING_IPC_FASTPATH */
+
     level = rt_spin_lock_irqsave(&(sem->spinlock));
 
     LOG_D("thread %s releases sem:%s, which value is: %d",
@@ -973,6 +1046,62 @@ static void _mutex_before_delete_detach(rt_mutex_t mutex)
     rt_spin_unlock(&(mutex->spinlock));
 }
 
+#ifdef RT_USING_IPC_FASTPATH
+/*
+ * An uncontended mutex is taken and given up under a short interrupt mask
+ * instead of the object lock. The owner is published together with the hold
+ * count, the original priority and the taken list link, so a contender that
+ * sees the owner always runs the priority inheritance on complete bookkeeping.
+ */
+rt_inline rt_bool_t _mutex_fast_take(rt_mutex_t mutex, struct rt_thread *thread)
+{
+    rt_bool_t taken = RT_FALSE;
+    rt_base_t level;
+
+    /* the priority ceiling is applied by the locked path */
+    if (mutex->ceiling_priority != 0xFF || mutex->owner != RT_NULL)
+        return RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    if (mutex->owner == RT_NULL)
+    {
+        mutex->priority = 0xFF;
+        mutex->hold = 1;
+        rt_list_insert_after(&thread->taken_object_list, &mutex->taken_list);
+        rt_atomic_store((volatile rt_atomic_t *)&(mutex->owner), (rt_atomic_t)thread);
+        taken = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return taken;
+}
+
+rt_inline rt_bool_t _mutex_fast_release(rt_mutex_t mutex, struct rt_thread *thread)
+{
+    rt_bool_t released = RT_FALSE;
+    rt_base_t level;
+
+    if (mutex->owner != thread || mutex->hold != 1 || mutex->ceiling_priority != 0xFF)
+        return RT_FALSE;
+
+    /*
+     * a waiter may arrive at any time, so checking that nobody is waiting
+     * and giving the mutex up have to be done at once.
+     */
+    level = rt_hw_interrupt_disable();
+    if (rt_list_isempty(&mutex->parent.suspend_thread) && mutex->priority == 0xFF)
+    {
+        rt_list_remove(&mutex->taken_list);
+        mutex->hold = 0;
+        rt_atomic_store((volatile rt_atomic_t *)&(mutex->owner), (rt_atomic_t)RT_NULL);
+        released = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return released;
+}
+#endif /* RT_USING_IPC_FASTPATH */
+
 /**
  * @addtogroup mutex
  * @{
@@ -1337,6 +1466,20 @@ static rt_err_t _rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout, int suspend
     /* get current thread */
     thread = rt_thread_self();
 
+#ifdef RT_USING_IPC_FASTPATH
+    /* mutex is free, take it without lock */
+    if (_mutex_fast_take(mutex, thread))
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
+
+        thread->error = RT_EOK;
+
+        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mutex->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif /* RT_USING_IPC_FASTPATH */
+
     rt_spin_lock(&(mutex->spinlock));
 
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
@@ -1596,6 +1739,16 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
     /* get current thread */
     thread = rt_thread_self();
 
+#ifdef RT_USING_IPC_FASTPATH
+    /* nobody is waiting, release it without lock */
+    if (_mutex_fast_release(mutex, thread))
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mutex->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif /* RT_USING_IPC_FASTPATH */
+
     rt_spin_lock(&(mutex->spinlock));
 
     LOG_D("mutex_release:current thread %s, hold: %d",
@@ -3332,43 +3485,12 @@ rt_err_t rt_mq_delete(rt_mq_t mq)
 RTM_EXPORT(rt_mq_delete);
 #endif /* RT_USING_HEAP */
 
-/**
- * @brief    This function will send a message to the messagequeue object. If
- *           there is a thread suspended on the messagequeue, the thread will be
- *           resumed.
- *
- * @note     When using this function to send a message, if the messagequeue is
- *           fully used, the current thread will wait for a timeout. If reaching
- *           the timeout and there is still no space available, the sending
- *           thread will be resumed and an error code will be returned. By
- *           contrast, the _rt_mq_send_wait() function will return an error code
- *           immediately without waiting when the messagequeue if fully used.
- *
- * @see      _rt_mq_send_wait()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
- *
- * @param    size is the length of the message(Unit: Byte).
- *
- * @param    prio is message priority, A larger value indicates a higher priority
- *
- * @param    timeout is a timeout period (unit: an OS tick).
- *
- * @param    suspend_flag status flag of the thread to be suspended.
- *
- * @return   Return the operation status. When the return value is RT_EOK, the
- *           operation is successful. If the return value is any other values,
- *           it means that the messagequeue detach failed.
- *
- * @warning  This function can be called in interrupt context and thread
- * context.
+/*
+ * take a free message from the messagequeue, wait for one if the
+ * messagequeue is full.
  */
-static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
-                                 const void *buffer,
-                                 rt_size_t size,
-                                 rt_int32_t prio,
+static rt_err_t _rt_mq_alloc_msg(rt_mq_t mq,
+                                 struct rt_mq_message **msg_ptr,
                                  rt_int32_t timeout,
                                  int suspend_flag)
 {
@@ -3378,28 +3500,11 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
     struct rt_thread *thread;
     rt_err_t ret;
 
-    RT_UNUSED(prio);
-
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
-
-    /* current context checking */
-    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
-
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return -RT_ERROR;
-
     /* initialize delta tick */
     tick_delta = 0;
     /* get current thread */
     thread = rt_thread_self();
 
-    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
-
     level = rt_spin_lock_irqsave(&(mq->spinlock));
 
     /* get a free list, there must be an empty item */
@@ -3482,13 +3587,36 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
     /* the msg is the new tailer of list, the next shall be NULL */
     msg->next = RT_NULL;
 
+    *msg_ptr = msg;
+
+    return RT_EOK;
+}
+
+/*
+ * link a filled message to the messagequeue and resume the receiver.
+ */
+static rt_err_t _rt_mq_put_msg(rt_mq_t mq,
+                               struct rt_mq_message *msg,
+                               rt_size_t size,
+                               rt_int32_t prio)
+{
+    rt_base_t level;
+
+    RT_UNUSED(prio);
+
     /* add the length */
     ((struct rt_mq_message *)msg)->length = size;
-    /* copy buffer */
-    rt_memcpy(GET_MESSAGEBYTE_ADDR(msg), buffer, size);
 
     /* disable interrupt */
     level = rt_spin_lock_irqsave(&(mq->spinlock));
+
+    /* check the entry before linking, so that the caller keeps msg on error */
+    if (mq->entry >= RT_MQ_ENTRY_MAX)
+    {
+        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+        return -RT_EFULL; /* value overflowed */
+    }
+
 #ifdef RT_USING_MESSAGEQUEUE_PRIORITY
     msg->prio = prio;
     if (mq->msg_queue_head == RT_NULL)
@@ -3530,16 +3658,8 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
         mq->msg_queue_head = msg;
 #endif
 
-    if(mq->entry < RT_MQ_ENTRY_MAX)
-    {
-        /* increase message entry */
-        mq->entry ++;
-    }
-    else
-    {
-        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-        return -RT_EFULL; /* value overflowed */
-    }
+    /* increase message entry */
+    mq->entry ++;
 
     /* resume suspended thread */
     if (!rt_list_isempty(&mq->parent.suspend_thread))
@@ -3557,103 +3677,331 @@ static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
     return RT_EOK;
 }
 
-rt_err_t rt_mq_send_wait(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
-{
-    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_UNINTERRUPTIBLE);
-}
-RTM_EXPORT(rt_mq_send_wait);
-
-rt_err_t rt_mq_send_wait_interruptible(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
-{
-    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_INTERRUPTIBLE);
-}
-RTM_EXPORT(rt_mq_send_wait_interruptible);
-
-rt_err_t rt_mq_send_wait_killable(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
-{
-    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_KILLABLE);
-}
-RTM_EXPORT(rt_mq_send_wait_killable);
-/**
- * @brief    This function will send a message to the messagequeue object.
- *           If there is a thread suspended on the messagequeue, the thread will be resumed.
- *
- * @note     When using this function to send a message, if the messagequeue is fully used,
- *           the current thread will wait for a timeout.
- *           By contrast, when the messagequeue is fully used, the rt_mq_send_wait() function will
- *           return an error code immediately without waiting.
- *
- * @see      rt_mq_send_wait()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
- *
- * @param    size is the length of the message(Unit: Byte).
- *
- * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
- *           If the return value is any other values, it means that the messagequeue detach failed.
- *
- * @warning  This function can be called in interrupt context and thread context.
- */
-rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
-{
-    return rt_mq_send_wait(mq, buffer, size, 0);
-}
-RTM_EXPORT(rt_mq_send);
-
-rt_err_t rt_mq_send_interruptible(rt_mq_t mq, const void *buffer, rt_size_t size)
-{
-    return rt_mq_send_wait_interruptible(mq, buffer, size, 0);
-}
-RTM_EXPORT(rt_mq_send_interruptible);
-
-rt_err_t rt_mq_send_killable(rt_mq_t mq, const void *buffer, rt_size_t size)
-{
-    return rt_mq_send_wait_killable(mq, buffer, size, 0);
-}
-RTM_EXPORT(rt_mq_send_killable);
-/**
- * @brief    This function will send an urgent message to the messagequeue object.
- *
- * @note     This function is almost the same as the rt_mq_send() function. The only difference is that
- *           when sending an urgent message, the message is placed at the head of the messagequeue so that
- *           the recipient can receive the urgent message first.
- *
- * @see      rt_mq_send()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
- *
- * @param    size is the length of the message(Unit: Byte).
- *
- * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
- *           If the return value is any other values, it means that the mailbox detach failed.
+/*
+ * take the first message off the messagequeue, wait for one if the
+ * messagequeue is empty.
  */
-rt_err_t rt_mq_urgent(rt_mq_t mq, const void *buffer, rt_size_t size)
+static rt_err_t _rt_mq_get_msg(rt_mq_t mq,
+                               struct rt_mq_message **msg_ptr,
+                               rt_int32_t timeout,
+                               int suspend_flag)
 {
+    struct rt_thread *thread;
     rt_base_t level;
     struct rt_mq_message *msg;
+    rt_uint32_t tick_delta;
+    rt_err_t ret;
 
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
+    /* initialize delta tick */
+    tick_delta = 0;
+    /* get current thread */
+    thread = rt_thread_self();
 
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return -RT_ERROR;
+    level = rt_spin_lock_irqsave(&(mq->spinlock));
+
+    /* for non-blocking call */
+    if (mq->entry == 0 && timeout == 0)
+    {
+        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+
+        return -RT_ETIMEOUT;
+    }
+
+    /* message queue is empty */
+    while (mq->entry == 0)
+    {
+        /* reset error number in thread */
+        thread->error = -RT_EINTR;
+
+        /* no waiting, return timeout */
+        if (timeout == 0)
+        {
+            /* enable interrupt */
+            rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+
+            thread->error = -RT_ETIMEOUT;
+
+            return -RT_ETIMEOUT;
+        }
+
+        /* suspend current thread */
+        ret = rt_thread_suspend_to_list(thread, &(mq->parent.suspend_thread),
+                                        mq->parent.parent.flag, suspend_flag);
+        if (ret != RT_EOK)
+        {
+            rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+            return ret;
+        }
+
+        /* has waiting time, start thread timer */
+        if (timeout > 0)
+        {
+            /* get the start tick of timer */
+            tick_delta = rt_tick_get();
+
+            LOG_D("set thread:%s to timer list",
+                  thread->parent.name);
+
+            /* reset the timeout of thread timer and start it */
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &timeout);
+            rt_timer_start(&(thread->thread_timer));
+        }
+
+        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+
+        /* re-schedule */
+        rt_schedule();
+
+        /* recv message */
+        if (thread->error != RT_EOK)
+        {
+            /* return error */
+            return thread->error;
+        }
+
+        level = rt_spin_lock_irqsave(&(mq->spinlock));
+
+        /* if it's not waiting forever and then re-calculate timeout tick */
+        if (timeout > 0)
+        {
+            tick_delta = rt_tick_get() - tick_delta;
+            timeout -= tick_delta;
+            if (timeout < 0)
+                timeout = 0;
+        }
+    }
+
+    /* get message from queue */
+    msg = (struct rt_mq_message *)mq->msg_queue_head;
+
+    /* move message queue head */
+    mq->msg_queue_head = msg->next;
+    /* reach queue tail, set to NULL */
+    if (mq->msg_queue_tail == msg)
+        mq->msg_queue_tail = RT_NULL;
+
+    /* decrease message entry */
+    if(mq->entry > 0)
+    {
+        mq->entry --;
+    }
+
+    rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+
+    *msg_ptr = msg;
+
+    return RT_EOK;
+}
+
+/*
+ * put a message back to the free list and resume a sender. Return RT_TRUE if
+ * a sender is resumed and a schedule is required.
+ */
+static rt_bool_t _rt_mq_free_msg(rt_mq_t mq, struct rt_mq_message *msg)
+{
+    rt_base_t level;
+    rt_bool_t need_schedule = RT_FALSE;
+
+    level = rt_spin_lock_irqsave(&(mq->spinlock));
+    /* put message to free list */
+    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
+    mq->msg_queue_free = msg;
+
+    /* resume suspended thread */
+    if (!rt_list_isempty(&(mq->suspend_sender_thread)))
+    {
+        rt_susp_list_dequeue(&(mq->suspend_sender_thread), RT_EOK);
+        need_schedule = RT_TRUE;
+    }
+
+    rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+
+    return need_schedule;
+}
+
+/*
+ * check that a message lent by rt_mq_reserve() or rt_mq_borrow() is a slot of
+ * the message pool, which is inside the pool and on a message boundary.
+ */
+rt_inline rt_bool_t _rt_mq_is_pool_msg(rt_mq_t mq, struct rt_mq_message *msg)
+{
+    rt_size_t msg_size = RT_ALIGN(mq->msg_size, RT_ALIGN_SIZE) + sizeof(struct rt_mq_message);
+    rt_ubase_t offset = (rt_ubase_t)msg - (rt_ubase_t)mq->msg_pool;
+
+    return (void *)msg >= mq->msg_pool && offset < msg_size * mq->max_msgs && offset % msg_size == 0;
+}
+
+/**
+ * @brief    This function will send a message to the messagequeue object. If
+ *           there is a thread suspended on the messagequeue, the thread will be
+ *           resumed.
+ *
+ * @note     When using this function to send a message, if the messagequeue is
+ *           fully used, the current thread will wait for a timeout. If reaching
+ *           the timeout and there is still no space available, the sending
+ *           thread will be resumed and an error code will be returned. By
+ *           contrast, the _rt_mq_send_wait() function will return an error code
+ *           immediately without waiting when the messagequeue if fully used.
+ *
+ * @see      _rt_mq_send_wait()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @param    prio is message priority, A larger value indicates a higher priority
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @param    suspend_flag status flag of the thread to be suspended.
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the
+ *           operation is successful. If the return value is any other values,
+ *           it means that the messagequeue detach failed.
+ *
+ * @warning  This function can be called in interrupt context and thread
+ * context.
+ */
+static rt_err_t _rt_mq_send_wait(rt_mq_t mq,
+                                 const void *buffer,
+                                 rt_size_t size,
+                                 rt_int32_t prio,
+                                 rt_int32_t timeout,
+                                 int suspend_flag)
+{
+    struct rt_mq_message *msg;
+    rt_err_t ret;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    ret = _rt_mq_alloc_msg(mq, &msg, timeout, suspend_flag);
+    if (ret != RT_EOK)
+        return ret;
+
+    /* copy buffer */
+    rt_memcpy(GET_MESSAGEBYTE_ADDR(msg), buffer, size);
+
+    ret = _rt_mq_put_msg(mq, msg, size, prio);
+    if (ret != RT_EOK && _rt_mq_free_msg(mq, msg) == RT_TRUE)
+        rt_schedule();
+
+    return ret;
+}
+
+rt_err_t rt_mq_send_wait(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_UNINTERRUPTIBLE);
+}
+RTM_EXPORT(rt_mq_send_wait);
+
+rt_err_t rt_mq_send_wait_interruptible(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_INTERRUPTIBLE);
+}
+RTM_EXPORT(rt_mq_send_wait_interruptible);
+
+rt_err_t rt_mq_send_wait_killable(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    return _rt_mq_send_wait(mq, buffer, size, 0, timeout, RT_KILLABLE);
+}
+RTM_EXPORT(rt_mq_send_wait_killable);
+/**
+ * @brief    This function will send a message to the messagequeue object.
+ *           If there is a thread suspended on the messagequeue, the thread will be resumed.
+ *
+ * @note     When using this function to send a message, if the messagequeue is fully used,
+ *           the current thread will wait for a timeout.
+ *           By contrast, when the messagequeue is fully used, the rt_mq_send_wait() function will
+ *           return an error code immediately without waiting.
+ *
+ * @see      rt_mq_send_wait()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           If the return value is any other values, it means that the messagequeue detach failed.
+ *
+ * @warning  This function can be called in interrupt context and thread context.
+ */
+rt_err_t rt_mq_send(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send_wait(mq, buffer, size, 0);
+}
+RTM_EXPORT(rt_mq_send);
+
+rt_err_t rt_mq_send_interruptible(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send_wait_interruptible(mq, buffer, size, 0);
+}
+RTM_EXPORT(rt_mq_send_interruptible);
+
+rt_err_t rt_mq_send_killable(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    return rt_mq_send_wait_killable(mq, buffer, size, 0);
+}
+RTM_EXPORT(rt_mq_send_killable);
+/**
+ * @brief    This function will send an urgent message to the messagequeue object.
+ *
+ * @note     This function is almost the same as the rt_mq_send() function. The only difference is that
+ *           when sending an urgent message, the message is placed at the head of the messagequeue so that
+ *           the recipient can receive the urgent message first.
+ *
+ * @see      rt_mq_send()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           If the return value is any other values, it means that the mailbox detach failed.
+ */
+rt_err_t rt_mq_urgent(rt_mq_t mq, const void *buffer, rt_size_t size)
+{
+    rt_base_t level;
+    struct rt_mq_message *msg;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
 
     RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
 
@@ -3754,10 +4102,8 @@ static rt_ssize_t _rt_mq_recv(rt_mq_t mq,
                               rt_int32_t timeout,
                               int suspend_flag)
 {
-    struct rt_thread *thread;
-    rt_base_t level;
     struct rt_mq_message *msg;
-    rt_uint32_t tick_delta;
+    rt_bool_t need_schedule;
     rt_err_t ret;
     rt_size_t len;
 
@@ -3772,104 +4118,11 @@ static rt_ssize_t _rt_mq_recv(rt_mq_t mq,
     /* current context checking */
     RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
 
-    /* initialize delta tick */
-    tick_delta = 0;
-    /* get current thread */
-    thread = rt_thread_self();
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
 
-    level = rt_spin_lock_irqsave(&(mq->spinlock));
-
-    /* for non-blocking call */
-    if (mq->entry == 0 && timeout == 0)
-    {
-        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-
-        return -RT_ETIMEOUT;
-    }
-
-    /* message queue is empty */
-    while (mq->entry == 0)
-    {
-        /* reset error number in thread */
-        thread->error = -RT_EINTR;
-
-        /* no waiting, return timeout */
-        if (timeout == 0)
-        {
-            /* enable interrupt */
-            rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-
-            thread->error = -RT_ETIMEOUT;
-
-            return -RT_ETIMEOUT;
-        }
-
-        /* suspend current thread */
-        ret = rt_thread_suspend_to_list(thread, &(mq->parent.suspend_thread),
-                                        mq->parent.parent.flag, suspend_flag);
-        if (ret != RT_EOK)
-        {
-            rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-            return ret;
-        }
-
-        /* has waiting time, start thread timer */
-        if (timeout > 0)
-        {
-            /* get the start tick of timer */
-            tick_delta = rt_tick_get();
-
-            LOG_D("set thread:%s to timer list",
-                  thread->parent.name);
-
-            /* reset the timeout of thread timer and start it */
-            rt_timer_control(&(thread->thread_timer),
-                             RT_TIMER_CTRL_SET_TIME,
-                             &timeout);
-            rt_timer_start(&(thread->thread_timer));
-        }
-
-        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-
-        /* re-schedule */
-        rt_schedule();
-
-        /* recv message */
-        if (thread->error != RT_EOK)
-        {
-            /* return error */
-            return thread->error;
-        }
-
-        level = rt_spin_lock_irqsave(&(mq->spinlock));
-
-        /* if it's not waiting forever and then re-calculate timeout tick */
-        if (timeout > 0)
-        {
-            tick_delta = rt_tick_get() - tick_delta;
-            timeout -= tick_delta;
-            if (timeout < 0)
-                timeout = 0;
-        }
-    }
-
-    /* get message from queue */
-    msg = (struct rt_mq_message *)mq->msg_queue_head;
-
-    /* move message queue head */
-    mq->msg_queue_head = msg->next;
-    /* reach queue tail, set to NULL */
-    if (mq->msg_queue_tail == msg)
-        mq->msg_queue_tail = RT_NULL;
-
-    /* decrease message entry */
-    if(mq->entry > 0)
-    {
-        mq->entry --;
-    }
-
-    rt_spin_unlock_irqrestore(&(mq->spinlock), level);
+    ret = _rt_mq_get_msg(mq, &msg, timeout, suspend_flag);
+    if (ret != RT_EOK)
+        return ret;
 
     /* get real message length */
     len = ((struct rt_mq_message *)msg)->length;
@@ -3883,29 +4136,13 @@ static rt_ssize_t _rt_mq_recv(rt_mq_t mq,
     if (prio != RT_NULL)
         *prio = msg->prio;
 #endif
-    level = rt_spin_lock_irqsave(&(mq->spinlock));
-    /* put message to free list */
-    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
-    mq->msg_queue_free = msg;
+    need_schedule = _rt_mq_free_msg(mq, msg);
 
-    /* resume suspended thread */
-    if (!rt_list_isempty(&(mq->suspend_sender_thread)))
-    {
-        rt_susp_list_dequeue(&(mq->suspend_sender_thread), RT_EOK);
-
-        rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-
-        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
 
+    if (need_schedule == RT_TRUE)
         rt_schedule();
 
-        return len;
-    }
-
-    rt_spin_unlock_irqrestore(&(mq->spinlock), level);
-
-    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
-
     return len;
 }
 
@@ -4020,6 +4257,167 @@ rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg)
 }
 RTM_EXPORT(rt_mq_control);
 
+/**
+ * @brief    This function will reserve a free message buffer of the messagequeue
+ *           for the caller to fill in place.
+ *
+ * @note     The buffer is owned by the caller until it is handed over by
+ *           rt_mq_commit() or given back by rt_mq_release(). It can hold up to
+ *           msg_size bytes. When the messagequeue is fully used, the current
+ *           thread will wait for a timeout just like rt_mq_send_wait().
+ *
+ * @see      rt_mq_commit()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is a pointer to receive the address of the reserved buffer.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           If the return value is -RT_EFULL, the messagequeue is fully used.
+ *
+ * @warning  This function can be called in interrupt context with a timeout of 0.
+ */
+rt_err_t rt_mq_reserve(rt_mq_t mq, void **buffer, rt_int32_t timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t ret;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
+
+    ret = _rt_mq_alloc_msg(mq, &msg, timeout, RT_UNINTERRUPTIBLE);
+    if (ret != RT_EOK)
+        return ret;
+
+    *buffer = GET_MESSAGEBYTE_ADDR(msg);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_reserve);
+
+/**
+ * @brief    This function will send a buffer reserved by rt_mq_reserve() to the
+ *           messagequeue without copying it. If there is a thread suspended on
+ *           the messagequeue, the thread will be resumed.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the buffer returned by rt_mq_reserve().
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           If the return value is any other values, the buffer is still owned by the caller.
+ *
+ * @warning  This function can be called in interrupt context and thread context.
+ */
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer, rt_size_t size)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+    /* the buffer shall be a slot of the message pool */
+    RT_ASSERT(_rt_mq_is_pool_msg(mq, GET_MESSAGE_FROM_BYTE_ADDR(buffer)));
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    return _rt_mq_put_msg(mq, GET_MESSAGE_FROM_BYTE_ADDR(buffer), size, 0);
+}
+RTM_EXPORT(rt_mq_commit);
+
+/**
+ * @brief    This function will take a message off the messagequeue and lend its
+ *           buffer to the caller instead of copying it out.
+ *
+ * @note     The buffer must be given back by rt_mq_release() once the caller
+ *           has finished with it. Until then, the slot is not available to
+ *           senders. When the messagequeue is empty, the current thread will
+ *           wait for a timeout just like rt_mq_recv().
+ *
+ * @see      rt_mq_release()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is a pointer to receive the address of the message content.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @return   Return the length of the message in bytes on success; otherwise a
+ *           negative error code is returned.
+ */
+rt_ssize_t rt_mq_borrow(rt_mq_t mq, void **buffer, rt_int32_t timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t ret;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
+
+    ret = _rt_mq_get_msg(mq, &msg, timeout, RT_UNINTERRUPTIBLE);
+    if (ret != RT_EOK)
+        return ret;
+
+    *buffer = GET_MESSAGEBYTE_ADDR(msg);
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+
+    return msg->length;
+}
+RTM_EXPORT(rt_mq_borrow);
+
+/**
+ * @brief    This function will give a buffer obtained by rt_mq_borrow() or
+ *           rt_mq_reserve() back to the messagequeue. If there is a thread
+ *           suspended on sending, the thread will be resumed.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the buffer to be given back.
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *
+ * @warning  This function can be called in interrupt context and thread context.
+ */
+rt_err_t rt_mq_release(rt_mq_t mq, void *buffer)
+{
+    struct rt_mq_message *msg;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    msg = GET_MESSAGE_FROM_BYTE_ADDR(buffer);
+    /* the buffer shall be a slot of the message pool */
+    RT_ASSERT(_rt_mq_is_pool_msg(mq, msg));
+
+    if (_rt_mq_free_msg(mq, msg) == RT_TRUE)
+        rt_schedule();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_release);
+
 /**@}*/
 #endif /* RT_USING_MESSAGEQUEUE */
 /**@}*/
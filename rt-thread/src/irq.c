@@ -42,6 +42,18 @@ void rt_interrupt_enter_sethook(void (*hook)(void))
     rt_interrupt_enter_hook = hook;
 }
 
+/**
+ * @ingroup Hook
+ *
+ * @brief This function will get the hook function set by rt_interrupt_enter_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_interrupt_enter_gethook(void))(void)
+{
+    return rt_interrupt_enter_hook;
+}
+
 /**
  * @ingroup Hook
  *
@@ -55,6 +67,18 @@ void rt_interrupt_leave_sethook(void (*hook)(void))
 {
     rt_interrupt_leave_hook = hook;
 }
+
+/**
+ * @ingroup Hook
+ *
+ * @brief This function will get the hook function set by rt_interrupt_leave_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_interrupt_leave_gethook(void))(void)
+{
+    return rt_interrupt_leave_hook;
+}
 #endif /* RT_USING_HOOK */
 
 /**
@@ -80,6 +104,9 @@ volatile rt_atomic_t rt_interrupt_nest = 0;
 rt_weak void rt_interrupt_enter(void)
 {
     rt_atomic_add(&(rt_interrupt_nest), 1);
+#ifdef RT_USING_CPU_USAGE
+    rt_sched_usage_irq_enter();
+#endif /* RT_USING_CPU_USAGE */
     RT_OBJECT_HOOK_CALL(rt_interrupt_enter_hook,());
     LOG_D("irq has come..., irq current nest:%d",
           (rt_int32_t)rt_atomic_load(&(rt_interrupt_nest)));
@@ -99,6 +126,9 @@ rt_weak void rt_interrupt_leave(void)
     LOG_D("irq is going to leave, irq current nest:%d",
                  (rt_int32_t)rt_atomic_load(&(rt_interrupt_nest)));
     RT_OBJECT_HOOK_CALL(rt_interrupt_leave_hook,());
+#ifdef RT_USING_CPU_USAGE
+    rt_sched_usage_irq_leave();
+#endif /* RT_USING_CPU_USAGE */
     rt_atomic_sub(&(rt_interrupt_nest), 1);
 
 }
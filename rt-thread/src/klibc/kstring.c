@@ -34,7 +34,12 @@
  *
  * @return The address of source memory.
  */
+#ifdef RT_KSERVICE_USING_ARCH_OPTIMIZED
+/* libcpu provides rt_memset, this one is kept for its benchmark */
+void *rt_memset_generic(void *s, int c, rt_ubase_t count)
+#else
 rt_weak void *rt_memset(void *s, int c, rt_ubase_t count)
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 {
 #ifdef RT_KSERVICE_USING_TINY_SIZE
     char *xs = (char *)s;
@@ -101,7 +106,9 @@ rt_weak void *rt_memset(void *s, int c, rt_ubase_t count)
 #undef TOO_SMALL
 #endif /* RT_KSERVICE_USING_TINY_SIZE */
 }
+#ifndef RT_KSERVICE_USING_ARCH_OPTIMIZED
 RTM_EXPORT(rt_memset);
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 
 /**
  * @brief  This function will copy memory content from source address to destination address.
@@ -114,7 +121,12 @@ RTM_EXPORT(rt_memset);
  *
  * @return The address of destination memory
  */
+#ifdef RT_KSERVICE_USING_ARCH_OPTIMIZED
+/* libcpu provides rt_memcpy, this one is kept for its benchmark */
+void *rt_memcpy_generic(void *dst, const void *src, rt_ubase_t count)
+#else
 rt_weak void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 {
 #ifdef RT_KSERVICE_USING_TINY_SIZE
     char *tmp = (char *)dst, *s = (char *)src;
@@ -185,7 +197,9 @@ rt_weak void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
 #undef TOO_SMALL
 #endif /* RT_KSERVICE_USING_TINY_SIZE */
 }
+#ifndef RT_KSERVICE_USING_ARCH_OPTIMIZED
 RTM_EXPORT(rt_memcpy);
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 
 /**
  * @brief  This function will move memory content from source address to destination
@@ -236,7 +250,12 @@ RTM_EXPORT(rt_memmove);
  *         If the result > 0, cs is greater than ct.
  *         If the result = 0, cs is equal to ct.
  */
-rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_size_t count)
+#ifdef RT_KSERVICE_USING_ARCH_OPTIMIZED
+/* libcpu provides rt_memcmp, this one is kept for its benchmark */
+rt_int32_t rt_memcmp_generic(const void *cs, const void *ct, rt_size_t count)
+#else
+rt_weak rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_size_t count)
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 {
     const unsigned char *su1 = RT_NULL, *su2 = RT_NULL;
     int res = 0;
@@ -247,7 +266,9 @@ rt_int32_t rt_memcmp(const void *cs, const void *ct, rt_size_t count)
 
     return res;
 }
+#ifndef RT_KSERVICE_USING_ARCH_OPTIMIZED
 RTM_EXPORT(rt_memcmp);
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 #endif /* RT_KSERVICE_USING_STDLIB_MEMORY*/
 
 #ifndef RT_KSERVICE_USING_STDLIB
@@ -444,7 +465,12 @@ RTM_EXPORT(rt_strcmp);
  *
  * @return The length of string.
  */
-rt_size_t rt_strlen(const char *s)
+#ifdef RT_KSERVICE_USING_ARCH_OPTIMIZED
+/* libcpu provides rt_strlen, this one is kept for its benchmark */
+rt_size_t rt_strlen_generic(const char *s)
+#else
+rt_weak rt_size_t rt_strlen(const char *s)
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 {
     const char *sc = RT_NULL;
 
@@ -453,7 +479,9 @@ rt_size_t rt_strlen(const char *s)
 
     return sc - s;
 }
+#ifndef RT_KSERVICE_USING_ARCH_OPTIMIZED
 RTM_EXPORT(rt_strlen);
+#endif /* RT_KSERVICE_USING_ARCH_OPTIMIZED */
 
 #endif /* RT_KSERVICE_USING_STDLIB */
 
@@ -481,6 +509,32 @@ rt_size_t rt_strnlen(const char *s, rt_ubase_t maxlen)
 }
 RTM_EXPORT(rt_strnlen);
 
+/**
+ * @brief  This function hashes at most maxlen characters of a string, the
+ * strings equal in their first maxlen characters have the same hash. The low
+ * bits of the hash are mixed with the high ones, so a power of two table is
+ * indexed by masking it.
+ *
+ * @param  s is the string.
+ *
+ * @param  maxlen is the max size.
+ *
+ * @return The hash of the string.
+ */
+rt_uint32_t rt_strnhash(const char *s, rt_size_t maxlen)
+{
+    rt_uint32_t hash = 5381;
+    rt_size_t index;
+
+    for (index = 0; index < maxlen && s[index] != '\0'; index ++)
+    {
+        hash = (hash << 5) + hash + (rt_uint8_t)s[index];
+    }
+
+    return hash ^ (hash >> 16);
+}
+RTM_EXPORT(rt_strnhash);
+
 #ifdef RT_USING_HEAP
 /**
  * @brief  This function will duplicate a string.
@@ -765,6 +765,27 @@ rt_inline void _slab_info(rt_size_t *total,
 #define _MEM_FREE(_ptr) \
     rt_slab_free(system_heap, _ptr)
 #define _MEM_INFO       _slab_info
+#elif defined(RT_USING_TLSF_MEM_AS_HEAP)
+static rt_tlsf_t system_heap;
+rt_inline void _tlsf_info(rt_size_t *total,
+    rt_size_t *used, rt_size_t *max_used)
+{
+    if (total)
+        *total = system_heap->total;
+    if (used)
+        *used = system_heap->used;
+    if (max_used)
+        *max_used = system_heap->max;
+}
+#define _MEM_INIT(_name, _start, _size) \
+    system_heap = rt_tlsf_init(_name, _start, _size)
+#define _MEM_MALLOC(_size)  \
+    rt_tlsf_alloc(system_heap, _size)
+#define _MEM_REALLOC(_ptr, _newsize)    \
+    rt_tlsf_realloc(system_heap, _ptr, _newsize)
+#define _MEM_FREE(_ptr) \
+    rt_tlsf_free(system_heap, _ptr)
+#define _MEM_INFO       _tlsf_info
 #else
 #define _MEM_INIT(...)
 #define _MEM_MALLOC(...)     RT_NULL
@@ -45,6 +45,16 @@ void rt_mp_alloc_sethook(void (*hook)(struct rt_mempool *mp, void *block))
     rt_mp_alloc_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_mp_alloc_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_mp_alloc_gethook(void))(struct rt_mempool *mp, void *block)
+{
+    return rt_mp_alloc_hook;
+}
+
 /**
  * @brief This function will set a hook function, which will be invoked when a memory
  *        block is released to the memory pool.
@@ -56,6 +66,16 @@ void rt_mp_free_sethook(void (*hook)(struct rt_mempool *mp, void *block))
     rt_mp_free_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_mp_free_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_mp_free_gethook(void))(struct rt_mempool *mp, void *block)
+{
+    return rt_mp_free_hook;
+}
+
 /**@}*/
 #endif /* RT_USING_HOOK */
 
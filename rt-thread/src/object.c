@@ -144,6 +144,46 @@ static struct rt_object_information _object_container[RT_Object_Info_Unknown] =
 #endif
 };
 
+#ifdef RT_USING_OBJECT_HASH
+#if (RT_OBJECT_HASH_SIZE < 1) || ((RT_OBJECT_HASH_SIZE & (RT_OBJECT_HASH_SIZE - 1)) != 0)
+#error "RT_OBJECT_HASH_SIZE must be a power of two"
+#endif
+
+/*
+ * hash the name in the same range that rt_object_find() compares it, that is
+ * at most RT_NAME_MAX characters, so the equal names are in the same bucket.
+ */
+rt_inline rt_uint32_t _object_name_hash(const char *name)
+{
+    return rt_strnhash(name, RT_NAME_MAX) & (RT_OBJECT_HASH_SIZE - 1);
+}
+
+/* the spinlock of information shall be held */
+rt_inline void _object_hash_insert(struct rt_object_information *information,
+                                   struct rt_object *object, rt_uint32_t hash)
+{
+    object->hash_next = information->hash_table[hash];
+    information->hash_table[hash] = object;
+}
+
+/* the spinlock of information shall be held */
+rt_inline void _object_hash_remove(struct rt_object_information *information,
+                                   struct rt_object *object, rt_uint32_t hash)
+{
+    struct rt_object **iter;
+
+    for (iter = &(information->hash_table[hash]); *iter != RT_NULL; iter = &((*iter)->hash_next))
+    {
+        if (*iter == object)
+        {
+            *iter = object->hash_next;
+            break;
+        }
+    }
+    object->hash_next = RT_NULL;
+}
+#endif /* RT_USING_OBJECT_HASH */
+
 #if defined(RT_USING_HOOK) && defined(RT_HOOK_USING_FUNC_PTR)
 static void (*rt_object_attach_hook)(struct rt_object *object);
 static void (*rt_object_detach_hook)(struct rt_object *object);
@@ -197,6 +237,16 @@ void rt_object_trytake_sethook(void (*hook)(struct rt_object *object))
     rt_object_trytake_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_object_trytake_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_object_trytake_gethook(void))(struct rt_object *object)
+{
+    return rt_object_trytake_hook;
+}
+
 /**
  * @brief This function will set a hook function, which will be invoked when object
  *        have been taken from kernel object system.
@@ -216,6 +266,16 @@ void rt_object_take_sethook(void (*hook)(struct rt_object *object))
     rt_object_take_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_object_take_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_object_take_gethook(void))(struct rt_object *object)
+{
+    return rt_object_take_hook;
+}
+
 /**
  * @brief This function will set a hook function, which will be invoked when object
  *        is put to kernel object system.
@@ -227,6 +287,16 @@ void rt_object_put_sethook(void (*hook)(struct rt_object *object))
     rt_object_put_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_object_put_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_object_put_gethook(void))(struct rt_object *object)
+{
+    return rt_object_put_hook;
+}
+
 /**@}*/
 #endif /* RT_USING_HOOK */
 
@@ -349,6 +419,9 @@ void rt_object_init(struct rt_object         *object,
 #ifdef RT_USING_DEBUG
     struct rt_list_node *node = RT_NULL;
 #endif
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t hash;
+#endif /* RT_USING_OBJECT_HASH */
     struct rt_object_information *information;
 #ifdef RT_USING_MODULE
     struct rt_dlmodule *module = dlmodule_self();
@@ -388,6 +461,10 @@ void rt_object_init(struct rt_object         *object,
 
     RT_OBJECT_HOOK_CALL(rt_object_attach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    hash = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     level = rt_spin_lock_irqsave(&(information->spinlock));
 
 #ifdef RT_USING_MODULE
@@ -401,6 +478,9 @@ void rt_object_init(struct rt_object         *object,
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        _object_hash_insert(information, object, hash);
+#endif /* RT_USING_OBJECT_HASH */
     }
     rt_spin_unlock_irqrestore(&(information->spinlock), level);
 }
@@ -414,6 +494,9 @@ void rt_object_init(struct rt_object         *object,
 void rt_object_detach(rt_object_t object)
 {
     rt_base_t level;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t hash;
+#endif /* RT_USING_OBJECT_HASH */
     struct rt_object_information *information;
 
     /* object check */
@@ -424,9 +507,16 @@ void rt_object_detach(rt_object_t object)
     information = rt_object_get_information((enum rt_object_class_type)object->type);
     RT_ASSERT(information != RT_NULL);
 
+#ifdef RT_USING_OBJECT_HASH
+    hash = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     level = rt_spin_lock_irqsave(&(information->spinlock));
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(information, object, hash);
+#endif /* RT_USING_OBJECT_HASH */
     rt_spin_unlock_irqrestore(&(information->spinlock), level);
 
     object->type = 0;
@@ -446,6 +536,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 {
     struct rt_object *object;
     rt_base_t level;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t hash;
+#endif /* RT_USING_OBJECT_HASH */
     struct rt_object_information *information;
 #ifdef RT_USING_MODULE
     struct rt_dlmodule *module = dlmodule_self();
@@ -483,6 +576,10 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 
     RT_OBJECT_HOOK_CALL(rt_object_attach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    hash = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     level = rt_spin_lock_irqsave(&(information->spinlock));
 
 #ifdef RT_USING_MODULE
@@ -496,6 +593,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        _object_hash_insert(information, object, hash);
+#endif /* RT_USING_OBJECT_HASH */
     }
     rt_spin_unlock_irqrestore(&(information->spinlock), level);
 
@@ -510,6 +610,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 void rt_object_delete(rt_object_t object)
 {
     rt_base_t level;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t hash;
+#endif /* RT_USING_OBJECT_HASH */
     struct rt_object_information *information;
 
     /* object check */
@@ -522,10 +625,17 @@ void rt_object_delete(rt_object_t object)
     information = rt_object_get_information((enum rt_object_class_type)object->type);
     RT_ASSERT(information != RT_NULL);
 
+#ifdef RT_USING_OBJECT_HASH
+    hash = _object_name_hash(object->name);
+#endif /* RT_USING_OBJECT_HASH */
+
     level = rt_spin_lock_irqsave(&(information->spinlock));
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(information, object, hash);
+#endif /* RT_USING_OBJECT_HASH */
 
     rt_spin_unlock_irqrestore(&(information->spinlock), level);
 
@@ -590,7 +700,11 @@ rt_uint8_t rt_object_get_type(rt_object_t object)
 rt_object_t rt_object_find(const char *name, rt_uint8_t type)
 {
     struct rt_object *object = RT_NULL;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t hash;
+#else
     struct rt_list_node *node = RT_NULL;
+#endif /* RT_USING_OBJECT_HASH */
     struct rt_object_information *information = RT_NULL;
     rt_base_t level;
 
@@ -602,9 +716,27 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     /* which is invoke in interrupt status */
     RT_DEBUG_NOT_IN_INTERRUPT;
 
+#ifdef RT_USING_OBJECT_HASH
+    hash = _object_name_hash(name);
+#endif /* RT_USING_OBJECT_HASH */
+
     /* enter critical */
     level = rt_spin_lock_irqsave(&(information->spinlock));
 
+#ifdef RT_USING_OBJECT_HASH
+    /* only the objects in the same bucket can have this name */
+    for (object = information->hash_table[hash]; object != RT_NULL; object = object->hash_next)
+    {
+        if (rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+        {
+            break;
+        }
+    }
+
+    rt_spin_unlock_irqrestore(&(information->spinlock), level);
+
+    return object;
+#else
     /* try to find object */
     rt_list_for_each(node, &(information->object_list))
     {
@@ -620,6 +752,7 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     rt_spin_unlock_irqrestore(&(information->spinlock), level);
 
     return RT_NULL;
+#endif /* RT_USING_OBJECT_HASH */
 }
 
 /**
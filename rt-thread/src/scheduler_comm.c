@@ -14,6 +14,7 @@
 #define DBG_LVL           DBG_INFO
 #include <rtdbg.h>
 
+#include <rthw.h>
 #include <rtthread.h>
 
 void rt_sched_thread_init_ctx(struct rt_thread *thread, rt_uint32_t tick, rt_uint8_t priority)
@@ -275,3 +276,132 @@ void rt_scheduler_stack_check(struct rt_thread *thread)
 }
 
 #endif /* RT_USING_OVERFLOW_CHECK */
+
+#ifdef RT_USING_CPU_USAGE
+extern rt_uint64_t clock_cpu_gettime(void);
+
+/*
+ * The timestamps are kept in 32 bits and only the differences are used, so a
+ * wrapped cputime counter is fine as long as an interval is shorter than one
+ * period of the counter. The running thread is checkpointed on every outermost
+ * interrupt, which keeps its interval within one OS tick.
+ */
+struct rt_sched_usage
+{
+    rt_uint32_t last;                   /* checkpoint of the running thread */
+    rt_uint32_t slice_start;            /* when the running thread was switched in */
+    rt_uint32_t irq_start;              /* when the outermost interrupt entered */
+    rt_uint64_t irq_tick;               /* total time spent in interrupts */
+};
+
+static struct rt_sched_usage _sched_usage[RT_CPUS_NR];
+
+rt_inline struct rt_sched_usage *_sched_usage_self(void)
+{
+#ifdef RT_USING_SMP
+    return &_sched_usage[rt_hw_cpu_id()];
+#else
+    return &_sched_usage[0];
+#endif /* RT_USING_SMP */
+}
+
+/**
+ * @brief Account the run time of the thread switched out. It shall be called
+ *        with interrupt disabled when the scheduler picks a new thread.
+ *
+ * @param from is the thread switched out, RT_NULL for the first thread.
+ *
+ * @param to is the thread switched in.
+ */
+void rt_sched_usage_switch(struct rt_thread *from, struct rt_thread *to)
+{
+    struct rt_sched_usage *usage = _sched_usage_self();
+    rt_uint32_t now = (rt_uint32_t)clock_cpu_gettime();
+    rt_uint32_t slice;
+
+    RT_UNUSED(to);
+
+    if (from != RT_NULL)
+    {
+        /* the time in the current interrupt is accounted on leaving */
+        if (rt_interrupt_get_nest() == 0)
+        {
+            from->duration_tick += (rt_uint32_t)(now - usage->last);
+        }
+
+        slice = now - usage->slice_start;
+        if (slice > from->max_slice_tick)
+        {
+            from->max_slice_tick = slice;
+        }
+    }
+
+    usage->last = now;
+    usage->slice_start = now;
+}
+
+/**
+ * @brief Start the accounting of interrupt time. It shall be called after the
+ *        interrupt nest is increased.
+ */
+void rt_sched_usage_irq_enter(void)
+{
+    struct rt_sched_usage *usage;
+    struct rt_thread *thread;
+    rt_uint32_t now;
+
+    /* only the outermost interrupt is accounted */
+    if (rt_interrupt_get_nest() != 1)
+        return;
+
+    usage = _sched_usage_self();
+    now = (rt_uint32_t)clock_cpu_gettime();
+
+    thread = rt_thread_self();
+    if (thread != RT_NULL)
+    {
+        thread->duration_tick += (rt_uint32_t)(now - usage->last);
+    }
+    usage->irq_start = now;
+}
+
+/**
+ * @brief Stop the accounting of interrupt time. It shall be called before the
+ *        interrupt nest is decreased.
+ */
+void rt_sched_usage_irq_leave(void)
+{
+    struct rt_sched_usage *usage;
+    rt_uint32_t now;
+
+    if (rt_interrupt_get_nest() != 1)
+        return;
+
+    usage = _sched_usage_self();
+    now = (rt_uint32_t)clock_cpu_gettime();
+
+    usage->irq_tick += (rt_uint32_t)(now - usage->irq_start);
+    usage->last = now;
+}
+
+/**
+ * @brief Get the total time spent in interrupts of a cpu.
+ *
+ * @param cpu is the index of the cpu.
+ *
+ * @return the time in cputime tick.
+ */
+rt_uint64_t rt_sched_usage_irq_tick(int cpu)
+{
+    rt_base_t level;
+    rt_uint64_t tick;
+
+    RT_ASSERT(cpu >= 0 && cpu < RT_CPUS_NR);
+
+    level = rt_hw_local_irq_disable();
+    tick = _sched_usage[cpu].irq_tick;
+    rt_hw_local_irq_enable(level);
+
+    return tick;
+}
+#endif /* RT_USING_CPU_USAGE */
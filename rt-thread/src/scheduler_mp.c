@@ -148,6 +148,16 @@ void rt_scheduler_sethook(void (*hook)(struct rt_thread *from, struct rt_thread
     rt_scheduler_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_scheduler_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_scheduler_gethook(void))(struct rt_thread *from, struct rt_thread *to)
+{
+    return rt_scheduler_hook;
+}
+
 /**
  * @brief This function will set a hook function, which will be invoked when context
  *        switch happens.
@@ -469,6 +479,10 @@ void rt_system_scheduler_start(void)
     RT_SCHED_CTX(to_thread).oncpu = rt_hw_cpu_id();
     RT_SCHED_CTX(to_thread).stat = RT_THREAD_RUNNING;
 
+#ifdef RT_USING_CPU_USAGE
+    rt_sched_usage_switch(RT_NULL, to_thread);
+#endif /* RT_USING_CPU_USAGE */
+
     LOG_D("[cpu#%d] switch to priority#%d thread:%.*s(sp:0x%08x)",
           rt_hw_cpu_id(), RT_SCHED_PRIV(to_thread).current_priority,
           RT_NAME_MAX, to_thread->parent.name, to_thread->sp);
@@ -624,6 +638,9 @@ static rt_thread_t _prepare_context_switch_locked(int cpu_id,
             pcpu->current_priority = (rt_uint8_t)highest_ready_priority;
 
             RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (current_thread, to_thread));
+#ifdef RT_USING_CPU_USAGE
+            rt_sched_usage_switch(current_thread, to_thread);
+#endif /* RT_USING_CPU_USAGE */
 
             /* remove to_thread from ready queue and update its status to RUNNING */
             _sched_remove_thread_locked(to_thread);
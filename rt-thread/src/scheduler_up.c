@@ -72,6 +72,16 @@ void rt_scheduler_sethook(void (*hook)(struct rt_thread *from, struct rt_thread
     rt_scheduler_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_scheduler_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_scheduler_gethook(void))(struct rt_thread *from, struct rt_thread *to)
+{
+    return rt_scheduler_hook;
+}
+
 /**
  * @brief This function will set a hook function, which will be invoked when context
  *        switch happens.
@@ -180,6 +190,10 @@ void rt_system_scheduler_start(void)
     rt_sched_remove_thread(to_thread);
     RT_SCHED_CTX(to_thread).stat = RT_THREAD_RUNNING;
 
+#ifdef RT_USING_CPU_USAGE
+    rt_sched_usage_switch(RT_NULL, to_thread);
+#endif /* RT_USING_CPU_USAGE */
+
     /* switch to new thread */
 
     rt_hw_context_switch_to((rt_ubase_t)&to_thread->sp);
@@ -243,6 +257,9 @@ void rt_schedule(void)
                 rt_current_thread   = to_thread;
 
                 RT_OBJECT_HOOK_CALL(rt_scheduler_hook, (from_thread, to_thread));
+#ifdef RT_USING_CPU_USAGE
+                rt_sched_usage_switch(from_thread, to_thread);
+#endif /* RT_USING_CPU_USAGE */
 
                 if (need_insert_from_thread)
                 {
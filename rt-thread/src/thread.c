@@ -61,6 +61,16 @@ void rt_thread_suspend_sethook(void (*hook)(rt_thread_t thread))
     rt_thread_suspend_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_thread_suspend_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_thread_suspend_gethook(void))(rt_thread_t thread)
+{
+    return rt_thread_suspend_hook;
+}
+
 /**
  * @brief   This function sets a hook function when the system resume a thread.
  *
@@ -73,6 +83,16 @@ void rt_thread_resume_sethook(void (*hook)(rt_thread_t thread))
     rt_thread_resume_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_thread_resume_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_thread_resume_gethook(void))(rt_thread_t thread)
+{
+    return rt_thread_resume_hook;
+}
+
 RT_OBJECT_HOOKLIST_DEFINE(rt_thread_inited);
 #endif /* defined(RT_USING_HOOK) && defined(RT_HOOK_USING_FUNC_PTR) */
 
@@ -285,6 +305,7 @@ static rt_err_t _thread_init(struct rt_thread *thread,
 
 #ifdef RT_USING_CPU_USAGE
     thread->duration_tick = 0;
+    thread->max_slice_tick = 0;
 #endif /* RT_USING_CPU_USAGE */
 
 #ifdef RT_USING_PTHREADS
@@ -30,8 +30,45 @@
 #define DBG_LVL           DBG_INFO
 #include <rtdbg.h>
 
+#ifdef RT_USING_TIMER_WHEEL
+#if RT_TIMER_SKIP_LIST_LEVEL != 1
+#error "RT_USING_TIMER_WHEEL requires RT_TIMER_SKIP_LIST_LEVEL to be 1"
+#endif /* RT_TIMER_SKIP_LIST_LEVEL != 1 */
+
+#ifndef RT_TIMER_WHEEL_LEVEL
+#define RT_TIMER_WHEEL_LEVEL           4
+#endif /* RT_TIMER_WHEEL_LEVEL */
+
+#define _WHEEL_SLOT_BITS               5
+#define _WHEEL_SLOT_NR                 (1u << _WHEEL_SLOT_BITS)
+#define _WHEEL_SLOT_MASK               (_WHEEL_SLOT_NR - 1)
+#define _WHEEL_LEVEL_SHIFT(level)      ((level) * _WHEEL_SLOT_BITS)
+#define _WHEEL_SPAN_MASK(level)        (((rt_tick_t)1 << _WHEEL_LEVEL_SHIFT(level)) - 1)
+
+/*
+ * Hierarchical timing wheel. Level 0 has one slot per tick, every upper level
+ * has one slot per revolution of the level below it. A timer is hashed into
+ * the lowest level able to hold its remaining ticks and is moved down a level
+ * each time the wheel reaches the slot it sits in, so starting and stopping a
+ * timer never depends on the number of active timers.
+ */
+struct _timer_wheel
+{
+    rt_tick_t   now;                                        /* the tick to be processed */
+    rt_uint32_t bitmap[RT_TIMER_WHEEL_LEVEL];               /* non-empty slots of each level */
+    rt_list_t   slot[RT_TIMER_WHEEL_LEVEL][_WHEEL_SLOT_NR];
+    rt_list_t   overflow;                                   /* timers beyond the top level */
+};
+
+typedef struct _timer_wheel _timer_list_t;
+#define _TIMER_LIST_NR                 1
+#else
+typedef rt_list_t _timer_list_t;
+#define _TIMER_LIST_NR                 RT_TIMER_SKIP_LIST_LEVEL
+#endif /* RT_USING_TIMER_WHEEL */
+
 /* hard timer list */
-static rt_list_t _timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+static _timer_list_t _timer_list[_TIMER_LIST_NR];
 static struct rt_spinlock _htimer_lock;
 
 #ifdef RT_USING_TIMER_SOFT
@@ -45,7 +82,7 @@ static struct rt_spinlock _htimer_lock;
 #endif /* RT_TIMER_THREAD_PRIO */
 
 /* soft timer list */
-static rt_list_t _soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL];
+static _timer_list_t _soft_timer_list[_TIMER_LIST_NR];
 static struct rt_spinlock _stimer_lock;
 static struct rt_thread _timer_thread;
 static struct rt_semaphore _soft_timer_sem;
@@ -76,6 +113,16 @@ void rt_timer_enter_sethook(void (*hook)(struct rt_timer *timer))
     rt_timer_enter_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_timer_enter_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_timer_enter_gethook(void))(struct rt_timer *timer)
+{
+    return rt_timer_enter_hook;
+}
+
 /**
  * @brief This function will set a hook function, which will be
  *        invoked when exit timer timeout callback function.
@@ -87,6 +134,16 @@ void rt_timer_exit_sethook(void (*hook)(struct rt_timer *timer))
     rt_timer_exit_hook = hook;
 }
 
+/**
+ * @brief This function will get the hook function set by rt_timer_exit_sethook().
+ *
+ * @return the hook function, RT_NULL if there is none.
+ */
+void (*rt_timer_exit_gethook(void))(struct rt_timer *timer)
+{
+    return rt_timer_exit_hook;
+}
+
 /**@}*/
 #endif /* RT_USING_HOOK */
 
@@ -104,6 +161,245 @@ rt_inline struct rt_spinlock* _timerlock_idx(struct rt_timer *timer)
     }
 }
 
+#ifdef RT_USING_TIMER_WHEEL
+rt_inline _timer_list_t *_timer_list_idx(struct rt_timer *timer)
+{
+#ifdef RT_USING_TIMER_SOFT
+    if (timer->parent.flag & RT_TIMER_FLAG_SOFT_TIMER)
+    {
+        return &_soft_timer_list[0];
+    }
+    else
+#endif /* RT_USING_TIMER_SOFT */
+    {
+        return &_timer_list[0];
+    }
+}
+
+/**
+ * @brief Hash a timer into the wheel slot matching its timeout tick
+ *
+ * @param wheel is the timing wheel
+ *
+ * @param timer is the timer to be inserted
+ */
+static void _timer_wheel_insert(struct _timer_wheel *wheel, struct rt_timer *timer)
+{
+    rt_tick_t expire = timer->timeout_tick;
+    rt_tick_t delta = expire - wheel->now;
+    rt_list_t *head;
+    rt_uint32_t idx;
+    int level;
+
+    /* an expired timer is handled on the tick being processed */
+    if (delta >= RT_TICK_MAX / 2)
+    {
+        expire = wheel->now;
+        delta = 0;
+    }
+
+    for (level = 0; level < RT_TIMER_WHEEL_LEVEL; level++)
+    {
+        if (delta <= _WHEEL_SPAN_MASK(level + 1))
+            break;
+    }
+
+    if (level == RT_TIMER_WHEEL_LEVEL)
+    {
+        head = &wheel->overflow;
+    }
+    else
+    {
+        idx = (expire >> _WHEEL_LEVEL_SHIFT(level)) & _WHEEL_SLOT_MASK;
+        head = &wheel->slot[level][idx];
+        wheel->bitmap[level] |= 1u << idx;
+    }
+
+    /*
+     * append to the slot, a timer cascading down later lands behind the ones
+     * already there, so the timers of the same tick may run out of start order
+     */
+    rt_list_insert_before(head, &timer->row[0]);
+}
+
+/**
+ * @brief Unlink a timer from the wheel, clearing the slot bit if it was the last one
+ *
+ * @param wheel is the timing wheel
+ *
+ * @param timer is the timer to be removed
+ */
+static void _timer_wheel_remove(struct _timer_wheel *wheel, struct rt_timer *timer)
+{
+    rt_list_t *node = &timer->row[0];
+    rt_ubase_t offset;
+
+    if (node->next != node && node->next == node->prev)
+    {
+        offset = ((rt_ubase_t)node->next - (rt_ubase_t)&wheel->slot[0][0]) / sizeof(rt_list_t);
+        if (offset < RT_TIMER_WHEEL_LEVEL * _WHEEL_SLOT_NR)
+        {
+            wheel->bitmap[offset / _WHEEL_SLOT_NR] &= ~(1u << (offset % _WHEEL_SLOT_NR));
+        }
+    }
+
+    rt_list_remove(node);
+}
+
+/**
+ * @brief Re-hash all timers of a list into the wheel
+ *
+ * @param wheel is the timing wheel
+ *
+ * @param head is the list to be drained
+ */
+static void _timer_wheel_rehash(struct _timer_wheel *wheel, rt_list_t *head)
+{
+    rt_list_t list;
+    struct rt_timer *t;
+
+    if (rt_list_isempty(head))
+        return;
+
+    /* take the whole list over, the timers may hash back into it */
+    list.next = head->next;
+    list.prev = head->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    rt_list_init(head);
+
+    while (!rt_list_isempty(&list))
+    {
+        t = rt_list_entry(list.next, struct rt_timer, row[0]);
+        rt_list_remove(&t->row[0]);
+        _timer_wheel_insert(wheel, t);
+    }
+}
+
+/**
+ * @brief Move the timers of the upper level slots reached by the current tick down
+ *
+ * @param wheel is the timing wheel
+ */
+static void _timer_wheel_cascade(struct _timer_wheel *wheel)
+{
+    rt_uint32_t idx;
+    int level;
+
+    for (level = 1; level < RT_TIMER_WHEEL_LEVEL; level++)
+    {
+        if (wheel->now & _WHEEL_SPAN_MASK(level))
+            return;
+
+        idx = (wheel->now >> _WHEEL_LEVEL_SHIFT(level)) & _WHEEL_SLOT_MASK;
+        if (wheel->bitmap[level] & (1u << idx))
+        {
+            wheel->bitmap[level] &= ~(1u << idx);
+            _timer_wheel_rehash(wheel, &wheel->slot[level][idx]);
+        }
+    }
+
+    if ((wheel->now & _WHEEL_SPAN_MASK(RT_TIMER_WHEEL_LEVEL)) == 0)
+    {
+        _timer_wheel_rehash(wheel, &wheel->overflow);
+    }
+}
+
+/**
+ * @brief Find the next tick on which the wheel has work to do
+ *
+ *        For timers on level 0 this is their exact timeout tick, for the upper
+ *        levels and the overflow list it is the tick on which they cascade,
+ *        which is never later than their timeout tick.
+ *
+ * @param wheel is the timing wheel
+ *
+ * @param tick is the next tick with work to do
+ *
+ * @return RT_EOK if the wheel holds any timer, otherwise -RT_ERROR.
+ */
+static rt_err_t _timer_wheel_next_event(struct _timer_wheel *wheel, rt_tick_t *tick)
+{
+    rt_err_t err = -RT_ERROR;
+    rt_tick_t base, next;
+    rt_uint32_t bits, idx;
+    int level;
+
+    for (level = 0; level < RT_TIMER_WHEEL_LEVEL; level++)
+    {
+        bits = wheel->bitmap[level];
+        if (bits == 0)
+            continue;
+
+        /* the current slot of an upper level has already been cascaded */
+        base = (wheel->now >> _WHEEL_LEVEL_SHIFT(level)) + (level > 0);
+        idx = base & _WHEEL_SLOT_MASK;
+        if (idx)
+            bits = (bits >> idx) | (bits << (_WHEEL_SLOT_NR - idx));
+
+        next = (base + __rt_ffs((int)bits) - 1) << _WHEEL_LEVEL_SHIFT(level);
+        if (err != RT_EOK || (next - wheel->now) < (*tick - wheel->now))
+        {
+            *tick = next;
+            err = RT_EOK;
+        }
+    }
+
+    if (!rt_list_isempty(&wheel->overflow))
+    {
+        next = ((wheel->now >> _WHEEL_LEVEL_SHIFT(RT_TIMER_WHEEL_LEVEL)) + 1) << _WHEEL_LEVEL_SHIFT(RT_TIMER_WHEEL_LEVEL);
+        if (err != RT_EOK || (next - wheel->now) < (*tick - wheel->now))
+        {
+            *tick = next;
+            err = RT_EOK;
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Turn the wheel up to current_tick and return the first expired timer
+ *
+ * @param wheel is the timing wheel
+ *
+ * @param current_tick is the current tick
+ *
+ * @return the first expired timer, or RT_NULL if no timer has expired.
+ */
+static struct rt_timer *_timer_wheel_expired(struct _timer_wheel *wheel, rt_tick_t current_tick)
+{
+    rt_list_t *slot;
+    rt_tick_t next;
+
+    while (1)
+    {
+        slot = &wheel->slot[0][wheel->now & _WHEEL_SLOT_MASK];
+        if (!rt_list_isempty(slot))
+        {
+            return rt_list_entry(slot->next, struct rt_timer, row[0]);
+        }
+
+        if (wheel->now == current_tick || (current_tick - wheel->now) >= RT_TICK_MAX / 2)
+        {
+            /* the wheel has caught up with current_tick */
+            return RT_NULL;
+        }
+
+        if (_timer_wheel_next_event(wheel, &next) != RT_EOK ||
+            (next - wheel->now) > (current_tick - wheel->now))
+        {
+            /* nothing to do before current_tick, skip the empty slots */
+            wheel->now = current_tick;
+            return RT_NULL;
+        }
+
+        wheel->now = next;
+        _timer_wheel_cascade(wheel);
+    }
+}
+#endif /* RT_USING_TIMER_WHEEL */
+
 /**
  * @brief [internal] The init funtion of timer
  *
@@ -158,8 +454,11 @@ static void _timer_init(rt_timer_t timer,
  * @return  Return the operation status. If the return value is RT_EOK, the function is successfully executed.
  *          If the return value is any other values, it means this operation failed.
  */
-static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *timeout_tick)
+static rt_err_t _timer_list_next_timeout(_timer_list_t timer_list[], rt_tick_t *timeout_tick)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    return _timer_wheel_next_event(&timer_list[0], timeout_tick);
+#else
     struct rt_timer *timer;
 
     if (!rt_list_isempty(&timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
@@ -170,6 +469,78 @@ static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *time
         return RT_EOK;
     }
     return -RT_ERROR;
+#endif /* RT_USING_TIMER_WHEEL */
+}
+
+/**
+ * @brief Get the first expired timer of the timer list
+ *
+ * @param timer_list is the array of time list
+ *
+ * @param current_tick is the current tick
+ *
+ * @return the first expired timer, or RT_NULL if no timer has expired.
+ */
+static struct rt_timer *_timer_list_expired(_timer_list_t timer_list[], rt_tick_t current_tick)
+{
+#ifdef RT_USING_TIMER_WHEEL
+    return _timer_wheel_expired(&timer_list[0], current_tick);
+#else
+    struct rt_timer *t;
+
+    if (rt_list_isempty(&timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    {
+        return RT_NULL;
+    }
+
+    t = rt_list_entry(timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
+                      struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
+
+    /*
+     * It supposes that the new tick shall less than the half duration of
+     * tick max.
+     */
+    if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+    {
+        return t;
+    }
+    return RT_NULL;
+#endif /* RT_USING_TIMER_WHEEL */
+}
+
+/**
+ * @brief Initialize the timer list
+ *
+ * @param timer_list is the array of time list
+ *
+ * @param tick is the current tick
+ */
+static void _timer_list_init(_timer_list_t timer_list[], rt_tick_t tick)
+{
+    rt_size_t i;
+#ifdef RT_USING_TIMER_WHEEL
+    struct _timer_wheel *wheel = &timer_list[0];
+
+    wheel->now = tick;
+    for (i = 0; i < RT_TIMER_WHEEL_LEVEL; i++)
+    {
+        rt_size_t j;
+
+        wheel->bitmap[i] = 0;
+        for (j = 0; j < _WHEEL_SLOT_NR; j++)
+        {
+            rt_list_init(&wheel->slot[i][j]);
+        }
+    }
+    rt_list_init(&wheel->overflow);
+#else
+    RT_UNUSED(tick);
+
+    for (i = 0; i < RT_TIMER_SKIP_LIST_LEVEL; i++)
+    {
+        rt_list_init(timer_list + i);
+    }
+#endif /* RT_USING_TIMER_WHEEL */
 }
 
 /**
@@ -179,15 +550,65 @@ static rt_err_t _timer_list_next_timeout(rt_list_t timer_list[], rt_tick_t *time
  */
 rt_inline void _timer_remove(rt_timer_t timer)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    _timer_wheel_remove(_timer_list_idx(timer), timer);
+#else
     int i;
 
     for (i = 0; i < RT_TIMER_SKIP_LIST_LEVEL; i++)
     {
         rt_list_remove(&timer->row[i]);
     }
+#endif /* RT_USING_TIMER_WHEEL */
 }
 
 #if (DBG_LVL == DBG_LOG)
+#ifdef RT_USING_TIMER_WHEEL
+/**
+ * @brief The number of timers in a list
+ *
+ * @param head the head of the list
+ *
+ * @return count of timer
+ */
+static int _timer_count_list(rt_list_t *head)
+{
+    rt_list_t *list;
+    int cnt = 0;
+
+    for (list = head->next; list != head; list = list->next)
+        cnt++;
+    return cnt;
+}
+
+/**
+ * @brief dump the all timer information
+ *
+ *        Print the number of timers in every non-empty slot of each level as
+ *        slot:count, and the number of timers in the overflow list.
+ *
+ * @param timer_heads the timing wheel
+ */
+void rt_timer_dump(_timer_list_t timer_heads[])
+{
+    struct _timer_wheel *wheel = &timer_heads[0];
+    rt_uint32_t idx;
+    int level;
+
+    rt_kprintf("now %d\n", wheel->now);
+    for (level = 0; level < RT_TIMER_WHEEL_LEVEL; level++)
+    {
+        rt_kprintf("L%d:", level);
+        for (idx = 0; idx < _WHEEL_SLOT_NR; idx++)
+        {
+            if (wheel->bitmap[level] & (1u << idx))
+                rt_kprintf(" %d:%d", idx, _timer_count_list(&wheel->slot[level][idx]));
+        }
+        rt_kprintf("\n");
+    }
+    rt_kprintf("overflow: %d\n", _timer_count_list(&wheel->overflow));
+}
+#else
 /**
  * @brief The number of timer
  *
@@ -211,7 +632,7 @@ static int _timer_count_height(struct rt_timer *timer)
  *
  * @param timer_heads the head of timer
  */
-void rt_timer_dump(rt_list_t timer_heads[])
+void rt_timer_dump(_timer_list_t timer_heads[])
 {
     rt_list_t *list;
 
@@ -226,6 +647,7 @@ void rt_timer_dump(rt_list_t timer_heads[])
     }
     rt_kprintf("\n");
 }
+#endif /* RT_USING_TIMER_WHEEL */
 #endif /* (DBG_LVL == DBG_LOG) */
 
 /**
@@ -395,12 +817,16 @@ RTM_EXPORT(rt_timer_delete);
  *
  * @return the operation status, RT_EOK on OK, -RT_ERROR on error
  */
-static rt_err_t _timer_start(rt_list_t *timer_list, rt_timer_t timer)
+static rt_err_t _timer_start(_timer_list_t *timer_list, rt_timer_t timer)
 {
+#ifdef RT_USING_TIMER_WHEEL
+    rt_tick_t next;
+#else
     unsigned int row_lvl;
     rt_list_t *row_head[RT_TIMER_SKIP_LIST_LEVEL];
     unsigned int tst_nr;
     static unsigned int random_nr;
+#endif /* RT_USING_TIMER_WHEEL */
 
     if (timer->parent.flag & RT_TIMER_FLAG_PROCESSING)
     {
@@ -416,6 +842,14 @@ static rt_err_t _timer_start(rt_list_t *timer_list, rt_timer_t timer)
 
     timer->timeout_tick = rt_tick_get() + timer->init_tick;
 
+#ifdef RT_USING_TIMER_WHEEL
+    /* an idle wheel is not turned, bring it up to date before hashing */
+    if (_timer_wheel_next_event(timer_list, &next) != RT_EOK)
+    {
+        timer_list->now = rt_tick_get();
+    }
+    _timer_wheel_insert(timer_list, timer);
+#else
     row_head[0]  = &timer_list[0];
     for (row_lvl = 0; row_lvl < RT_TIMER_SKIP_LIST_LEVEL; row_lvl++)
     {
@@ -466,6 +900,7 @@ static rt_err_t _timer_start(rt_list_t *timer_list, rt_timer_t timer)
          * bits. */
         tst_nr >>= (RT_TIMER_SKIP_LIST_MASK + 1) >> 1;
     }
+#endif /* RT_USING_TIMER_WHEEL */
 
     timer->parent.flag |= RT_TIMER_FLAG_ACTIVATED;
 
@@ -484,7 +919,7 @@ rt_err_t rt_timer_start(rt_timer_t timer)
     rt_sched_lock_level_t slvl;
     int is_thread_timer = 0;
     struct rt_spinlock *spinlock;
-    rt_list_t *timer_list;
+    _timer_list_t *timer_list;
     rt_base_t level;
     rt_err_t err;
 
@@ -693,16 +1128,10 @@ void rt_timer_check(void)
 
     rt_list_init(&list);
 
-    while (!rt_list_isempty(&_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    while (1)
     {
-        t = rt_list_entry(_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                          struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
-
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        t = _timer_list_expired(_timer_list, current_tick);
+        if (t != RT_NULL)
         {
             RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
@@ -782,18 +1211,12 @@ static void _soft_timer_check(void)
     LOG_D("software timer check enter");
     level = rt_spin_lock_irqsave(&_stimer_lock);
 
-    while (!rt_list_isempty(&_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1]))
+    while (1)
     {
-        t = rt_list_entry(_soft_timer_list[RT_TIMER_SKIP_LIST_LEVEL - 1].next,
-                            struct rt_timer, row[RT_TIMER_SKIP_LIST_LEVEL - 1]);
-
         current_tick = rt_tick_get();
 
-        /*
-         * It supposes that the new tick shall less than the half duration of
-         * tick max.
-         */
-        if ((current_tick - t->timeout_tick) < RT_TICK_MAX / 2)
+        t = _timer_list_expired(_soft_timer_list, current_tick);
+        if (t != RT_NULL)
         {
             RT_OBJECT_HOOK_CALL(rt_timer_enter_hook, (t));
 
@@ -896,12 +1319,7 @@ static void _timer_thread_entry(void *parameter)
  */
 void rt_system_timer_init(void)
 {
-    rt_size_t i;
-
-    for (i = 0; i < sizeof(_timer_list) / sizeof(_timer_list[0]); i++)
-    {
-        rt_list_init(_timer_list + i);
-    }
+    _timer_list_init(_timer_list, rt_tick_get());
     rt_spin_lock_init(&_htimer_lock);
 }
 
@@ -913,14 +1331,7 @@ void rt_system_timer_init(void)
 void rt_system_timer_thread_init(void)
 {
 #ifdef RT_USING_TIMER_SOFT
-    int i;
-
-    for (i = 0;
-         i < sizeof(_soft_timer_list) / sizeof(_soft_timer_list[0]);
-         i++)
-    {
-        rt_list_init(_soft_timer_list + i);
-    }
+    _timer_list_init(_soft_timer_list, rt_tick_get());
     rt_spin_lock_init(&_stimer_lock);
     rt_sem_init(&_soft_timer_sem, "stimer", 0, RT_IPC_FLAG_PRIO);
     /* start software timer thread */
@@ -0,0 +1,755 @@
+/*
+ * Copyright (c) 2006-2026, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-16     RT-Thread    the first version
+ */
+
+/*
+ * Two-Level Segregated Fit memory allocator
+ *
+ * The free blocks are kept in an array of segregated lists. The first level
+ * splits the block sizes by power of two, the second level splits every power
+ * of two range linearly into RT_TLSF_SL_INDEX_COUNT lists. Two bitmaps record
+ * which lists are not empty, so finding a suitable free block takes two "find
+ * first set" operations and allocation and release are O(1), no matter how
+ * fragmented the heap is.
+ *
+ * Every block starts with a header holding the previous physical block and
+ * the size of the block, which makes merging the neighbours of a released
+ * block O(1) as well. The free list links are stored in the data area of free
+ * blocks only.
+ *
+ * The algorithm is described in: M. Masmano, I. Ripoll, A. Crespo and J. Real,
+ * "TLSF: a New Dynamic Memory Allocator for Real-Time Systems", ECRTS 2004.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#if defined (RT_USING_TLSF_MEM)
+
+#define DBG_TAG           "kernel.tlsf"
+#define DBG_LVL           DBG_INFO
+#include <rtdbg.h>
+
+#ifndef RT_TLSF_FL_INDEX_MAX
+#define RT_TLSF_FL_INDEX_MAX        20
+#endif /* RT_TLSF_FL_INDEX_MAX */
+
+#define RT_TLSF_SL_INDEX_COUNT_LOG2 4
+#define RT_TLSF_SL_INDEX_COUNT      (1 << RT_TLSF_SL_INDEX_COUNT_LOG2)
+
+#if RT_ALIGN_SIZE >= 8
+#define RT_TLSF_ALIGN_SIZE_LOG2     3
+#else
+#define RT_TLSF_ALIGN_SIZE_LOG2     2
+#endif /* RT_ALIGN_SIZE >= 8 */
+
+/* blocks smaller than this are all kept on the first level list */
+#define RT_TLSF_FL_INDEX_SHIFT      (RT_TLSF_SL_INDEX_COUNT_LOG2 + RT_TLSF_ALIGN_SIZE_LOG2)
+#define RT_TLSF_FL_INDEX_COUNT      (RT_TLSF_FL_INDEX_MAX - RT_TLSF_FL_INDEX_SHIFT + 1)
+#define RT_TLSF_SMALL_BLOCK_SIZE    (1 << RT_TLSF_FL_INDEX_SHIFT)
+#define RT_TLSF_BLOCK_SIZE_MAX      (((rt_size_t)1 << RT_TLSF_FL_INDEX_MAX) - 1)
+
+#if RT_TLSF_FL_INDEX_COUNT > 32 || RT_TLSF_FL_INDEX_COUNT < 1
+#error "RT_TLSF_FL_INDEX_MAX is out of range"
+#endif
+
+struct rt_tlsf_block
+{
+    struct rt_tlsf_block   *prev_phys;          /**< previous physical block */
+    rt_size_t               size;               /**< data size and the block flags */
+#ifdef RT_USING_MEMTRACE
+#ifdef ARCH_CPU_64BIT
+    rt_uint8_t              thread[8];          /**< thread name */
+#else
+    rt_uint8_t              thread[4];          /**< thread name */
+#endif /* ARCH_CPU_64BIT */
+#endif /* RT_USING_MEMTRACE */
+
+    /* the free list links, only valid when the block is free */
+    struct rt_tlsf_block   *next_free;
+    struct rt_tlsf_block   *prev_free;
+};
+
+/**
+ * Base structure of TLSF memory object
+ */
+struct rt_tlsf_mem
+{
+    struct rt_memory        parent;                 /**< inherit from rt_memory */
+    rt_uint8_t             *heap_ptr;               /**< pointer to the heap */
+    struct rt_tlsf_block   *heap_end;               /**< the sentinel block */
+
+    rt_uint32_t             fl_bitmap;
+    rt_uint32_t             sl_bitmap[RT_TLSF_FL_INDEX_COUNT];
+    struct rt_tlsf_block   *blocks[RT_TLSF_FL_INDEX_COUNT][RT_TLSF_SL_INDEX_COUNT];
+};
+
+#define BLOCK_FREE              ((rt_size_t)0x1)    /**< the block is free */
+#define BLOCK_PREV_FREE         ((rt_size_t)0x2)    /**< the previous physical block is free */
+#define BLOCK_FLAGS             (BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define SIZEOF_STRUCT_BLOCK     RT_ALIGN((rt_size_t)&((struct rt_tlsf_block *)0)->next_free, RT_ALIGN_SIZE)
+#define MIN_SIZE_ALIGNED        RT_ALIGN(sizeof(struct rt_tlsf_block) - SIZEOF_STRUCT_BLOCK, RT_ALIGN_SIZE)
+
+#define BLOCK_SIZE(_b)          ((_b)->size & ~BLOCK_FLAGS)
+#define BLOCK_ISFREE(_b)        ((_b)->size & BLOCK_FREE)
+#define BLOCK_ISPREVFREE(_b)    ((_b)->size & BLOCK_PREV_FREE)
+#define BLOCK_DATA(_b)          ((void *)((rt_uint8_t *)(_b) + SIZEOF_STRUCT_BLOCK))
+#define BLOCK_FROM_DATA(_p)     ((struct rt_tlsf_block *)((rt_uint8_t *)(_p) - SIZEOF_STRUCT_BLOCK))
+#define BLOCK_NEXT(_b)          ((struct rt_tlsf_block *)((rt_uint8_t *)BLOCK_DATA(_b) + BLOCK_SIZE(_b)))
+
+#ifdef RT_USING_MEMTRACE
+rt_inline void rt_tlsf_setname(struct rt_tlsf_block *block, const char *name)
+{
+    int index;
+    for (index = 0; index < sizeof(block->thread); index ++)
+    {
+        if (name[index] == '\0') break;
+        block->thread[index] = name[index];
+    }
+
+    for (; index < sizeof(block->thread); index ++)
+    {
+        block->thread[index] = ' ';
+    }
+}
+#endif /* RT_USING_MEMTRACE */
+
+/**
+ * @brief Find the last (most significant) bit set, numbered from 0.
+ */
+rt_inline int _tlsf_fls(rt_size_t size)
+{
+    int bit = 0;
+
+#ifdef ARCH_CPU_64BIT
+    if (size >> 32) { size >>= 32; bit += 32; }
+#endif /* ARCH_CPU_64BIT */
+    if (size >> 16) { size >>= 16; bit += 16; }
+    if (size >> 8)  { size >>= 8;  bit += 8; }
+    if (size >> 4)  { size >>= 4;  bit += 4; }
+    if (size >> 2)  { size >>= 2;  bit += 2; }
+    if (size >> 1)  { bit += 1; }
+
+    return bit;
+}
+
+/**
+ * @brief Get the list that a free block of the size belongs to.
+ */
+static void _tlsf_mapping_insert(rt_size_t size, int *fl, int *sl)
+{
+    int t;
+
+    if (size < RT_TLSF_SMALL_BLOCK_SIZE)
+    {
+        *fl = 0;
+        *sl = (int)(size / (RT_TLSF_SMALL_BLOCK_SIZE / RT_TLSF_SL_INDEX_COUNT));
+    }
+    else
+    {
+        t = _tlsf_fls(size);
+        *sl = (int)(size >> (t - RT_TLSF_SL_INDEX_COUNT_LOG2)) ^ RT_TLSF_SL_INDEX_COUNT;
+        *fl = t - (RT_TLSF_FL_INDEX_SHIFT - 1);
+    }
+}
+
+/**
+ * @brief Get the first list whose blocks are all large enough for the size.
+ */
+static void _tlsf_mapping_search(rt_size_t size, int *fl, int *sl)
+{
+    if (size >= RT_TLSF_SMALL_BLOCK_SIZE)
+    {
+        size += ((rt_size_t)1 << (_tlsf_fls(size) - RT_TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    _tlsf_mapping_insert(size, fl, sl);
+}
+
+static void _tlsf_remove_free_block(struct rt_tlsf_mem *m, struct rt_tlsf_block *block, int fl, int sl)
+{
+    struct rt_tlsf_block *prev = block->prev_free;
+    struct rt_tlsf_block *next = block->next_free;
+
+    if (next)
+        next->prev_free = prev;
+    if (prev)
+        prev->next_free = next;
+
+    if (m->blocks[fl][sl] == block)
+    {
+        m->blocks[fl][sl] = next;
+        if (next == RT_NULL)
+        {
+            /* the list is empty now, clear the bit of it */
+            m->sl_bitmap[fl] &= ~(1U << sl);
+            if (m->sl_bitmap[fl] == 0)
+            {
+                m->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+}
+
+static void _tlsf_insert_free_block(struct rt_tlsf_mem *m, struct rt_tlsf_block *block, int fl, int sl)
+{
+    struct rt_tlsf_block *head = m->blocks[fl][sl];
+
+    block->next_free = head;
+    block->prev_free = RT_NULL;
+    if (head)
+        head->prev_free = block;
+
+    m->blocks[fl][sl] = block;
+    m->fl_bitmap |= (1U << fl);
+    m->sl_bitmap[fl] |= (1U << sl);
+}
+
+rt_inline void _tlsf_block_remove(struct rt_tlsf_mem *m, struct rt_tlsf_block *block)
+{
+    int fl, sl;
+
+    _tlsf_mapping_insert(BLOCK_SIZE(block), &fl, &sl);
+    _tlsf_remove_free_block(m, block, fl, sl);
+}
+
+rt_inline void _tlsf_block_insert(struct rt_tlsf_mem *m, struct rt_tlsf_block *block)
+{
+    int fl, sl;
+
+    _tlsf_mapping_insert(BLOCK_SIZE(block), &fl, &sl);
+    _tlsf_insert_free_block(m, block, fl, sl);
+}
+
+/**
+ * @brief Take a free block of at least the size off its list.
+ */
+static struct rt_tlsf_block *_tlsf_locate_free(struct rt_tlsf_mem *m, rt_size_t size)
+{
+    rt_uint32_t sl_map, fl_map;
+    struct rt_tlsf_block *block;
+    int fl, sl;
+
+    _tlsf_mapping_search(size, &fl, &sl);
+    if (fl >= RT_TLSF_FL_INDEX_COUNT)
+        return RT_NULL;
+
+    sl_map = m->sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0)
+    {
+        /* no block in this first level, try the larger ones */
+        fl_map = (fl + 1 < 32) ? (m->fl_bitmap & (~0U << (fl + 1))) : 0;
+        if (fl_map == 0)
+            return RT_NULL;
+
+        fl = __rt_ffs((int)fl_map) - 1;
+        sl_map = m->sl_bitmap[fl];
+    }
+    sl = __rt_ffs((int)sl_map) - 1;
+
+    block = m->blocks[fl][sl];
+    RT_ASSERT(block != RT_NULL && BLOCK_SIZE(block) >= size);
+    _tlsf_remove_free_block(m, block, fl, sl);
+
+    return block;
+}
+
+/**
+ * @brief Split the tail beyond the size off a block and return it as a free block.
+ *
+ * @note The block must not be on a free list.
+ */
+static void _tlsf_block_trim(struct rt_tlsf_mem *m, struct rt_tlsf_block *block, rt_size_t size)
+{
+    struct rt_tlsf_block *remain, *next;
+
+    if (BLOCK_SIZE(block) < size + SIZEOF_STRUCT_BLOCK + MIN_SIZE_ALIGNED)
+        return;
+
+    remain = (struct rt_tlsf_block *)((rt_uint8_t *)BLOCK_DATA(block) + size);
+    remain->size = (BLOCK_SIZE(block) - size - SIZEOF_STRUCT_BLOCK) | BLOCK_FREE;
+    remain->prev_phys = block;
+    block->size = size | (block->size & BLOCK_FLAGS);
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(remain, "    ");
+#endif /* RT_USING_MEMTRACE */
+
+    /* the block after the remainder may be free as well */
+    next = BLOCK_NEXT(remain);
+    if (BLOCK_ISFREE(next))
+    {
+        _tlsf_block_remove(m, next);
+        remain->size += BLOCK_SIZE(next) + SIZEOF_STRUCT_BLOCK;
+        next = BLOCK_NEXT(remain);
+    }
+    next->prev_phys = remain;
+    next->size |= BLOCK_PREV_FREE;
+
+    _tlsf_block_insert(m, remain);
+}
+
+rt_inline void _tlsf_block_mark_used(struct rt_tlsf_mem *m, struct rt_tlsf_block *block)
+{
+    block->size &= ~BLOCK_FREE;
+    BLOCK_NEXT(block)->size &= ~BLOCK_PREV_FREE;
+
+    m->parent.used += BLOCK_SIZE(block) + SIZEOF_STRUCT_BLOCK;
+    if (m->parent.max < m->parent.used)
+        m->parent.max = m->parent.used;
+
+#ifdef RT_USING_MEMTRACE
+    if (rt_thread_self())
+        rt_tlsf_setname(block, rt_thread_self()->parent.name);
+    else
+        rt_tlsf_setname(block, "NONE");
+#endif /* RT_USING_MEMTRACE */
+}
+
+rt_inline rt_size_t _tlsf_adjust_size(rt_size_t size)
+{
+    size = RT_ALIGN(size, RT_ALIGN_SIZE);
+
+    /* every data block must be able to hold the free list links */
+    if (size < MIN_SIZE_ALIGNED)
+        size = MIN_SIZE_ALIGNED;
+
+    return size;
+}
+
+/**
+ * @brief This function will initialize TLSF memory management algorithm.
+ *
+ * @param name is the name of the TLSF memory management object.
+ *
+ * @param begin_addr the beginning address of memory.
+ *
+ * @param size is the size of the memory.
+ *
+ * @return Return a pointer to the memory object. When the return value is RT_NULL, it means the init failed.
+ */
+rt_tlsf_t rt_tlsf_init(const char    *name,
+                       void          *begin_addr,
+                       rt_size_t      size)
+{
+    struct rt_tlsf_mem *tlsf;
+    struct rt_tlsf_block *block;
+    rt_ubase_t begin_align, end_align, mem_size;
+
+    tlsf = (struct rt_tlsf_mem *)RT_ALIGN((rt_ubase_t)begin_addr, RT_ALIGN_SIZE);
+    begin_align = RT_ALIGN((rt_ubase_t)tlsf + sizeof(*tlsf), RT_ALIGN_SIZE);
+    end_align   = RT_ALIGN_DOWN((rt_ubase_t)begin_addr + size, RT_ALIGN_SIZE);
+
+    /* the heap holds one free block and the sentinel at least */
+    if (end_align <= begin_align ||
+        end_align - begin_align < 2 * SIZEOF_STRUCT_BLOCK + MIN_SIZE_ALIGNED)
+    {
+        rt_kprintf("tlsf init, error begin address 0x%x, and end address 0x%x\n",
+                   (rt_ubase_t)begin_addr, (rt_ubase_t)begin_addr + size);
+
+        return RT_NULL;
+    }
+
+    mem_size = end_align - begin_align - 2 * SIZEOF_STRUCT_BLOCK;
+    if (mem_size > RT_TLSF_BLOCK_SIZE_MAX)
+    {
+        LOG_W("tlsf init, heap size %d is truncated to %d, please enlarge RT_TLSF_FL_INDEX_MAX",
+              mem_size, RT_ALIGN_DOWN(RT_TLSF_BLOCK_SIZE_MAX, RT_ALIGN_SIZE));
+        mem_size = RT_ALIGN_DOWN(RT_TLSF_BLOCK_SIZE_MAX, RT_ALIGN_SIZE);
+    }
+
+    rt_memset(tlsf, 0, sizeof(*tlsf));
+    /* initialize TLSF memory object */
+    rt_object_init(&(tlsf->parent.parent), RT_Object_Class_Memory, name);
+    tlsf->parent.algorithm = "tlsf";
+    tlsf->parent.address = begin_align;
+    tlsf->parent.total = mem_size + SIZEOF_STRUCT_BLOCK;
+
+    /* point to begin address of heap */
+    tlsf->heap_ptr = (rt_uint8_t *)begin_align;
+
+    LOG_D("tlsf init, heap begin address 0x%x, size %d",
+            (rt_ubase_t)tlsf->heap_ptr, mem_size);
+
+    /* initialize the only free block */
+    block = (struct rt_tlsf_block *)tlsf->heap_ptr;
+    block->prev_phys = RT_NULL;
+    block->size = mem_size | BLOCK_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(block, "INIT");
+#endif /* RT_USING_MEMTRACE */
+
+    /* initialize the sentinel, it is a used block of zero size */
+    tlsf->heap_end = BLOCK_NEXT(block);
+    tlsf->heap_end->prev_phys = block;
+    tlsf->heap_end->size = 0 | BLOCK_PREV_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(tlsf->heap_end, "INIT");
+#endif /* RT_USING_MEMTRACE */
+
+    _tlsf_block_insert(tlsf, block);
+
+    return &tlsf->parent;
+}
+RTM_EXPORT(rt_tlsf_init);
+
+/**
+ * @brief This function will remove a TLSF memory object from the system.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_tlsf_detach(rt_tlsf_t m)
+{
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    rt_object_detach(&(m->parent));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_tlsf_detach);
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * @brief Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @param size is the minimum size of the requested block in bytes.
+ *
+ * @return the pointer to allocated memory or NULL if no free memory was found.
+ */
+void *rt_tlsf_alloc(rt_tlsf_t m, rt_size_t size)
+{
+    struct rt_tlsf_mem *tlsf;
+    struct rt_tlsf_block *block;
+
+    if (size == 0)
+        return RT_NULL;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT(rt_object_is_systemobject(&m->parent));
+
+    tlsf = (struct rt_tlsf_mem *)m;
+    if (size > tlsf->parent.total)
+    {
+        LOG_D("no memory");
+
+        return RT_NULL;
+    }
+    size = _tlsf_adjust_size(size);
+
+    block = _tlsf_locate_free(tlsf, size);
+    if (block == RT_NULL)
+    {
+        LOG_D("no memory");
+
+        return RT_NULL;
+    }
+
+    _tlsf_block_trim(tlsf, block, size);
+    _tlsf_block_mark_used(tlsf, block);
+
+    RT_ASSERT((rt_ubase_t)BLOCK_DATA(block) % RT_ALIGN_SIZE == 0);
+
+    LOG_D("allocate memory at 0x%x, size: %d",
+            (rt_ubase_t)BLOCK_DATA(block), BLOCK_SIZE(block));
+
+    return BLOCK_DATA(block);
+}
+RTM_EXPORT(rt_tlsf_alloc);
+
+/**
+ * @brief This function will release the previously allocated memory block by
+ *        rt_tlsf_alloc. The released memory block is taken back to the heap.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @param rmem the address of memory which will be released.
+ */
+void rt_tlsf_free(rt_tlsf_t m, void *rmem)
+{
+    struct rt_tlsf_mem *tlsf;
+    struct rt_tlsf_block *block, *prev, *next;
+
+    if (rmem == RT_NULL)
+        return;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+    RT_ASSERT((((rt_ubase_t)rmem) & (RT_ALIGN_SIZE - 1)) == 0);
+
+    tlsf = (struct rt_tlsf_mem *)m;
+    block = BLOCK_FROM_DATA(rmem);
+    RT_ASSERT((rt_uint8_t *)block >= tlsf->heap_ptr && block < tlsf->heap_end);
+    RT_ASSERT(!BLOCK_ISFREE(block));
+    RT_ASSERT(BLOCK_NEXT(block)->prev_phys == block);
+
+    LOG_D("release memory 0x%x, size: %d", (rt_ubase_t)rmem, BLOCK_SIZE(block));
+
+    tlsf->parent.used -= BLOCK_SIZE(block) + SIZEOF_STRUCT_BLOCK;
+    block->size |= BLOCK_FREE;
+#ifdef RT_USING_MEMTRACE
+    rt_tlsf_setname(block, "    ");
+#endif /* RT_USING_MEMTRACE */
+
+    /* merge with the previous block */
+    if (BLOCK_ISPREVFREE(block))
+    {
+        prev = block->prev_phys;
+        RT_ASSERT(prev != RT_NULL && BLOCK_ISFREE(prev));
+        _tlsf_block_remove(tlsf, prev);
+        prev->size += BLOCK_SIZE(block) + SIZEOF_STRUCT_BLOCK;
+        block = prev;
+    }
+
+    /* merge with the next block */
+    next = BLOCK_NEXT(block);
+    if (BLOCK_ISFREE(next))
+    {
+        _tlsf_block_remove(tlsf, next);
+        block->size += BLOCK_SIZE(next) + SIZEOF_STRUCT_BLOCK;
+        next = BLOCK_NEXT(block);
+    }
+
+    next->prev_phys = block;
+    next->size |= BLOCK_PREV_FREE;
+    _tlsf_block_insert(tlsf, block);
+}
+RTM_EXPORT(rt_tlsf_free);
+
+/**
+ * @brief This function will change the size of previously allocated memory block.
+ *
+ * @param m the TLSF memory management object.
+ *
+ * @param rmem is the pointer to memory allocated by rt_tlsf_alloc.
+ *
+ * @param newsize is the required new size.
+ *
+ * @return the changed memory block address.
+ */
+void *rt_tlsf_realloc(rt_tlsf_t m, void *rmem, rt_size_t newsize)
+{
+    struct rt_tlsf_mem *tlsf;
+    struct rt_tlsf_block *block, *next;
+    rt_size_t size;
+    void *nmem;
+
+    RT_ASSERT(m != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&m->parent) == RT_Object_Class_Memory);
+
+    tlsf = (struct rt_tlsf_mem *)m;
+    if (newsize > tlsf->parent.total)
+    {
+        LOG_D("realloc: out of memory");
+
+        return RT_NULL;
+    }
+    else if (newsize == 0)
+    {
+        rt_tlsf_free(m, rmem);
+        return RT_NULL;
+    }
+
+    /* allocate a new memory block */
+    if (rmem == RT_NULL)
+        return rt_tlsf_alloc(m, newsize);
+
+    block = BLOCK_FROM_DATA(rmem);
+    RT_ASSERT((rt_uint8_t *)block >= tlsf->heap_ptr && block < tlsf->heap_end);
+    RT_ASSERT(!BLOCK_ISFREE(block));
+
+    size = BLOCK_SIZE(block);
+    newsize = _tlsf_adjust_size(newsize);
+
+    next = BLOCK_NEXT(block);
+    if (newsize > size && BLOCK_ISFREE(next) &&
+        size + SIZEOF_STRUCT_BLOCK + BLOCK_SIZE(next) >= newsize)
+    {
+        /* grow in place by taking over the next block */
+        _tlsf_block_remove(tlsf, next);
+        tlsf->parent.used += BLOCK_SIZE(next) + SIZEOF_STRUCT_BLOCK;
+        block->size += BLOCK_SIZE(next) + SIZEOF_STRUCT_BLOCK;
+        next = BLOCK_NEXT(block);
+        next->prev_phys = block;
+        next->size &= ~BLOCK_PREV_FREE;
+        size = BLOCK_SIZE(block);
+    }
+
+    if (newsize <= size)
+    {
+        /* shrink in place, the tail goes back to the heap */
+        tlsf->parent.used -= BLOCK_SIZE(block);
+        _tlsf_block_trim(tlsf, block, newsize);
+        tlsf->parent.used += BLOCK_SIZE(block);
+        if (tlsf->parent.max < tlsf->parent.used)
+            tlsf->parent.max = tlsf->parent.used;
+
+        return rmem;
+    }
+
+    /* expand memory */
+    nmem = rt_tlsf_alloc(m, newsize);
+    if (nmem != RT_NULL) /* check memory */
+    {
+        rt_memcpy(nmem, rmem, size);
+        rt_tlsf_free(m, rmem);
+    }
+
+    return nmem;
+}
+RTM_EXPORT(rt_tlsf_realloc);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+#if defined(RT_USING_MEMTRACE) && !defined(RT_USING_SMALL_MEM)
+rt_inline rt_bool_t _tlsf_is_object(struct rt_object *object)
+{
+    return rt_strcmp(((rt_mem_t)object)->algorithm, "tlsf") == 0;
+}
+
+static int memcheck(int argc, char *argv[])
+{
+    rt_base_t level;
+    struct rt_tlsf_block *block, *next;
+    struct rt_tlsf_mem *m;
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    struct rt_object *object;
+    char *name;
+
+    name = argc > 1 ? argv[1] : RT_NULL;
+    level = rt_hw_interrupt_disable();
+    /* get mem object */
+    information = rt_object_get_information(RT_Object_Class_Memory);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        object = rt_list_entry(node, struct rt_object, list);
+        /* find the specified object */
+        if (name != RT_NULL && rt_strncmp(name, object->name, RT_NAME_MAX) != 0)
+            continue;
+        if (!_tlsf_is_object(object))
+            continue;
+        /* mem object */
+        m = (struct rt_tlsf_mem *)object;
+        /* check the physical chain of blocks */
+        for (block = (struct rt_tlsf_block *)m->heap_ptr; block != m->heap_end; block = next)
+        {
+            next = BLOCK_NEXT(block);
+            if (next <= block || next > m->heap_end) goto __exit;
+            if (next->prev_phys != block) goto __exit;
+            if (!BLOCK_ISFREE(block) != !BLOCK_ISPREVFREE(next)) goto __exit;
+            /* two free neighbours should have been merged */
+            if (BLOCK_ISFREE(block) && BLOCK_ISFREE(next)) goto __exit;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    return 0;
+__exit:
+    rt_kprintf("Memory block wrong:\n");
+    rt_kprintf("   name: %s\n", m->parent.parent.name);
+    rt_kprintf("address: 0x%08x\n", block);
+    rt_kprintf("   prev: 0x%08x\n", block->prev_phys);
+    rt_kprintf("   size: %d%s\n", BLOCK_SIZE(block), BLOCK_ISFREE(block) ? " (free)" : "");
+    rt_hw_interrupt_enable(level);
+
+    return 0;
+}
+MSH_CMD_EXPORT(memcheck, check memory data);
+
+static int memtrace(int argc, char **argv)
+{
+    struct rt_tlsf_block *block;
+    struct rt_tlsf_mem *m;
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    struct rt_object *object;
+    char *name;
+    int fl, sl;
+    rt_size_t free_nr;
+
+    name = argc > 1 ? argv[1] : RT_NULL;
+    /* get mem object */
+    information = rt_object_get_information(RT_Object_Class_Memory);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        object = rt_list_entry(node, struct rt_object, list);
+        /* find the specified object */
+        if (name != RT_NULL && rt_strncmp(name, object->name, RT_NAME_MAX) != 0)
+            continue;
+        if (!_tlsf_is_object(object))
+            continue;
+        /* mem object */
+        m = (struct rt_tlsf_mem *)object;
+        /* show memory information */
+        rt_kprintf("\nmemory heap address:\n");
+        rt_kprintf("name    : %s\n", m->parent.parent.name);
+        rt_kprintf("total   : %d\n", m->parent.total);
+        rt_kprintf("used    : %d\n", m->parent.used);
+        rt_kprintf("max_used: %d\n", m->parent.max);
+        rt_kprintf("heap_ptr: 0x%08x\n", m->heap_ptr);
+        rt_kprintf("heap_end: 0x%08x\n", m->heap_end);
+        rt_kprintf("\n--free list information --\n");
+        for (fl = 0; fl < RT_TLSF_FL_INDEX_COUNT; fl++)
+        {
+            if (!(m->fl_bitmap & (1U << fl)))
+                continue;
+            for (sl = 0; sl < RT_TLSF_SL_INDEX_COUNT; sl++)
+            {
+                free_nr = 0;
+                for (block = m->blocks[fl][sl]; block != RT_NULL; block = block->next_free)
+                    free_nr++;
+                if (free_nr)
+                    rt_kprintf("[%2d][%2d] %d\n", fl, sl, free_nr);
+            }
+        }
+        rt_kprintf("\n--memory item information --\n");
+        for (block = (struct rt_tlsf_block *)m->heap_ptr; block != m->heap_end; block = BLOCK_NEXT(block))
+        {
+            int size = BLOCK_SIZE(block);
+
+            rt_kprintf("[0x%08x - ", block);
+            if (size < 1024)
+                rt_kprintf("%5d", size);
+            else if (size < 1024 * 1024)
+                rt_kprintf("%4dK", size / 1024);
+            else
+                rt_kprintf("%4dM", size / (1024 * 1024));
+
+            rt_kprintf("] %c%c%c%c", block->thread[0], block->thread[1], block->thread[2], block->thread[3]);
+            if (BLOCK_NEXT(block)->prev_phys != block)
+                rt_kprintf(": ***\n");
+            else
+                rt_kprintf("\n");
+        }
+    }
+    return 0;
+}
+MSH_CMD_EXPORT(memtrace, dump memory trace information);
+#endif /* defined(RT_USING_MEMTRACE) && !defined(RT_USING_SMALL_MEM) */
+#endif /* RT_USING_FINSH */
+
+/**@}*/
+
+#endif /* defined (RT_USING_TLSF_MEM) */